@@ -0,0 +1,100 @@
+#include "adc_correction.h"
+
+uint32_t decimate(uint32_t sum, uint32_t count, int extraBits)
+{
+    if (count == 0)
+        return 0;
+
+    uint64_t scaled = (uint64_t)sum << extraBits;
+    return (uint32_t)((scaled + count / 2) / count);
+}
+
+uint32_t linearModelTransfer(uint32_t raw, void *context)
+{
+    const AdcLinearModel *model = (const AdcLinearModel *)context;
+    return (model->coeffA * raw + 32768) / 65536 + model->coeffB;
+}
+
+AdcLinearizer::AdcLinearizer()
+    : codeScale(0), repairs(0), ready(false)
+{
+}
+
+bool AdcLinearizer::build(AdcTransferFn transfer, void *context)
+{
+    ready = false;
+    repairs = 0;
+
+    // The transfer function only returns whole millivolts (about 1.5 codes
+    // per mV at 11 dB), so each entry averages a centered window of codes:
+    // unbiased where the curve is locally straight, and sub-mV in between
+    const int halfWindow = 2;
+    for (int code = 0; code < ADC_CODES; code++)
+    {
+        int k = halfWindow;
+        if (code < k)
+            k = code;
+        if (ADC_MAX_VALUE - code < k)
+            k = ADC_MAX_VALUE - code;
+
+        uint32_t sum = 0;
+        for (int i = code - k; i <= code + k; i++)
+        {
+            sum += transfer((uint32_t)i, context);
+        }
+        uint32_t taps = 2 * k + 1;
+        uint32_t q4 = (sum * 16 + taps / 2) / taps;
+        if (q4 > 0xFFFF)
+            q4 = 0xFFFF;
+
+        // Keep the curve monotonic so corrected readings never reverse
+        if (code > 0 && q4 < millivoltsQ4[code - 1])
+        {
+            q4 = millivoltsQ4[code - 1];
+            repairs++;
+        }
+        millivoltsQ4[code] = (uint16_t)q4;
+    }
+
+    uint32_t span = millivoltsQ4[ADC_MAX_VALUE] - millivoltsQ4[0];
+    if (span == 0)
+        return false;
+
+    codeScale = (uint32_t)((((uint64_t)ADC_MAX_VALUE << 16) + span / 2) / span);
+    ready = true;
+    return true;
+}
+
+bool AdcLinearizer::isReady() const
+{
+    return ready;
+}
+
+uint16_t AdcLinearizer::getRepairs() const
+{
+    return repairs;
+}
+
+uint32_t AdcLinearizer::lookupQ4(uint32_t value, int fracBits) const
+{
+    uint32_t index = value >> fracBits;
+    if (index >= (uint32_t)ADC_MAX_VALUE)
+        return millivoltsQ4[ADC_MAX_VALUE];
+
+    uint32_t frac = value & ((1u << fracBits) - 1);
+    uint32_t low = millivoltsQ4[index];
+    uint32_t high = millivoltsQ4[index + 1];
+    return low + (((high - low) * frac + ((1u << fracBits) >> 1)) >> fracBits);
+}
+
+uint16_t AdcLinearizer::toMillivolts(uint32_t value, int fracBits) const
+{
+    return (uint16_t)((lookupQ4(value, fracBits) + 8) >> 4);
+}
+
+int AdcLinearizer::toCode(uint32_t value, int fracBits) const
+{
+    uint32_t offset = lookupQ4(value, fracBits) - millivoltsQ4[0];
+    int code = (int)((offset * codeScale + 0x8000) >> 16);
+    return code > ADC_MAX_VALUE ? ADC_MAX_VALUE : code;
+}
@@ -0,0 +1,56 @@
+#ifndef ADC_CORRECTION_H
+#define ADC_CORRECTION_H
+
+#include "config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Oversampling and linearity correction for raw ADC codes. Pure integer
+// math with no hardware access, so captures can be replayed on the host.
+
+const int ADC_CODES = ADC_MAX_VALUE + 1;
+
+// Mean of count samples whose sum is given, keeping extraBits fractional
+// bits (rounded). With count = 4^extraBits this is the classic
+// oversample-and-decimate result of (12 + extraBits) bits.
+uint32_t decimate(uint32_t sum, uint32_t count, int extraBits);
+
+// Converter transfer function: raw code -> millivolts
+typedef uint32_t (*AdcTransferFn)(uint32_t raw, void *context);
+
+// esp_adc_cal's linear model, mV = (coeffA * raw + 2^15) / 2^16 + coeffB.
+// Used on the host and as a stand-in when no eFuse data exists.
+struct AdcLinearModel
+{
+    uint32_t coeffA;
+    uint32_t coeffB;
+};
+
+uint32_t linearModelTransfer(uint32_t raw, void *context); // context: AdcLinearModel *
+
+// Per-code lookup from raw ADC code to millivolts (Q4), forced monotonic,
+// with linear interpolation between codes for decimated (fractional) input.
+// toCode() maps the corrected voltage back onto a linear 0..ADC_MAX_VALUE
+// scale so calibration and mapping keep working in 12-bit units.
+class AdcLinearizer
+{
+private:
+    uint16_t millivoltsQ4[ADC_CODES]; // 3300 mV * 16 fits in 16 bits
+    uint32_t codeScale;               // Q16: ADC_MAX_VALUE / span (in mV Q4)
+    uint16_t repairs;                 // Codes raised to keep the table monotonic
+    bool ready;
+
+    uint32_t lookupQ4(uint32_t value, int fracBits) const;
+
+public:
+    AdcLinearizer();
+
+    bool build(AdcTransferFn transfer, void *context);
+    bool isReady() const;
+    uint16_t getRepairs() const;
+
+    uint16_t toMillivolts(uint32_t value, int fracBits = 0) const;
+    int toCode(uint32_t value, int fracBits = 0) const;
+};
+
+#endif
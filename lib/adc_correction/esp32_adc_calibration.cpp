@@ -0,0 +1,56 @@
+#ifdef ESP32
+
+#include "esp32_adc_calibration.h"
+#include <esp_adc_cal.h>
+#include <stdlib.h>
+
+Esp32AdcCalibration::Esp32AdcCalibration()
+    : characteristics(nullptr), source("none")
+{
+}
+
+Esp32AdcCalibration::~Esp32AdcCalibration()
+{
+    free(characteristics);
+}
+
+bool Esp32AdcCalibration::begin(int attenuation, uint32_t defaultVrefMv)
+{
+    if (characteristics == nullptr)
+    {
+        characteristics = calloc(1, sizeof(esp_adc_cal_characteristics_t));
+        if (characteristics == nullptr)
+            return false;
+    }
+
+    esp_adc_cal_value_t type = esp_adc_cal_characterize(
+        ADC_UNIT_1, (adc_atten_t)attenuation, ADC_WIDTH_BIT_12, defaultVrefMv,
+        (esp_adc_cal_characteristics_t *)characteristics);
+
+    switch (type)
+    {
+    case ESP_ADC_CAL_VAL_EFUSE_TP:
+        source = "eFuse two-point";
+        break;
+    case ESP_ADC_CAL_VAL_EFUSE_VREF:
+        source = "eFuse Vref";
+        break;
+    default:
+        source = "default Vref";
+        break;
+    }
+    return true;
+}
+
+const char *Esp32AdcCalibration::getSource() const
+{
+    return source;
+}
+
+uint32_t Esp32AdcCalibration::transfer(uint32_t raw, void *context)
+{
+    const Esp32AdcCalibration *self = (const Esp32AdcCalibration *)context;
+    return esp_adc_cal_raw_to_voltage(raw, (const esp_adc_cal_characteristics_t *)self->characteristics);
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef ESP32_ADC_CALIBRATION_H
+#define ESP32_ADC_CALIBRATION_H
+
+#include <stdint.h>
+
+// ADC1 characterization from the eFuse calibration values (esp_adc_cal).
+// Like esp32_adc_source.h this must not include config.h: its
+// ADC_ATTEN_DB_* enum clashes with the ESP-IDF ADC headers.
+class Esp32AdcCalibration
+{
+private:
+    void *characteristics; // esp_adc_cal_characteristics_t, kept out of the header
+    const char *source;
+
+public:
+    Esp32AdcCalibration();
+    ~Esp32AdcCalibration();
+
+    bool begin(int attenuation, uint32_t defaultVrefMv);
+    const char *getSource() const; // "eFuse two-point", "eFuse Vref" or "default Vref"
+
+    // AdcTransferFn-compatible: context is an Esp32AdcCalibration *
+    static uint32_t transfer(uint32_t raw, void *context);
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "adc_sampler.h"
+
+// Frames pulled from the source per readFrames() call
+static const size_t POLL_CHUNK_FRAMES = 32;
+
+AdcSampler::AdcSampler()
+{
+    source = nullptr;
+    head = 0;
+    count = 0;
+    unread = 0;
+    totalFrames = 0;
+    overrunFrames = 0;
+    running = false;
+}
+
+bool AdcSampler::begin(AdcSource *newSource)
+{
+    end();
+
+    if (newSource == nullptr || newSource->channelCount() < JOYSTICK_AXES || !newSource->begin())
+        return false;
+
+    source = newSource;
+    head = 0;
+    count = 0;
+    unread = 0;
+    totalFrames = 0;
+    overrunFrames = 0;
+    running = true;
+    return true;
+}
+
+void AdcSampler::end()
+{
+    if (running && source != nullptr)
+    {
+        source->end();
+    }
+    running = false;
+}
+
+size_t AdcSampler::poll()
+{
+    if (!running)
+        return 0;
+
+    AdcFrame chunk[POLL_CHUNK_FRAMES];
+    size_t received = 0;
+
+    // Bounded drain: at most one ring's worth, so a flooded source
+    // cannot hold the caller
+    while (received < (size_t)ADC_RING_FRAMES)
+    {
+        size_t frames = source->readFrames(chunk, POLL_CHUNK_FRAMES);
+        for (size_t i = 0; i < frames; i++)
+        {
+            push(chunk[i]);
+        }
+        received += frames;
+
+        if (frames < POLL_CHUNK_FRAMES)
+            break;
+    }
+
+    totalFrames += received;
+    return received;
+}
+
+void AdcSampler::push(const AdcFrame &frame)
+{
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        ring[axis][head] = frame.value[axis];
+    }
+    head = (head + 1) % ADC_RING_FRAMES;
+    if (count < (size_t)ADC_RING_FRAMES)
+    {
+        count++;
+    }
+    if (unread < (size_t)ADC_RING_FRAMES)
+    {
+        unread++;
+    }
+    else
+    {
+        overrunFrames++;
+    }
+}
+
+bool AdcSampler::latest(AdcFrame &frame) const
+{
+    if (count == 0)
+        return false;
+
+    size_t index = (head + ADC_RING_FRAMES - 1) % ADC_RING_FRAMES;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        frame.value[axis] = ring[axis][index];
+    }
+    return true;
+}
+
+size_t AdcSampler::recent(AdcFrame *out, size_t maxFrames) const
+{
+    size_t n = (maxFrames < count) ? maxFrames : count;
+    size_t start = (head + ADC_RING_FRAMES - n) % ADC_RING_FRAMES;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t index = (start + i) % ADC_RING_FRAMES;
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            out[i].value[axis] = ring[axis][index];
+        }
+    }
+
+    return n;
+}
+
+size_t AdcSampler::sumNew(size_t maxFrames, uint32_t *sums)
+{
+    size_t n = (maxFrames < unread) ? maxFrames : unread;
+    unread = 0;
+    if (n == 0)
+        return 0;
+
+    size_t start = (head + ADC_RING_FRAMES - n) % ADC_RING_FRAMES;
+
+    // The window is at most two contiguous runs of each axis row
+    size_t firstRun = (start + n <= (size_t)ADC_RING_FRAMES) ? n : ADC_RING_FRAMES - start;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        const uint16_t *row = ring[axis];
+        uint32_t sum = 0;
+        for (size_t i = 0; i < firstRun; i++)
+        {
+            sum += row[start + i];
+        }
+        for (size_t i = 0; i < n - firstRun; i++)
+        {
+            sum += row[i];
+        }
+        sums[axis] = sum;
+    }
+
+    return n;
+}
+
+bool AdcSampler::isRunning() const
+{
+    return running;
+}
+
+unsigned long AdcSampler::framesReceived() const
+{
+    return totalFrames;
+}
+
+unsigned long AdcSampler::framesOverrun() const
+{
+    return overrunFrames;
+}
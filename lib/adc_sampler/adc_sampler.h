@@ -0,0 +1,48 @@
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include "config.h"
+#include "adc_source.h"
+
+static_assert(JOYSTICK_AXES <= ADC_MAX_CHANNELS, "More axes than an ADC frame carries");
+
+// Drains an AdcSource into a fixed ring of recent frames.
+// poll() never blocks, so the control loop only pays for copying frames
+// the DMA has already completed. The ring is stored one row per axis, so
+// summing an axis walks contiguous memory. A consumer cursor tracks which
+// frames are new: sumNew() hands each frame out at most once, and frames
+// overwritten before anyone took them count as overruns.
+class AdcSampler
+{
+private:
+    AdcSource *source;
+    uint16_t ring[JOYSTICK_AXES][ADC_RING_FRAMES];
+    size_t head;  // Next slot to write
+    size_t count;  // Valid frames in ring
+    size_t unread; // Newest frames not yet taken by sumNew()
+    unsigned long totalFrames;
+    unsigned long overrunFrames;
+    bool running;
+
+    void push(const AdcFrame &frame);
+
+public:
+    AdcSampler();
+
+    bool begin(AdcSource *source);
+    void end();
+
+    size_t poll(); // Returns frames received since the last poll
+    bool latest(AdcFrame &frame) const;
+    size_t recent(AdcFrame *out, size_t maxFrames) const; // Oldest first
+    // Sums (one per axis) up to maxFrames of the newest frames that arrived
+    // since the last call, then marks every arrived frame taken. Returns
+    // the frames summed; 0 means nothing new (a stale tick).
+    size_t sumNew(size_t maxFrames, uint32_t *sums);
+
+    bool isRunning() const;
+    unsigned long framesReceived() const;
+    unsigned long framesOverrun() const; // Overwritten before sumNew() took them
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef ADC_SOURCE_H
+#define ADC_SOURCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Most channels one frame can carry (ADC1 has eight inputs)
+const int ADC_MAX_CHANNELS = 8;
+
+// One sample per channel, taken back-to-back by the ADC scan. Only the
+// first channelCount() entries of a source's frames are meaningful.
+struct AdcFrame
+{
+    uint16_t value[ADC_MAX_CHANNELS];
+};
+
+// Producer of interleaved per-channel samples (hardware DMA, recorded
+// file, synthetic)
+class AdcSource
+{
+public:
+    virtual ~AdcSource() {}
+
+    virtual bool begin() = 0;
+    virtual void end() {}
+    virtual int channelCount() const = 0;
+
+    // Copy up to maxFrames completed frames into out without blocking.
+    // Returns the number of frames written (0 when nothing is pending).
+    virtual size_t readFrames(AdcFrame *out, size_t maxFrames) = 0;
+};
+
+#endif
@@ -0,0 +1,154 @@
+#ifdef ESP32
+
+#include "esp32_adc_source.h"
+#include <Arduino.h>
+#include <driver/adc.h>
+
+// DMA pool size, and the most bytes one interrupt (and one read) may carry
+static const uint32_t DMA_BUFFER_BYTES = 1024;
+static const uint32_t DMA_MAX_READ_BYTES = 256;
+
+// conv_num_each_intr must be a whole number of DMA conversion words
+static const uint32_t DMA_READ_ALIGN_BYTES = 4;
+
+Esp32ContinuousAdcSource::Esp32ContinuousAdcSource(const int *pins, int count, uint32_t sampleRateHz,
+                                                   int attenuation, uint32_t framesPerInterrupt)
+    : count(count < ADC_MAX_CHANNELS ? count : ADC_MAX_CHANNELS),
+      sampleRateHz(sampleRateHz), attenuation(attenuation), running(false), pending(), pendingCount(0)
+{
+    for (int i = 0; i < this->count; i++)
+    {
+        this->pins[i] = pins[i];
+        channels[i] = -1;
+    }
+
+    // axes x frames x result size, rounded up to the DMA word and capped
+    // by the read buffer
+    uint32_t bytes = (framesPerInterrupt > 0 ? framesPerInterrupt : 1) * this->count * SOC_ADC_DIGI_RESULT_BYTES;
+    bytes = (bytes + DMA_READ_ALIGN_BYTES - 1) / DMA_READ_ALIGN_BYTES * DMA_READ_ALIGN_BYTES;
+    readBytes = bytes < DMA_MAX_READ_BYTES ? bytes : DMA_MAX_READ_BYTES;
+}
+
+bool Esp32ContinuousAdcSource::begin()
+{
+    if (running)
+        return true;
+
+    // Continuous mode only scans ADC1 (GPIO32-39), channels 0-7
+    uint32_t channelMask = 0;
+    for (int i = 0; i < count; i++)
+    {
+        channels[i] = digitalPinToAnalogChannel(pins[i]);
+        if (channels[i] < 0 || channels[i] > 7)
+        {
+            Serial.println("ERROR: Continuous ADC needs ADC1 pins!");
+            return false;
+        }
+        channelMask |= BIT(channels[i]);
+    }
+
+    adc_digi_init_config_t initConfig = {};
+    initConfig.max_store_buf_size = DMA_BUFFER_BYTES;
+    initConfig.conv_num_each_intr = readBytes;
+    initConfig.adc1_chan_mask = channelMask;
+    initConfig.adc2_chan_mask = 0;
+
+    if (adc_digi_initialize(&initConfig) != ESP_OK)
+    {
+        Serial.println("ERROR: ADC DMA init failed!");
+        return false;
+    }
+
+    // Scan pattern: the pins in order, so the last channel closes a frame
+    adc_digi_pattern_config_t pattern[ADC_MAX_CHANNELS] = {};
+    for (int i = 0; i < count; i++)
+    {
+        pattern[i].atten = (uint8_t)attenuation;
+        pattern[i].channel = (uint8_t)channels[i];
+        pattern[i].unit = 0;
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    adc_digi_configuration_t digiConfig = {};
+    digiConfig.conv_limit_en = 1;
+    digiConfig.conv_limit_num = 250;
+    digiConfig.pattern_num = count;
+    digiConfig.adc_pattern = pattern;
+    digiConfig.sample_freq_hz = sampleRateHz;
+    digiConfig.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    digiConfig.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+
+    if (adc_digi_controller_configure(&digiConfig) != ESP_OK ||
+        adc_digi_start() != ESP_OK)
+    {
+        Serial.println("ERROR: ADC DMA configuration failed!");
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    pendingCount = 0;
+    running = true;
+    return true;
+}
+
+void Esp32ContinuousAdcSource::end()
+{
+    if (!running)
+        return;
+
+    adc_digi_stop();
+    adc_digi_deinitialize();
+    running = false;
+}
+
+size_t Esp32ContinuousAdcSource::readFrames(AdcFrame *out, size_t maxFrames)
+{
+    if (!running || maxFrames == 0)
+        return 0;
+
+    // One interrupt's worth per call; the sampler calls again while frames
+    // keep coming
+    uint8_t buffer[DMA_MAX_READ_BYTES];
+    uint32_t wanted = maxFrames * count * SOC_ADC_DIGI_RESULT_BYTES;
+    if (wanted > readBytes)
+        wanted = readBytes;
+
+    // Timeout 0: return immediately with whatever the DMA has completed
+    uint32_t received = 0;
+    if (adc_digi_read_bytes(buffer, wanted, &received, 0) != ESP_OK)
+        return 0;
+
+    size_t frames = 0;
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= received; i += SOC_ADC_DIGI_RESULT_BYTES)
+    {
+        const adc_digi_output_data_t *result = (const adc_digi_output_data_t *)&buffer[i];
+        int channel = result->type1.channel;
+        uint16_t value = result->type1.data;
+
+        // A result out of scan order drops the partial frame; the first
+        // channel always starts a new one
+        if (channel == channels[0])
+        {
+            pendingCount = 0;
+        }
+        else if (channel != channels[pendingCount])
+        {
+            pendingCount = 0;
+            continue;
+        }
+
+        pending.value[pendingCount++] = value;
+        if (pendingCount == count)
+        {
+            if (frames < maxFrames)
+            {
+                out[frames++] = pending;
+            }
+            pendingCount = 0;
+        }
+    }
+
+    return frames;
+}
+
+#endif
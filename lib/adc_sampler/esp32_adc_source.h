@@ -0,0 +1,36 @@
+#ifndef ESP32_ADC_SOURCE_H
+#define ESP32_ADC_SOURCE_H
+
+#include "adc_source.h"
+
+// ADC1 continuous (DMA) scan over up to ADC_MAX_CHANNELS pins, in order.
+// The DMA raises one interrupt per framesPerInterrupt completed frames;
+// size it to one consumer tick so each tick finds new frames waiting.
+// Deliberately does not include config.h: its ADC_ATTEN_DB_* enum clashes
+// with the ESP-IDF ADC driver headers used by the implementation.
+class Esp32ContinuousAdcSource : public AdcSource
+{
+private:
+    int pins[ADC_MAX_CHANNELS];
+    int channels[ADC_MAX_CHANNELS]; // ADC1 channel per pin
+    int count;
+    uint32_t sampleRateHz;
+    int attenuation;
+    uint32_t readBytes; // Per interrupt and per adc_digi_read_bytes() call
+    bool running;
+
+    // Frame being assembled (may straddle two DMA reads)
+    AdcFrame pending;
+    int pendingCount;
+
+public:
+    Esp32ContinuousAdcSource(const int *pins, int count, uint32_t sampleRateHz, int attenuation,
+                             uint32_t framesPerInterrupt);
+
+    bool begin() override;
+    void end() override;
+    int channelCount() const override { return count; }
+    size_t readFrames(AdcFrame *out, size_t maxFrames) override;
+};
+
+#endif
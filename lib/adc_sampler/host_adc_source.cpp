@@ -0,0 +1,96 @@
+#include "host_adc_source.h"
+#include <stdlib.h>
+
+StreamAdcSource::StreamAdcSource(FILE *stream, bool loop, size_t framesPerRead, int channels)
+    : stream(stream), loop(loop), framesPerRead(framesPerRead),
+      channels(channels < ADC_MAX_CHANNELS ? channels : ADC_MAX_CHANNELS)
+{
+}
+
+bool StreamAdcSource::begin()
+{
+    return stream != nullptr;
+}
+
+size_t StreamAdcSource::readFrames(AdcFrame *out, size_t maxFrames)
+{
+    if (stream == nullptr)
+        return 0;
+
+    if (maxFrames > framesPerRead)
+        maxFrames = framesPerRead;
+
+    size_t frames = 0;
+    bool rewound = false;
+    while (frames < maxFrames)
+    {
+        if (readLine(out[frames]))
+        {
+            frames++;
+            continue;
+        }
+
+        // End of capture (or malformed line): wrap once per call when looping
+        if (!loop || rewound)
+            break;
+        rewind(stream);
+        rewound = true;
+    }
+
+    return frames;
+}
+
+bool StreamAdcSource::readLine(AdcFrame &frame)
+{
+    char line[128];
+    if (fgets(line, sizeof(line), stream) == nullptr)
+        return false;
+
+    const char *cursor = line;
+    for (int channel = 0; channel < channels; channel++)
+    {
+        while (*cursor == ' ' || *cursor == ',' || *cursor == '\t')
+        {
+            cursor++;
+        }
+
+        char *end;
+        unsigned long value = strtoul(cursor, &end, 10);
+        if (end == cursor)
+            return false;
+        frame.value[channel] = (uint16_t)value;
+        cursor = end;
+    }
+    return true;
+}
+
+SyntheticAdcSource::SyntheticAdcSource(AdcFrameGenerator generator, void *context, size_t framesPerRead,
+                                       int channels)
+    : generator(generator), context(context), framesPerRead(framesPerRead),
+      channels(channels < ADC_MAX_CHANNELS ? channels : ADC_MAX_CHANNELS), index(0)
+{
+}
+
+bool SyntheticAdcSource::begin()
+{
+    index = 0;
+    return generator != nullptr;
+}
+
+size_t SyntheticAdcSource::readFrames(AdcFrame *out, size_t maxFrames)
+{
+    if (maxFrames > framesPerRead)
+        maxFrames = framesPerRead;
+
+    for (size_t i = 0; i < maxFrames; i++)
+    {
+        out[i] = generator(index++, context);
+    }
+
+    return maxFrames;
+}
+
+uint32_t SyntheticAdcSource::framesGenerated() const
+{
+    return index;
+}
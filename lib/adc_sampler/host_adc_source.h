@@ -0,0 +1,49 @@
+#ifndef HOST_ADC_SOURCE_H
+#define HOST_ADC_SOURCE_H
+
+#include "adc_source.h"
+#include <stdio.h>
+
+// Replays a recorded capture: one frame per line, channels separated by
+// commas or spaces ("x,y" for a single stick)
+class StreamAdcSource : public AdcSource
+{
+private:
+    FILE *stream;
+    bool loop;
+    size_t framesPerRead;
+    int channels;
+
+    bool readLine(AdcFrame &frame);
+
+public:
+    StreamAdcSource(FILE *stream, bool loop = false, size_t framesPerRead = 1, int channels = 2);
+
+    bool begin() override;
+    int channelCount() const override { return channels; }
+    size_t readFrames(AdcFrame *out, size_t maxFrames) override;
+};
+
+// Generates frames on demand, e.g. sine sweeps or noise around center
+typedef AdcFrame (*AdcFrameGenerator)(uint32_t index, void *context);
+
+class SyntheticAdcSource : public AdcSource
+{
+private:
+    AdcFrameGenerator generator;
+    void *context;
+    size_t framesPerRead;
+    int channels;
+    uint32_t index;
+
+public:
+    SyntheticAdcSource(AdcFrameGenerator generator, void *context = nullptr, size_t framesPerRead = 1,
+                       int channels = 2);
+
+    bool begin() override;
+    int channelCount() const override { return channels; }
+    size_t readFrames(AdcFrame *out, size_t maxFrames) override;
+    uint32_t framesGenerated() const;
+};
+
+#endif
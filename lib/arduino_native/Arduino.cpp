@@ -0,0 +1,159 @@
+#include "Arduino.h"
+#include <chrono>
+#include <thread>
+
+HardwareSerial Serial;
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+static NativeAnalogReader analogReader = nullptr;
+static NativeSerialReader serialReader = nullptr;
+static const int LEDC_CHANNELS = 16;
+static uint32_t ledcDuty[LEDC_CHANNELS];
+
+unsigned long millis()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - startTime)
+        .count();
+}
+
+unsigned long micros()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - startTime)
+        .count();
+}
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void nativeSetAnalogReader(NativeAnalogReader reader)
+{
+    analogReader = reader;
+}
+
+int analogRead(uint8_t pin)
+{
+    return analogReader != nullptr ? analogReader(pin) : 2048;
+}
+
+double ledcSetup(uint8_t channel, double frequency, uint8_t)
+{
+    return channel < LEDC_CHANNELS ? frequency : 0;
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty)
+{
+    if (channel < LEDC_CHANNELS)
+        ledcDuty[channel] = duty;
+}
+
+uint32_t nativeLedcDuty(uint8_t channel)
+{
+    return channel < LEDC_CHANNELS ? ledcDuty[channel] : 0;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+    if (from > text.size())
+        return String("");
+    if (to > text.size())
+        to = (unsigned int)text.size();
+    return String(text.substr(from, to > from ? to - from : 0));
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t written = 0;
+    while (size-- > 0)
+    {
+        written += write(*buffer++);
+    }
+    return written;
+}
+
+size_t Print::print(long value, int base)
+{
+    char text[24];
+    snprintf(text, sizeof(text), base == HEX ? "%lX" : "%ld", value);
+    return write(text);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    char text[24];
+    snprintf(text, sizeof(text), base == HEX ? "%lX" : "%lu", value);
+    return write(text);
+}
+
+size_t Print::print(double value, int digits)
+{
+    char text[40];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return write(text);
+}
+
+void nativeSetSerialReader(NativeSerialReader reader)
+{
+    serialReader = reader;
+}
+
+int HardwareSerial::available()
+{
+    if (peeked < 0 && serialReader != nullptr)
+    {
+        peeked = serialReader();
+    }
+    return peeked >= 0 ? 1 : 0;
+}
+
+int HardwareSerial::read()
+{
+    if (!available())
+        return -1;
+
+    int value = peeked;
+    peeked = -1;
+    return value;
+}
+
+size_t HardwareSerial::write(uint8_t value)
+{
+    return fputc(value, stdout) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    return fwrite(buffer, 1, size, stdout);
+}
+
+#ifndef PIO_UNIT_TESTING
+// Arduino entry points, run the way the ESP32 core runs them. Test and
+// benchmark builds bring their own main().
+void setup();
+void loop();
+
+int main()
+{
+    // Line-buffered like a serial monitor, even when piped
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+
+    setup();
+    for (;;)
+    {
+        loop();
+    }
+}
+#endif
@@ -0,0 +1,131 @@
+#ifndef ARDUINO_NATIVE_H
+#define ARDUINO_NATIVE_H
+
+// Minimal Arduino API for [env:native] builds: just what this project
+// uses, backed by the host clock and stdout. Never built for the ESP32
+// (library.json restricts it to the native platform).
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define HEX 16
+#define DEC 10
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+
+typedef int adc_attenuation_t;
+
+// Time (monotonic, starts at zero when the program starts)
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// Analog input comes from a replaceable reader; the default reads mid-scale
+typedef int (*NativeAnalogReader)(uint8_t pin);
+void nativeSetAnalogReader(NativeAnalogReader reader);
+
+int analogRead(uint8_t pin);
+inline void analogReadResolution(int) {}
+inline void analogSetAttenuation(adc_attenuation_t) {}
+inline void analogSetPinAttenuation(uint8_t, adc_attenuation_t) {}
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+
+// LEDC PWM: the last duty written to each channel is kept for inspection
+double ledcSetup(uint8_t channel, double frequency, uint8_t resolutionBits);
+inline void ledcAttachPin(uint8_t, uint8_t) {}
+void ledcWrite(uint8_t channel, uint32_t duty);
+uint32_t nativeLedcDuty(uint8_t channel);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+class String
+{
+private:
+    std::string text;
+
+public:
+    String(const char *value = "") : text(value) {}
+    String(const std::string &value) : text(value) {}
+    explicit String(int value) : text(std::to_string(value)) {}
+    explicit String(long value) : text(std::to_string(value)) {}
+    explicit String(unsigned long value) : text(std::to_string(value)) {}
+
+    unsigned int length() const { return (unsigned int)text.size(); }
+    const char *c_str() const { return text.c_str(); }
+    String substring(unsigned int from, unsigned int to) const;
+    String substring(unsigned int from) const { return substring(from, length()); }
+
+    String &operator+=(const String &other)
+    {
+        text += other.text;
+        return *this;
+    }
+    friend String operator+(const String &a, const String &b) { return String(a.text + b.text); }
+    friend String operator+(const String &a, const char *b) { return String(a.text + b); }
+    friend String operator+(const char *a, const String &b) { return String(a + b.text); }
+    bool operator==(const String &other) const { return text == other.text; }
+    bool operator!=(const String &other) const { return text != other.text; }
+    char operator[](unsigned int index) const { return text[index]; }
+};
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *text) { return write((const uint8_t *)text, strlen(text)); }
+
+    size_t print(const char *text) { return write(text); }
+    size_t print(const String &text) { return write(text.c_str()); }
+    size_t print(char value) { return write((uint8_t)value); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(T value) { return print(value) + println(); }
+    template <typename T>
+    size_t println(T value, int format) { return print(value, format) + println(); }
+};
+
+// Serial writes to stdout; input is empty unless a reader is installed
+typedef int (*NativeSerialReader)();
+void nativeSetSerialReader(NativeSerialReader reader);
+
+class HardwareSerial : public Print
+{
+private:
+    int peeked; // -1 when empty
+
+public:
+    HardwareSerial() : peeked(-1) {}
+
+    void begin(unsigned long) {}
+    void flush() { fflush(stdout); }
+    int available();
+    int read();
+    int availableForWrite() { return 128; }
+
+    size_t write(uint8_t value) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,38 @@
+#include "Wire.h"
+
+TwoWire Wire;
+
+bool TwoWire::begin(int, int, uint32_t)
+{
+    return true;
+}
+
+void TwoWire::beginTransmission(uint8_t)
+{
+    pending = 0;
+}
+
+size_t TwoWire::write(uint8_t value)
+{
+    return write(&value, 1);
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t size)
+{
+    size_t room = WIRE_BUFFER_LENGTH - pending;
+    if (size > room)
+        size = room;
+    memcpy(buffer + pending, data, size);
+    pending += size;
+    return size;
+}
+
+uint8_t TwoWire::endTransmission(bool)
+{
+    memcpy(last, buffer, pending);
+    lastLength = pending;
+    transactions++;
+    bytes += pending;
+    pending = 0;
+    return 0; // Success
+}
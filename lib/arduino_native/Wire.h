@@ -0,0 +1,41 @@
+#ifndef WIRE_NATIVE_H
+#define WIRE_NATIVE_H
+
+#include "Arduino.h"
+
+// Transmit buffer size of the ESP32 Wire library; writes past it are refused
+const size_t WIRE_BUFFER_LENGTH = 128;
+
+// I2C stand-in: accepts every transaction and counts the traffic, so LCD
+// flush costs can be measured without a display attached. The last
+// transaction's bytes are kept for tests.
+class TwoWire
+{
+private:
+    uint8_t buffer[WIRE_BUFFER_LENGTH];
+    size_t pending;
+    uint8_t last[WIRE_BUFFER_LENGTH];
+    size_t lastLength;
+    unsigned long transactions;
+    unsigned long bytes;
+
+public:
+    TwoWire() : pending(0), lastLength(0), transactions(0), bytes(0) {}
+
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    void setClock(uint32_t) {}
+
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t value);
+    size_t write(const uint8_t *buffer, size_t size);
+    uint8_t endTransmission(bool sendStop = true);
+
+    unsigned long getTransactions() const { return transactions; }
+    unsigned long getBytes() const { return bytes; }
+    const uint8_t *getLastTransmission() const { return last; }
+    size_t getLastLength() const { return lastLength; }
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,254 @@
+#include "calibration_store.h"
+#include "crc.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ESP32
+#include <Preferences.h>
+#endif
+
+static void putU16(uint8_t *out, uint16_t value)
+{
+    out[0] = (uint8_t)(value & 0xFF);
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void putU32(uint8_t *out, uint32_t value)
+{
+    putU16(out, (uint16_t)(value & 0xFFFF));
+    putU16(out + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t getU16(const uint8_t *in)
+{
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t getU32(const uint8_t *in)
+{
+    return getU16(in) | ((uint32_t)getU16(in + 2) << 16);
+}
+
+static bool axisValid(int minVal, int centerVal, int maxVal)
+{
+    return minVal >= ADC_MIN_VALUE && maxVal <= ADC_MAX_VALUE &&
+           minVal < centerVal && centerVal < maxVal;
+}
+
+bool calibrationDataValid(const CalibrationData &data)
+{
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        if (!axisValid(data.min[axis], data.center[axis], data.max[axis]))
+            return false;
+    }
+    return true;
+}
+
+size_t encodeCalibrationRecord(const StoredCalibration &stored, uint8_t *out)
+{
+    const CalibrationData &data = stored.data;
+
+    putU16(out + 0, CALIBRATION_RECORD_MAGIC);
+    out[2] = CALIBRATION_RECORD_VERSION;
+    out[3] = (uint8_t)JOYSTICK_AXES;
+
+    uint8_t *field = out + CALIBRATION_RECORD_HEADER;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        putU16(field + 0, (uint16_t)data.min[axis]);
+        putU16(field + 2, (uint16_t)data.max[axis]);
+        putU16(field + 4, (uint16_t)data.center[axis]);
+        field += 6;
+    }
+    putU32(field, stored.calibrationMs);
+    putU32(field + 4, crc32(out, CALIBRATION_RECORD_SIZE - 4));
+
+    return CALIBRATION_RECORD_SIZE;
+}
+
+
+CalibrationRecordStatus decodeCalibrationRecord(const uint8_t *in, size_t length, StoredCalibration &stored)
+{
+    if (length == 0)
+        return RECORD_MISSING;
+    // The header is checked first so a record from older firmware or a
+    // build with another axis count is reported as such, not by its size
+    if (length < CALIBRATION_RECORD_HEADER)
+        return RECORD_BAD_SIZE;
+    if (getU16(in) != CALIBRATION_RECORD_MAGIC)
+        return RECORD_BAD_MAGIC;
+    if (in[2] != CALIBRATION_RECORD_VERSION)
+        return RECORD_BAD_VERSION;
+    if (in[3] != JOYSTICK_AXES)
+        return RECORD_BAD_AXES;
+    if (length != CALIBRATION_RECORD_SIZE)
+        return RECORD_BAD_SIZE;
+    if (getU32(in + CALIBRATION_RECORD_SIZE - 4) != crc32(in, CALIBRATION_RECORD_SIZE - 4))
+        return RECORD_BAD_CRC;
+
+    CalibrationData data;
+    const uint8_t *field = in + CALIBRATION_RECORD_HEADER;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        data.min[axis] = (int16_t)getU16(field + 0);
+        data.max[axis] = (int16_t)getU16(field + 2);
+        data.center[axis] = (int16_t)getU16(field + 4);
+        field += 6;
+
+        if (!axisValid(data.min[axis], data.center[axis], data.max[axis]))
+            return RECORD_BAD_VALUES;
+    }
+    data.isCalibrated = true;
+
+    stored.data = data;
+    stored.calibrationMs = getU32(field);
+    return RECORD_OK;
+}
+
+const char *calibrationRecordStatusName(CalibrationRecordStatus status)
+{
+    switch (status)
+    {
+    case RECORD_OK:
+        return "ok";
+    case RECORD_MISSING:
+        return "missing";
+    case RECORD_BAD_SIZE:
+        return "bad size";
+    case RECORD_BAD_MAGIC:
+        return "bad magic";
+    case RECORD_BAD_VERSION:
+        return "old version";
+    case RECORD_BAD_AXES:
+        return "axis count mismatch";
+    case RECORD_BAD_CRC:
+        return "bad CRC";
+    case RECORD_BAD_VALUES:
+    default:
+        return "bad values";
+    }
+}
+
+CalibrationRecordStatus loadCalibration(CalibrationStorage &storage, StoredCalibration &stored)
+{
+    uint8_t record[CALIBRATION_RECORD_SIZE + 1]; // +1 detects oversized records
+    size_t length = storage.read(record, sizeof(record));
+    return decodeCalibrationRecord(record, length, stored);
+}
+
+bool saveCalibration(CalibrationStorage &storage, const StoredCalibration &stored)
+{
+    // A record that can never load would fail every boot
+    if (!calibrationDataValid(stored.data))
+        return false;
+
+    uint8_t record[CALIBRATION_RECORD_SIZE];
+    size_t length = encodeCalibrationRecord(stored, record);
+    return storage.write(record, length);
+}
+
+MemoryCalibrationStorage::MemoryCalibrationStorage()
+{
+    recordLength = 0;
+}
+
+size_t MemoryCalibrationStorage::read(uint8_t *buffer, size_t maxLength)
+{
+    size_t length = (recordLength < maxLength) ? recordLength : maxLength;
+    memcpy(buffer, record, length);
+    return length;
+}
+
+bool MemoryCalibrationStorage::write(const uint8_t *buffer, size_t length)
+{
+    if (length > sizeof(record))
+        return false;
+
+    memcpy(record, buffer, length);
+    recordLength = length;
+    return true;
+}
+
+void MemoryCalibrationStorage::erase()
+{
+    recordLength = 0;
+}
+
+FileCalibrationStorage::FileCalibrationStorage(const char *path) : path(path)
+{
+}
+
+size_t FileCalibrationStorage::read(uint8_t *buffer, size_t maxLength)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr)
+        return 0;
+
+    size_t length = fread(buffer, 1, maxLength, file);
+    fclose(file);
+    return length;
+}
+
+bool FileCalibrationStorage::write(const uint8_t *buffer, size_t length)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr)
+        return false;
+
+    bool ok = fwrite(buffer, 1, length, file) == length;
+    return (fclose(file) == 0) && ok;
+}
+
+void FileCalibrationStorage::erase()
+{
+    remove(path);
+}
+
+#ifdef ESP32
+
+PreferencesCalibrationStorage::PreferencesCalibrationStorage(const char *nameSpace, const char *key)
+    : nameSpace(nameSpace), key(key)
+{
+}
+
+size_t PreferencesCalibrationStorage::read(uint8_t *buffer, size_t maxLength)
+{
+    Preferences prefs;
+    if (!prefs.begin(nameSpace, true))
+        return 0;
+
+    // getBytes() refuses short buffers; report an oversized record by its
+    // truncated length so the decoder flags it as RECORD_BAD_SIZE
+    size_t length = prefs.getBytesLength(key);
+    if (length > maxLength)
+        length = maxLength;
+    else if (length > 0)
+        length = prefs.getBytes(key, buffer, length);
+
+    prefs.end();
+    return length;
+}
+
+bool PreferencesCalibrationStorage::write(const uint8_t *buffer, size_t length)
+{
+    Preferences prefs;
+    if (!prefs.begin(nameSpace, false))
+        return false;
+
+    bool ok = prefs.putBytes(key, buffer, length) == length;
+    prefs.end();
+    return ok;
+}
+
+void PreferencesCalibrationStorage::erase()
+{
+    Preferences prefs;
+    if (prefs.begin(nameSpace, false))
+    {
+        prefs.remove(key);
+        prefs.end();
+    }
+}
+
+#endif
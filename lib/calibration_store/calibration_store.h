@@ -0,0 +1,101 @@
+#ifndef CALIBRATION_STORE_H
+#define CALIBRATION_STORE_H
+
+#include "calibration.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Persisted calibration record, little-endian, N = JOYSTICK_AXES:
+//   0  magic "JC"     2  version     3  axis count N
+//   4  min max center per axis (int16 each, 6 bytes per axis)
+//   4+6N  calibrationMs (uint32, duration of the full calibration)
+//   8+6N  CRC-32 of all preceding bytes
+const uint16_t CALIBRATION_RECORD_MAGIC = 0x434A;
+const uint8_t CALIBRATION_RECORD_VERSION = 3; // 2: linearity-corrected codes, 3: axis count
+const size_t CALIBRATION_RECORD_HEADER = 4;
+const size_t CALIBRATION_RECORD_SIZE = CALIBRATION_RECORD_HEADER + 6 * JOYSTICK_AXES + 8;
+
+enum CalibrationRecordStatus
+{
+    RECORD_OK = 0,
+    RECORD_MISSING,
+    RECORD_BAD_SIZE,
+    RECORD_BAD_MAGIC,
+    RECORD_BAD_VERSION,
+    RECORD_BAD_AXES,
+    RECORD_BAD_CRC,
+    RECORD_BAD_VALUES
+};
+
+struct StoredCalibration
+{
+    CalibrationData data;
+    uint32_t calibrationMs;
+};
+
+// Every axis inside the ADC range with min < center < max; anything else
+// would decode as RECORD_BAD_VALUES
+bool calibrationDataValid(const CalibrationData &data);
+
+size_t encodeCalibrationRecord(const StoredCalibration &stored, uint8_t *out);
+CalibrationRecordStatus decodeCalibrationRecord(const uint8_t *in, size_t length, StoredCalibration &stored);
+const char *calibrationRecordStatusName(CalibrationRecordStatus status);
+
+// Raw record persistence (NVS on the board, memory or file on the host)
+class CalibrationStorage
+{
+public:
+    virtual ~CalibrationStorage() {}
+    virtual size_t read(uint8_t *buffer, size_t maxLength) = 0; // 0 when absent
+    virtual bool write(const uint8_t *buffer, size_t length) = 0;
+    virtual void erase() = 0;
+};
+
+CalibrationRecordStatus loadCalibration(CalibrationStorage &storage, StoredCalibration &stored);
+bool saveCalibration(CalibrationStorage &storage, const StoredCalibration &stored); // false for invalid data
+
+class MemoryCalibrationStorage : public CalibrationStorage
+{
+private:
+    uint8_t record[CALIBRATION_RECORD_SIZE];
+    size_t recordLength;
+
+public:
+    MemoryCalibrationStorage();
+
+    size_t read(uint8_t *buffer, size_t maxLength) override;
+    bool write(const uint8_t *buffer, size_t length) override;
+    void erase() override;
+};
+
+class FileCalibrationStorage : public CalibrationStorage
+{
+private:
+    const char *path;
+
+public:
+    FileCalibrationStorage(const char *path);
+
+    size_t read(uint8_t *buffer, size_t maxLength) override;
+    bool write(const uint8_t *buffer, size_t length) override;
+    void erase() override;
+};
+
+#ifdef ESP32
+// ESP32 NVS through the Arduino Preferences library
+class PreferencesCalibrationStorage : public CalibrationStorage
+{
+private:
+    const char *nameSpace;
+    const char *key;
+
+public:
+    PreferencesCalibrationStorage(const char *nameSpace, const char *key);
+
+    size_t read(uint8_t *buffer, size_t maxLength) override;
+    bool write(const uint8_t *buffer, size_t length) override;
+    void erase() override;
+};
+#endif
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef CRC_H
+#define CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-32 (IEEE 802.3, reflected, as used by zlib). Pass the previous
+// result as crc to checksum data in pieces.
+uint32_t crc32(const uint8_t *data, size_t length, uint32_t crc = 0);
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, not reflected). Pass the
+// previous result as crc to continue a checksum.
+uint16_t crc16(const uint8_t *data, size_t length, uint16_t crc = 0xFFFF);
+
+#endif
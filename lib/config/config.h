@@ -6,6 +6,19 @@
 const int X_PIN = 34; // GPIO34 (ADC1_CH6) - input only, no pullup
 const int Y_PIN = 35; // GPIO35 (ADC1_CH7) - input only, no pullup
 
+// Analog axes in sampling order, all on ADC1 for the continuous scan. The
+// motor mapping reads AXIS_X and AXIS_Y; further entries (a second stick,
+// a throttle pot) are sampled, calibrated and filtered alongside them.
+// Each axis costs an 8 KB table with the LUT mapping kernel.
+const int JOYSTICK_AXES = 2;
+const int AXIS_PINS[JOYSTICK_AXES] = {X_PIN, Y_PIN};
+const char *const AXIS_NAMES[JOYSTICK_AXES] = {"X", "Y"};
+enum JoystickAxis
+{
+    AXIS_X = 0,
+    AXIS_Y = 1
+};
+
 // ESP32 ADC specifications
 const int ADC_RESOLUTION = 12;  // ESP32 has 12-bit ADC
 const int ADC_MAX_VALUE = 4095; // 2^12 - 1
@@ -13,13 +26,83 @@ const int ADC_MIN_VALUE = 0;
 const int ADC_DEFAULT_CENTER = 2048; // Theoretical center for 12-bit
 
 // Calibration settings (adjusted for ESP32)
-const int CALIBRATION_SAMPLES = 100; // More samples for better accuracy
-const int CALIBRATION_DELAY = 20;
-const int CENTER_CALIBRATION_TIME = 3000;
-const int RANGE_CALIBRATION_TIME = 8000; // Longer time for better range detection
+// Calibration runs as a state machine ticked from the control loop
+const int CALIBRATION_SAMPLES = 100;     // Upper bound on center samples
+const int CALIBRATION_DELAY = 5;         // ms between center samples
+const int CENTER_SETTLE_TIME = 500;      // ms before sampling the rest position
+const int CENTER_MIN_SAMPLES = 20;       // Samples before early finish is allowed
+const int CENTER_CONVERGED_ERROR = 2;    // Finish once the center's standard error is below this (counts)
+const int RANGE_SETTLE_TIME = 1000;      // ms to show "Move Joystick" before tracking
+const int RANGE_STABLE_TIME = 1500;      // Finish once extremes stop growing for this long
+const int RANGE_GROWTH_THRESHOLD = 8;    // Counts an extreme must grow by to count as growth
+const int RANGE_CALIBRATION_TIME = 8000; // Range phase timeout
+
+// Stored calibration (NVS): warm boot only re-checks the center
+const bool CALIBRATION_PERSIST = true;
+const int CENTER_CHECK_TIME = 100;      // ms of rest samples compared against the stored center
+const int CENTER_CHECK_TOLERANCE = 80;  // Max center shift (counts) before recalibrating
+const int CENTER_CHECK_MAX_NOISE = 200; // Peak-to-peak above this means the stick is being moved
+const char RECALIBRATE_COMMAND = 'c';   // Serial command forcing a full calibration
+
+// Background drift compensation (runs while the stick rests in the dead zone)
+const bool DRIFT_TRACKING_ENABLED = true;
+const int DRIFT_REST_TIME = 2000;       // ms at rest before the centers start following
+const int DRIFT_EMA_SHIFT = 13;         // Center EMA weight 2^-13 per sample (~16 s at 500 Hz)
+const int DRIFT_MAX_CORRECTION = 150;   // Max center shift (counts) from the calibrated value
+const int DRIFT_REBUILD_INTERVAL = 100; // Min ms between mapping rebuilds
+const int DRIFT_WIDEN_SAMPLES = 25;     // Consecutive readings past an extreme before the range widens (50 ms at 500 Hz)
+
+// Cycle-count profiling of the loop stages. Off by default: the probes
+// compile to nothing. Enable with -DPROFILING_ENABLED=1 in build_flags.
+#ifndef PROFILING_ENABLED
+#define PROFILING_ENABLED 0
+#endif
+const int PROFILE_CPU_MHZ = 240;        // CCOUNT rate, for the microsecond columns
+const char PROFILE_DUMP_COMMAND = 'p';  // Serial command printing the histograms
+
+// Glitch rejection ahead of smoothing (raw ADC counts)
+const bool GLITCH_REJECTION_ENABLED = true;
+const int GLITCH_MEDIAN_TAPS = 3;         // Running median window: 3, 5 or 7 (adds (taps - 1) / 2 samples of delay)
+const int GLITCH_OUTLIER_THRESHOLD = 150; // Distance from the median counted as a glitch
+const int GLITCH_MAX_STEP = 400;          // Max output change per sample (full throw in ~10 ms at 500 Hz)
 
 // Filter settings (adjusted for ESP32 noise characteristics)
-const int FILTER_SAMPLES = 5; // More samples for ESP32 ADC noise
+// Override the type with -DFILTER_TYPE=... in build_flags. The noise-tuned
+// One-Euro filter is opt-in: -DFILTER_TYPE=FILTER_TYPE_ONE_EURO.
+#define FILTER_TYPE_MOVING_AVERAGE 1 // Running-sum average of FILTER_SAMPLES
+#define FILTER_TYPE_EMA 2            // Fixed-point IIR, alpha = 2 / (FILTER_SAMPLES + 1)
+#define FILTER_TYPE_BIQUAD 3         // Cascaded Butterworth low-pass at FILTER_CUTOFF_HZ
+#define FILTER_TYPE_ONE_EURO 4       // Speed-adaptive low-pass tuned by the measured noise
+#ifndef FILTER_TYPE
+#define FILTER_TYPE FILTER_TYPE_MOVING_AVERAGE
+#endif
+const int FILTER_SAMPLES = 5;       // More samples for ESP32 ADC noise
+const int FILTER_CUTOFF_HZ = 20;    // Biquad -3 dB point
+const int FILTER_BIQUAD_STAGES = 2; // 4th-order Butterworth
+
+// One-Euro filter and online noise estimation (output units, +/-500 full scale)
+const float ONE_EURO_MIN_CUTOFF_HZ = 1.5f;        // Rest cutoff at the reference noise
+const float ONE_EURO_NOISE_REFERENCE = 3.0f;      // Std dev giving ONE_EURO_MIN_CUTOFF_HZ
+const float ONE_EURO_CUTOFF_FLOOR_HZ = 0.3f;      // Rest cutoff never drops below this
+const float ONE_EURO_BETA = 0.02f;                // Extra Hz per unit/s of stick speed
+const float ONE_EURO_DERIVATIVE_CUTOFF_HZ = 1.0f; // Smoothing of the speed estimate
+const int NOISE_WINDOW_SAMPLES = 250;             // Effective Welford window (0.5 s at 500 Hz)
+
+// Alpha-beta tracker: replaces the smoothing filter with a position and
+// velocity estimate, predicted forward by PIPELINE_DELAY_MS
+const bool TRACKER_ENABLED = false;
+const float TRACKER_ALPHA = 0.3f;  // Position correction gain
+const float TRACKER_BETA = 0.053f; // Velocity correction gain (alpha^2 / (2 - alpha): critically damped)
+const int PIPELINE_DELAY_MS = 4;   // Sample-to-motor latency to compensate
+
+// Mapping kernel for raw ADC -> output and speed/PWM conversion.
+// Both are bit-identical to the map()/constrain() reference; override with
+// -DMAPPING_KERNEL=MAPPING_KERNEL_FIXED in build_flags.
+#define MAPPING_KERNEL_LUT 1   // 4096-entry table per axis (8 KB each), rebuilt on calibration
+#define MAPPING_KERNEL_FIXED 2 // Division-free multiply-shift, no tables
+#ifndef MAPPING_KERNEL
+#define MAPPING_KERNEL MAPPING_KERNEL_LUT
+#endif
 
 // Joystick settings (adjusted for 12-bit range with extended resolution)
 const int DEAD_ZONE_PERCENT = 40; // Adjusted for new range (8% of 500 = 40)
@@ -33,12 +116,63 @@ const int MAX_OUTPUT = 500;
 // ADC_ATTEN_DB_11:  ~2600mV range (least sensitive, most common for 3.3V)
 const int ADC_ATTENUATION = 3; // ADC_ATTEN_DB_11 = 3
 
+// Continuous ADC sampling (ADC1 DMA scan over AXIS_PINS)
+// When disabled (or unavailable) reads fall back to analogRead()
+const bool ADC_CONTINUOUS_MODE = true;
+const int ADC_SAMPLE_RATE_HZ = 20000; // Total conversions/s, shared by all axes (ESP32 minimum is 20000)
+const int ADC_RING_FRAMES = 64;       // Recent frames (one sample per axis) kept by the sampler
+
+// Oversampling and linearity correction
+const int ADC_OVERSAMPLE_BITS = 2;                              // Average 4^bits frames per reading (0 = newest frame only)
+const int ADC_OVERSAMPLE_FRAMES = 1 << (2 * ADC_OVERSAMPLE_BITS); // 16 of the ~20 frames per 500 Hz tick
+const bool ADC_LINEARITY_CORRECTION = true;                     // Correct codes with the eFuse characterization (esp_adc_cal)
+const int ADC_DEFAULT_VREF_MV = 1100;                           // Used when the eFuse holds no calibration
+
 // Serial settings
-const int SERIAL_BAUD = 115200; // ESP32 typically uses higher baud rate
+// Serial output: the status text, or binary telemetry frames (COBS +
+// CRC-16, see telemetry.h; decode captures with tools/telemetry_csv.cpp)
+// with -DTELEMETRY_MODE=TELEMETRY_BINARY in build_flags. Boot messages,
+// calibration reports and log lines stay text in both modes; in binary
+// mode the decoder drops them between frames.
+#define TELEMETRY_TEXT 1
+#define TELEMETRY_BINARY 2
+#ifndef TELEMETRY_MODE
+#define TELEMETRY_MODE TELEMETRY_TEXT
+#endif
+const int TELEMETRY_RATE_HZ = 50; // Periodic frames; command changes are sent immediately
+
+const int SERIAL_BAUD = TELEMETRY_MODE == TELEMETRY_BINARY ? 921600 : 115200;
 const int LOOP_DELAY = 50;      // Faster loop for ESP32
 
+// Control loop scheduling
+const bool FIXED_RATE_LOOP = true; // false: legacy loop paced by delay(LOOP_DELAY)
+const int CONTROL_RATE_HZ = 500;   // Fixed read->map->output rate (timer driven)
+const int FILTER_SAMPLE_RATE_HZ = FIXED_RATE_LOOP ? CONTROL_RATE_HZ : 1000 / LOOP_DELAY;
+
+// ADC DMA interrupt size: about one control tick of frames, so every tick
+// sees fresh conversions instead of waiting for a larger burst
+const int ADC_FRAMES_PER_TICK = ADC_SAMPLE_RATE_HZ / JOYSTICK_AXES / CONTROL_RATE_HZ; // 20 at 20 kHz, 2 axes, 500 Hz
+static_assert(ADC_FRAMES_PER_TICK > 0, "ADC sample rate too low for the control rate");
+
+// Dual-core task split (ESP32 only; other targets keep the single loop)
+// Control task: sampling, mapping, motor output. UI task: LCD and Serial.
+const bool DUAL_CORE_PIPELINE = true;
+const int CONTROL_TASK_CORE = 1; // Arduino core, away from the WiFi stack
+const int UI_TASK_CORE = 0;
+const int CONTROL_TASK_PRIORITY = 5;
+const int UI_TASK_PRIORITY = 1;
+const int TASK_STACK_SIZE = 4096;
+const int UI_TASK_PERIOD = 10;     // ms between presentation passes
+const int COMMAND_QUEUE_DEPTH = 16; // Power of two
+
+// Deferred logging (records are formatted by a low-priority task)
+const int LOG_QUEUE_DEPTH = 32;  // Records, power of two
+const int LOG_LINE_LENGTH = 96;  // Longest formatted line
+const int LOG_TASK_PRIORITY = 1; // Lowest application priority (idle is 0)
+const int LOG_TASK_PERIOD = 20;  // ms between drains
+
 // Motor pins (ESP32 has different PWM characteristics)
-const int MOTOR_ENA_PIN = 3; // Make sure this supports PWM on ESP32
+const int MOTOR_ENA_PIN = 25; // LEDC output; GPIO3 is UART0 RX on the LOLIN32 Lite
 const int MOTOR_IN1_PIN = 4;
 const int MOTOR_IN2_PIN = 5;
 
@@ -55,22 +189,58 @@ const int STOP_SPEED = 0;
 // Speed ramping settings
 const int RAMP_DELAY = 20;
 const int RAMP_STEP = 5;
+const int MOTOR_SLEW_RATE = RAMP_STEP * 1000 / RAMP_DELAY; // Duty counts per second
+const unsigned long MOTOR_REVERSE_DEAD_TIME_US = 50000;     // Held at zero before reversing
+
+// Let the LEDC fade engine interpolate the ramp in hardware, one chunk at a
+// time, instead of a duty write per control cycle. ESP32 only.
+#ifndef MOTOR_HARDWARE_FADE
+#define MOTOR_HARDWARE_FADE 0
+#endif
+const unsigned long MOTOR_FADE_CHUNK_US = 50000; // Longest fade handed to the hardware
+
+// Closed-loop speed control from a quadrature encoder on the motor. Off by
+// default: the duty follows the mapping open loop. When on, the mapped duty
+// becomes feed-forward and the PID trims it to hold the commanded speed.
+const bool MOTOR_CLOSED_LOOP = false;
+const int ENCODER_A_PIN = 32;
+const int ENCODER_B_PIN = 33;
+const int ENCODER_PCNT_UNIT = 0;
+const int ENCODER_PCNT_LIMIT = 16384;   // Counter folds into a software total here
+const int ENCODER_FILTER_CYCLES = 100;  // APB cycles (80 MHz) an edge must hold
+const int ENCODER_COUNTS_PER_REV = 1320; // 11 lines x4 edges x 30:1 gearbox
+const int MOTOR_MAX_RPM = 330;           // Output shaft, full duty, no load
+const int MOTOR_MAX_COUNTS_PER_SEC = ENCODER_COUNTS_PER_REV * MOTOR_MAX_RPM / 60;
+const int SPEED_PID_RATE_HZ = 100;  // Run every CONTROL_RATE_HZ / SPEED_PID_RATE_HZ control ticks
+const float SPEED_PID_KP = 0.04f;   // Duty counts per count/s of error
+const float SPEED_PID_KI = 0.6f;    // Duty counts per count/s, per second
+const float SPEED_PID_KD = 0.0f;    // Duty counts per count/s per second of speed change
 
 // Control settings (adjusted for 12-bit precision and extended range)
 const int DIRECTION_DEAD_ZONE = 40; // Adjusted for new range (8% of 500 = 40)
 const int SPEED_DEAD_ZONE = 40;     // Adjusted for new range (8% of 500 = 40)
 const int MIN_MOTOR_SPEED = 125;    // Minimum useful motor speed (25% of 500 = 125)
 
+// Speed response curves: stick travel from SPEED_DEAD_ZONE to MAX_OUTPUT
+// maps to MIN_MOTOR_PERCENT..100% through the selected profile (linear,
+// expo, S-curve, precision; see response_curve.cpp). Each profile is
+// compiled once into a small interpolated table.
+const int MIN_MOTOR_PERCENT = MIN_MOTOR_SPEED * 100 / MAX_OUTPUT; // 25%
+const int SPEED_CURVE_DEFAULT = 0;        // Profile index at boot (0 = linear)
+const int SPEED_CURVE_EXPO_PERCENT = 60;  // Expo profile: 0 linear .. 100 fully cubic
+const char SPEED_CURVE_COMMAND = 'r';     // Serial command selecting the next profile
+
 // LCD I2C settings (ESP32 has flexible I2C pins)
 const int LCD_ADDRESS = 0x27;
 const int LCD_SDA_PIN = 18; // ESP32 I2C SDA
 const int LCD_SCL_PIN = 19; // ESP32 I2C SCL
+const int LCD_I2C_CLOCK = 400000; // Fast-mode I2C for LCD bursts
 const int LCD_COLS = 16;
 const int LCD_ROWS = 2;
 
 // LCD timing settings
 const int LCD_UPDATE_INTERVAL = 150; // Faster updates for ESP32
-const int LCD_STARTUP_DELAY = 2000;
+const int LCD_UPDATE_BUDGET_US = 1000; // Max time per LCDController::update() slice
 const int LCD_INSTRUCTION_DELAY = 1500;
 
 // ESP32 specific timing
@@ -0,0 +1,60 @@
+#ifndef COMMAND_MAPPING_H
+#define COMMAND_MAPPING_H
+
+#include "config.h"
+#include "mapping_kernel.h"
+#include "response_curve.h"
+#include <stdlib.h>
+
+struct SimpleMotorCommand
+{
+    MotorDirection direction;
+    int speedPercent; // 0-100%
+    int speedPWM;     // 0-255 PWM value
+    int speedRate;    // Y-axis stick velocity (units/s), 0 without the tracker
+    bool hasChanged;
+};
+
+// Mapper stage, the last one after AxisPipeline's filter, dead zone and
+// curve: processed axes (output units) to a motor command. Policies fill
+// everything but hasChanged:
+//   void map(const int *axis, const int *velocity, SimpleMotorCommand &command) const
+
+// X picks the direction and Y (positive only) the speed, each behind its
+// own dead zone on top of the joystick's. Y travel past the dead zone
+// goes through the active speed curve profile.
+class DirectionSpeedMapping
+{
+private:
+    ResponseCurveSet speedCurves;
+    SpeedMapper speedMapper;
+
+public:
+    DirectionSpeedMapping()
+    {
+        speedCurves.begin(SPEED_CURVE_PROFILES, SPEED_CURVE_COUNT, SPEED_DEAD_ZONE, MAX_OUTPUT, MIN_MOTOR_PERCENT, 100);
+        speedCurves.select(SPEED_CURVE_DEFAULT);
+    }
+
+    // Safe to call from another task than map()
+    ResponseCurveSet &getSpeedCurves() { return speedCurves; }
+    const ResponseCurveSet &getSpeedCurves() const { return speedCurves; }
+
+    void map(const int *axis, const int *velocity, SimpleMotorCommand &command) const
+    {
+        int x = axis[AXIS_X];
+        if (abs(x) < DIRECTION_DEAD_ZONE)
+            command.direction = MOTOR_STOP;
+        else
+            command.direction = x > 0 ? MOTOR_FORWARD : MOTOR_BACKWARD;
+
+        int y = axis[AXIS_Y];
+        command.speedPercent = y < SPEED_DEAD_ZONE ? 0 : speedCurves.evaluate(y);
+        command.speedPWM = speedMapper.percentToPWM(command.speedPercent);
+        command.speedRate = velocity[AXIS_Y];
+    }
+};
+
+typedef DirectionSpeedMapping DefaultCommandMapping;
+
+#endif
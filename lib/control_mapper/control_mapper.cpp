@@ -1,27 +1,29 @@
 #include "control_mapper.h"
+#include "logger.h"
 #include <Arduino.h>
 
 SimpleControlMapper::SimpleControlMapper()
 {
-    lastCommand = {MOTOR_STOP, 0, 0, false};
+    lastCommand = {MOTOR_STOP, 0, 0, 0, false};
 }
 
 void SimpleControlMapper::begin()
 {
     Serial.println("Simple Control Mapper initialized");
     Serial.println("X-axis = Direction | Y-axis = Speed");
+    Serial.print("Speed curve: ");
+    Serial.print(getSpeedCurveName());
+    Serial.print(" (");
+    Serial.print(mapping.getSpeedCurves().getCount());
+    Serial.println(" profiles)");
 }
 
 SimpleMotorCommand SimpleControlMapper::processInput(const JoystickPosition &joy)
 {
     SimpleMotorCommand command;
 
-    // Determine direction from X-axis
-    command.direction = determineDirection(joy.x);
-
-    // Calculate speed from Y-axis (positive values only)
-    command.speedPercent = calculateSpeed(joy.y);
-    command.speedPWM = percentToPWM(command.speedPercent);
+    // X sets the direction, Y the speed
+    mapping.map(joy.axis, joy.velocity, command);
 
     // Check if command has changed
     command.hasChanged = hasCommandChanged(command);
@@ -35,38 +37,16 @@ SimpleMotorCommand SimpleControlMapper::processInput(const JoystickPosition &joy
     return command;
 }
 
-MotorDirection SimpleControlMapper::determineDirection(int xValue)
+const char *SimpleControlMapper::selectNextSpeedCurve()
 {
-    if (abs(xValue) < DIRECTION_DEAD_ZONE)
-    {
-        return MOTOR_STOP; // In dead zone, no direction
-    }
-    else if (xValue > 0)
-    {
-        return MOTOR_FORWARD; // Positive X = Forward
-    }
-    else
-    {
-        return MOTOR_BACKWARD; // Negative X = Backward
-    }
+    ResponseCurveSet &curves = mapping.getSpeedCurves();
+    return curves.getName(curves.selectNext());
 }
 
-int SimpleControlMapper::calculateSpeed(int yValue)
+const char *SimpleControlMapper::getSpeedCurveName() const
 {
-    // Only use positive Y values for speed
-    if (yValue < SPEED_DEAD_ZONE)
-    {
-        return 0; // Below dead zone = no speed
-    }
-
-    // Map Y value (dead zone to 100) to speed (min to 100%)
-    int speed = map(yValue, SPEED_DEAD_ZONE, 100, MIN_MOTOR_SPEED, 100);
-    return constrain(speed, 0, 100);
-}
-
-int SimpleControlMapper::percentToPWM(int percent)
-{
-    return map(percent, 0, 100, MIN_SPEED, MAX_SPEED);
+    const ResponseCurveSet &curves = mapping.getSpeedCurves();
+    return curves.getName(curves.getActive());
 }
 
 bool SimpleControlMapper::hasCommandChanged(const SimpleMotorCommand &newCmd)
@@ -79,25 +59,9 @@ void SimpleControlMapper::printCommand(const SimpleMotorCommand &cmd) const
 {
     if (cmd.hasChanged)
     {
-        Serial.print("Command - Direction: ");
-
-        if (cmd.direction == MOTOR_FORWARD)
-        {
-            Serial.print("FORWARD");
-        }
-        else if (cmd.direction == MOTOR_BACKWARD)
-        {
-            Serial.print("BACKWARD");
-        }
-        else
-        {
-            Serial.print("STOP");
-        }
-
-        Serial.print(" | Speed: ");
-        Serial.print(cmd.speedPercent);
-        Serial.print("% (PWM: ");
-        Serial.print(cmd.speedPWM);
-        Serial.println(")");
+        const char *direction = cmd.direction == MOTOR_FORWARD    ? "FORWARD"
+                                : cmd.direction == MOTOR_BACKWARD ? "BACKWARD"
+                                                                  : "STOP";
+        logEvent(LOG_COMMAND, direction, cmd.speedPercent, cmd.speedPWM);
     }
 }
\ No newline at end of file
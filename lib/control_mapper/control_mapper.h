@@ -3,23 +3,16 @@
 
 #include "config.h"
 #include "joystick.h"
+#include "command_mapping.h"
 
-struct SimpleMotorCommand
-{
-    MotorDirection direction;
-    int speedPercent; // 0-100%
-    int speedPWM;     // 0-255 PWM value
-    bool hasChanged;
-};
-
+// Joystick position -> motor command through the mapper stage
+// (command_mapping.h), plus change detection for logging
 class SimpleControlMapper
 {
 private:
     SimpleMotorCommand lastCommand;
+    DefaultCommandMapping mapping;
 
-    MotorDirection determineDirection(int xValue);
-    int calculateSpeed(int yValue);
-    int percentToPWM(int percent);
     bool hasCommandChanged(const SimpleMotorCommand &newCmd);
 
 public:
@@ -27,6 +20,11 @@ public:
 
     void begin();
     SimpleMotorCommand processInput(const JoystickPosition &joy);
+
+    // Speed response curve; switching is safe while processInput() runs
+    // on another task
+    const char *selectNextSpeedCurve(); // Returns the new profile's name
+    const char *getSpeedCurveName() const;
     void printCommand(const SimpleMotorCommand &cmd) const;
 };
 
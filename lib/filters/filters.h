@@ -0,0 +1,329 @@
+#ifndef FILTERS_H
+#define FILTERS_H
+
+#include "config.h"
+#include <math.h>
+#include <stdint.h>
+
+// Smoothing filters with a common shape:
+//   int update(int sample)   - O(1), returns the filtered value
+//   void reset()             - the next sample re-primes the filter
+//   void setNoise(float sd)  - at-rest noise (output units); only adaptive filters use it
+//   float cutoffHz() const   - current (approximate) -3 dB frequency
+// Every filter primes itself with its first sample so the output starts at
+// the input instead of ramping up from zero. Each axis owns one instance.
+
+// Running-sum moving average over N samples (truncating, like the original loop)
+template <int N>
+class MovingAverageFilter
+{
+    static_assert(N > 0, "MovingAverageFilter needs at least one sample");
+
+private:
+    int history[N];
+    long sum;
+    int index;
+    bool primed;
+
+public:
+    MovingAverageFilter() { reset(); }
+
+    void reset()
+    {
+        sum = 0;
+        index = 0;
+        primed = false;
+    }
+
+    int update(int sample)
+    {
+        if (!primed)
+        {
+            for (int i = 0; i < N; i++)
+            {
+                history[i] = sample;
+            }
+            sum = (long)sample * N;
+            primed = true;
+            return sample;
+        }
+
+        sum += sample - history[index];
+        history[index] = sample;
+        index = (index + 1 == N) ? 0 : index + 1;
+        return (int)(sum / N);
+    }
+
+    void setNoise(float) {}
+    float cutoffHz() const { return 0.443f * FILTER_SAMPLE_RATE_HZ / N; }
+};
+
+// First-order IIR (exponential moving average) in Q8 fixed point.
+// AlphaQ8 is the weight of each new sample out of 256.
+template <int AlphaQ8>
+class EmaFilter
+{
+    static_assert(AlphaQ8 > 0 && AlphaQ8 <= 256, "EmaFilter alpha must be in (0, 256]");
+
+private:
+    int32_t state;     // Q8
+    int32_t remainder; // Fraction of a Q8 step the last update dropped, out of 256
+    bool primed;
+
+public:
+    EmaFilter() { reset(); }
+
+    void reset()
+    {
+        state = 0;
+        remainder = 0;
+        primed = false;
+    }
+
+    int update(int sample)
+    {
+        int32_t target = (int32_t)sample * 256;
+        if (!primed)
+        {
+            state = target;
+            remainder = 0;
+            primed = true;
+            return sample;
+        }
+
+        // Carry what the division drops into the next update: otherwise a
+        // difference below 256 / AlphaQ8 never moves the state and it
+        // stalls short of a constant input
+        int32_t step = (target - state) * AlphaQ8 + remainder;
+        state += step / 256;
+        remainder = step % 256;
+        // Round half away from zero back to counts
+        return (int)((state >= 0 ? state + 128 : state - 128) / 256);
+    }
+
+    void setNoise(float) {}
+    float cutoffHz() const
+    {
+        return -logf(1.0f - AlphaQ8 / 256.0f) * FILTER_SAMPLE_RATE_HZ / (2.0f * 3.14159265f);
+    }
+};
+
+// Cascaded second-order Butterworth low-pass sections (transposed direct
+// form II, float: the ESP32 has a single-precision FPU).
+template <int Stages>
+class BiquadLowPass
+{
+    static_assert(Stages > 0, "BiquadLowPass needs at least one stage");
+
+private:
+    struct Section
+    {
+        float b0, b1, b2, a1, a2;
+        float z1, z2;
+    };
+
+    Section sections[Stages];
+    float cutoff;
+    bool primed;
+
+public:
+    BiquadLowPass(float cutoffHz = FILTER_CUTOFF_HZ, float sampleRateHz = FILTER_SAMPLE_RATE_HZ)
+        : cutoff(cutoffHz)
+    {
+        const float pi = 3.14159265f;
+        float w0 = 2.0f * pi * cutoffHz / sampleRateHz;
+        float cosW0 = cosf(w0);
+        float sinW0 = sinf(w0);
+
+        for (int k = 0; k < Stages; k++)
+        {
+            // Butterworth pole pair k of a (2 * Stages)-order filter
+            float q = 1.0f / (2.0f * cosf(pi * (2 * k + 1) / (4.0f * Stages)));
+            float alpha = sinW0 / (2.0f * q);
+            float a0 = 1.0f + alpha;
+
+            Section &s = sections[k];
+            s.b0 = (1.0f - cosW0) / 2.0f / a0;
+            s.b1 = (1.0f - cosW0) / a0;
+            s.b2 = s.b0;
+            s.a1 = -2.0f * cosW0 / a0;
+            s.a2 = (1.0f - alpha) / a0;
+        }
+        reset();
+    }
+
+    void reset()
+    {
+        for (int k = 0; k < Stages; k++)
+        {
+            sections[k].z1 = 0.0f;
+            sections[k].z2 = 0.0f;
+        }
+        primed = false;
+    }
+
+    int update(int sample)
+    {
+        float x = (float)sample;
+
+        if (!primed)
+        {
+            // Steady state for a constant input (unity DC gain)
+            for (int k = 0; k < Stages; k++)
+            {
+                Section &s = sections[k];
+                s.z2 = (s.b2 - s.a2) * x;
+                s.z1 = (s.b1 - s.a1) * x + s.z2;
+            }
+            primed = true;
+            return sample;
+        }
+
+        for (int k = 0; k < Stages; k++)
+        {
+            Section &s = sections[k];
+            float y = s.b0 * x + s.z1;
+            s.z1 = s.b1 * x - s.a1 * y + s.z2;
+            s.z2 = s.b2 * x - s.a2 * y;
+            x = y;
+        }
+        return (int)lroundf(x);
+    }
+
+    void setNoise(float) {}
+    float cutoffHz() const { return cutoff; }
+};
+
+// One-Euro filter (Casiez et al.): a first-order low-pass whose cutoff rises
+// with the estimated speed, so the stick is heavily smoothed at rest and
+// barely delayed while it moves. setNoise() retunes the rest cutoff: a
+// first-order filter passes noise power in proportion to its cutoff, so
+// scaling the cutoff by (reference / noise)^2 keeps rest jitter constant.
+class OneEuroFilter
+{
+private:
+    float rate;       // Samples per second
+    float restCutoff; // Hz, from the noise estimate
+    float beta;       // Hz of extra cutoff per output unit/s
+    float derivativeAlpha;
+    float value;
+    float derivative; // Output units per second, smoothed
+    float cutoff;     // Hz, last used
+    bool primed;
+
+    float alphaFor(float cutoffHz) const
+    {
+        float tau = 1.0f / (2.0f * 3.14159265f * cutoffHz);
+        return 1.0f / (1.0f + tau * rate);
+    }
+
+public:
+    OneEuroFilter(float sampleRateHz = FILTER_SAMPLE_RATE_HZ)
+        : rate(sampleRateHz), restCutoff(ONE_EURO_MIN_CUTOFF_HZ), beta(ONE_EURO_BETA)
+    {
+        derivativeAlpha = alphaFor(ONE_EURO_DERIVATIVE_CUTOFF_HZ);
+        cutoff = restCutoff;
+        reset();
+    }
+
+    void reset()
+    {
+        value = 0.0f;
+        derivative = 0.0f;
+        primed = false;
+    }
+
+    int update(int sample)
+    {
+        float x = (float)sample;
+        if (!primed)
+        {
+            value = x;
+            derivative = 0.0f;
+            primed = true;
+            return sample;
+        }
+
+        derivative += derivativeAlpha * ((x - value) * rate - derivative);
+        cutoff = restCutoff + beta * fabsf(derivative);
+        value += alphaFor(cutoff) * (x - value);
+        return (int)lroundf(value);
+    }
+
+    void setNoise(float stdDev)
+    {
+        float ratio = ONE_EURO_NOISE_REFERENCE / (stdDev > 0.01f ? stdDev : 0.01f);
+        float target = ONE_EURO_MIN_CUTOFF_HZ * ratio * ratio;
+        restCutoff = target < ONE_EURO_CUTOFF_FLOOR_HZ ? ONE_EURO_CUTOFF_FLOOR_HZ
+                     : target > FILTER_CUTOFF_HZ       ? (float)FILTER_CUTOFF_HZ
+                                                       : target;
+    }
+
+    float cutoffHz() const { return cutoff; }
+};
+
+// Alpha-beta tracker: constant-velocity model giving position and velocity.
+// update() returns the position predicted leadMs ahead, which cancels the
+// known sample-to-output latency for a moving stick. At rest velocity
+// settles to zero and the output is just the smoothed position.
+class AlphaBetaTracker
+{
+private:
+    float alpha;
+    float beta;
+    float dt;   // Seconds per sample
+    float lead; // Seconds to predict ahead
+    float position;
+    float velocity; // Units per second
+    bool primed;
+
+public:
+    AlphaBetaTracker(float alpha = TRACKER_ALPHA, float beta = TRACKER_BETA,
+                     float sampleRateHz = FILTER_SAMPLE_RATE_HZ, float leadMs = PIPELINE_DELAY_MS)
+        : alpha(alpha), beta(beta), dt(1.0f / sampleRateHz), lead(leadMs / 1000.0f)
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        position = 0.0f;
+        velocity = 0.0f;
+        primed = false;
+    }
+
+    int update(int sample)
+    {
+        float z = (float)sample;
+        if (!primed)
+        {
+            position = z;
+            velocity = 0.0f;
+            primed = true;
+            return sample;
+        }
+
+        float predicted = position + velocity * dt;
+        float residual = z - predicted;
+        position = predicted + alpha * residual;
+        velocity += (beta / dt) * residual;
+
+        return (int)lroundf(position + velocity * lead);
+    }
+
+    float getPosition() const { return position; }
+    float getVelocity() const { return velocity; }
+};
+
+// Compile-time selection (FILTER_TYPE in config.h)
+#if FILTER_TYPE == FILTER_TYPE_EMA
+typedef EmaFilter<512 / (FILTER_SAMPLES + 1)> AxisFilter; // alpha = 2 / (N + 1)
+#elif FILTER_TYPE == FILTER_TYPE_BIQUAD
+typedef BiquadLowPass<FILTER_BIQUAD_STAGES> AxisFilter;
+#elif FILTER_TYPE == FILTER_TYPE_ONE_EURO
+typedef OneEuroFilter AxisFilter;
+#else
+typedef MovingAverageFilter<FILTER_SAMPLES> AxisFilter;
+#endif
+
+#endif
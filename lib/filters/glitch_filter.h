@@ -0,0 +1,108 @@
+#ifndef GLITCH_FILTER_H
+#define GLITCH_FILTER_H
+
+#include "config.h"
+#include <stdlib.h>
+
+// Glitch rejection for raw ADC counts, run ahead of smoothing:
+//   1. Running median over the last Taps samples. The window is kept
+//      sorted, so each update moves one value (at most Taps - 1 shifts,
+//      no per-sample sort); a single spike never reaches the output.
+//   2. Rate-of-change limit: the output moves at most maxStep counts per
+//      sample, which clips spikes longer than the median can hide.
+// Samples further than outlierThreshold from the median are counted as
+// rejected; clipped steps are counted separately, since a fast but genuine
+// stick move is clipped too.
+template <int Taps>
+class GlitchFilter
+{
+    static_assert(Taps >= 3 && (Taps & 1) == 1, "GlitchFilter needs an odd window of at least 3 taps");
+
+private:
+    int window[Taps]; // Arrival order (ring)
+    int sorted[Taps];
+    int index;
+    int last;
+    int maxStep;
+    int outlierThreshold;
+    unsigned long outliers;
+    unsigned long limited;
+    bool primed;
+
+public:
+    GlitchFilter(int maxStep = GLITCH_MAX_STEP, int outlierThreshold = GLITCH_OUTLIER_THRESHOLD)
+        : maxStep(maxStep), outlierThreshold(outlierThreshold), outliers(0), limited(0)
+    {
+        reset();
+    }
+
+    // Counters survive a reset
+    void reset()
+    {
+        index = 0;
+        last = 0;
+        primed = false;
+    }
+
+    int update(int sample)
+    {
+        if (!primed)
+        {
+            for (int i = 0; i < Taps; i++)
+            {
+                window[i] = sample;
+                sorted[i] = sample;
+            }
+            last = sample;
+            primed = true;
+            return sample;
+        }
+
+        // Swap the oldest sample for the new one in the sorted window
+        int oldest = window[index];
+        window[index] = sample;
+        index = (index + 1 == Taps) ? 0 : index + 1;
+
+        int pos = 0;
+        while (sorted[pos] != oldest)
+        {
+            pos++;
+        }
+        while (pos > 0 && sorted[pos - 1] > sample)
+        {
+            sorted[pos] = sorted[pos - 1];
+            pos--;
+        }
+        while (pos < Taps - 1 && sorted[pos + 1] < sample)
+        {
+            sorted[pos] = sorted[pos + 1];
+            pos++;
+        }
+        sorted[pos] = sample;
+
+        int output = sorted[Taps / 2];
+        if (abs(sample - output) > outlierThreshold)
+        {
+            outliers++;
+        }
+
+        if (output - last > maxStep)
+        {
+            output = last + maxStep;
+            limited++;
+        }
+        else if (last - output > maxStep)
+        {
+            output = last - maxStep;
+            limited++;
+        }
+
+        last = output;
+        return output;
+    }
+
+    unsigned long getRejected() const { return outliers; } // Removed by the median
+    unsigned long getClipped() const { return limited; }   // Held back by the step limit
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef NOISE_ESTIMATOR_H
+#define NOISE_ESTIMATOR_H
+
+#include <math.h>
+
+// Online mean and variance (Welford). The effective sample count is capped
+// at Window, after which older samples decay exponentially, so the estimate
+// follows noise that changes with motor load instead of freezing at boot.
+template <int Window>
+class NoiseEstimator
+{
+    static_assert(Window > 1, "NoiseEstimator needs a window of at least two samples");
+
+private:
+    float mean;
+    float variance; // Population variance
+    int count;
+
+public:
+    NoiseEstimator() { reset(); }
+
+    void reset()
+    {
+        mean = 0.0f;
+        variance = 0.0f;
+        count = 0;
+    }
+
+    void update(float sample)
+    {
+        if (count < Window)
+        {
+            count++;
+        }
+
+        float delta = sample - mean;
+        mean += delta / count;
+        variance += (delta * (sample - mean) - variance) / count;
+    }
+
+    bool isValid() const { return count >= Window / 4; }
+    float getMean() const { return mean; }
+    float getVariance() const { return variance; }
+    float getStdDev() const { return sqrtf(variance); }
+    int getCount() const { return count; }
+};
+
+#endif
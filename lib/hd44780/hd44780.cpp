@@ -0,0 +1,199 @@
+#include "hd44780.h"
+
+// HD44780 instructions
+static const uint8_t CMD_CLEAR = 0x01;
+static const uint8_t CMD_HOME = 0x02;
+static const uint8_t CMD_ENTRY_MODE = 0x06;     // Increment, no shift
+static const uint8_t CMD_DISPLAY_ON = 0x0C;     // Display on, cursor and blink off
+static const uint8_t CMD_FUNCTION_4BIT = 0x28;  // 4-bit, 2 lines, 5x8 font
+static const uint8_t CMD_SET_DDRAM = 0x80;
+
+// Clear and home run for up to 1.52 ms; everything else is ~37 us, which the
+// two expander bytes between latches already cover at 100 kHz and 400 kHz
+static const unsigned long SLOW_COMMAND_DELAY = 2;
+
+static const uint8_t ROW_OFFSETS[4] = {0x00, 0x40, 0x14, 0x54};
+
+size_t hd44780Encode(const uint8_t *bytes, size_t count, bool isData, uint8_t backlight,
+                     uint8_t *out, size_t outSize)
+{
+    if (count * HD44780_WIRE_BYTES_PER_BYTE > outSize)
+        return 0;
+
+    uint8_t flags = (uint8_t)((isData ? PCF8574_RS : 0) | backlight);
+    size_t pos = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        uint8_t high = (uint8_t)((bytes[i] & 0xF0) | flags);
+        uint8_t low = (uint8_t)(((bytes[i] << 4) & 0xF0) | flags);
+
+        // Data is latched on the falling edge of EN
+        out[pos++] = (uint8_t)(high | PCF8574_EN);
+        out[pos++] = high;
+        out[pos++] = (uint8_t)(low | PCF8574_EN);
+        out[pos++] = low;
+    }
+
+    return pos;
+}
+
+HD44780Driver::HD44780Driver(uint8_t address, uint8_t cols, uint8_t rows, TwoWire &wire)
+    : wire(wire), address(address), cols(cols), rows(rows),
+      backlightMask(PCF8574_BACKLIGHT), burstLength(0), transactions(0), wireBytes(0)
+{
+}
+
+void HD44780Driver::init()
+{
+    // Power-on wait, then the datasheet's reset-by-instruction sequence
+    delay(50);
+    uint8_t idle = backlightMask;
+    wire.beginTransmission(address);
+    wire.write(idle);
+    wire.endTransmission();
+
+    writeNibble(0x03);
+    delay(5);
+    writeNibble(0x03);
+    delayMicroseconds(150);
+    writeNibble(0x03);
+    delayMicroseconds(150);
+    writeNibble(0x02); // Switch to 4-bit mode
+
+    command(CMD_FUNCTION_4BIT);
+    command(CMD_DISPLAY_ON);
+    command(CMD_ENTRY_MODE);
+    flushBurst();
+    clear();
+}
+
+void HD44780Driver::writeNibble(uint8_t nibble)
+{
+    uint8_t value = (uint8_t)((nibble << 4) | backlightMask);
+    uint8_t strobe[2] = {(uint8_t)(value | PCF8574_EN), value};
+
+    wire.beginTransmission(address);
+    wire.write(strobe, sizeof(strobe));
+    wire.endTransmission();
+    transactions++;
+    wireBytes += sizeof(strobe);
+}
+
+void HD44780Driver::command(uint8_t value)
+{
+    append(&value, 1, false);
+}
+
+void HD44780Driver::append(const uint8_t *bytes, size_t count, bool isData)
+{
+    while (count > 0)
+    {
+        size_t room = (HD44780_MAX_BURST - burstLength) / HD44780_WIRE_BYTES_PER_BYTE;
+        if (room == 0)
+        {
+            flushBurst();
+            continue;
+        }
+
+        size_t chunk = (count < room) ? count : room;
+        burstLength += hd44780Encode(bytes, chunk, isData, backlightMask,
+                                     &burst[burstLength], HD44780_MAX_BURST - burstLength);
+        bytes += chunk;
+        count -= chunk;
+    }
+}
+
+void HD44780Driver::flushBurst()
+{
+    if (burstLength == 0)
+        return;
+
+    wire.beginTransmission(address);
+    wire.write(burst, burstLength);
+    wire.endTransmission();
+
+    transactions++;
+    wireBytes += burstLength;
+    burstLength = 0;
+}
+
+void HD44780Driver::clear()
+{
+    command(CMD_CLEAR);
+    flushBurst();
+    delay(SLOW_COMMAND_DELAY);
+}
+
+void HD44780Driver::home()
+{
+    command(CMD_HOME);
+    flushBurst();
+    delay(SLOW_COMMAND_DELAY);
+}
+
+void HD44780Driver::setCursor(uint8_t col, uint8_t row)
+{
+    if (row >= rows)
+        row = rows - 1;
+    command((uint8_t)(CMD_SET_DDRAM | (col + ROW_OFFSETS[row & 3])));
+    flushBurst();
+}
+
+void HD44780Driver::backlight()
+{
+    backlightMask = PCF8574_BACKLIGHT;
+    wire.beginTransmission(address);
+    wire.write(backlightMask);
+    wire.endTransmission();
+    transactions++;
+    wireBytes++;
+}
+
+void HD44780Driver::noBacklight()
+{
+    backlightMask = 0;
+    wire.beginTransmission(address);
+    wire.write(backlightMask);
+    wire.endTransmission();
+    transactions++;
+    wireBytes++;
+}
+
+void HD44780Driver::writeAt(uint8_t col, uint8_t row, const char *chars, size_t length)
+{
+    if (row >= rows)
+        row = rows - 1;
+    if (col >= cols)
+        return;
+    if (length > (size_t)(cols - col))
+        length = cols - col;
+
+    command((uint8_t)(CMD_SET_DDRAM | (col + ROW_OFFSETS[row & 3])));
+    append((const uint8_t *)chars, length, true);
+    flushBurst();
+}
+
+size_t HD44780Driver::write(uint8_t value)
+{
+    append(&value, 1, true);
+    flushBurst();
+    return 1;
+}
+
+size_t HD44780Driver::write(const uint8_t *buffer, size_t size)
+{
+    append(buffer, size, true);
+    flushBurst();
+    return size;
+}
+
+unsigned long HD44780Driver::getTransactions() const
+{
+    return transactions;
+}
+
+unsigned long HD44780Driver::getWireBytes() const
+{
+    return wireBytes;
+}
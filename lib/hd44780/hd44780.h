@@ -0,0 +1,70 @@
+#ifndef HD44780_H
+#define HD44780_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// PCF8574 backpack wiring: P0=RS P1=RW P2=EN P3=backlight P4-P7=D4-D7
+const uint8_t PCF8574_RS = 0x01;
+const uint8_t PCF8574_EN = 0x04;
+const uint8_t PCF8574_BACKLIGHT = 0x08;
+
+// Expander bytes per HD44780 byte: two nibbles, each latched by EN high then low
+const size_t HD44780_WIRE_BYTES_PER_BYTE = 4;
+
+// Largest single I2C write (ESP32 Wire buffer is 128 bytes)
+const size_t HD44780_MAX_BURST = 128;
+
+// Encode HD44780 bytes into the PCF8574 byte stream, strobes included.
+// Pure function: no I/O. Returns bytes written to out (count * 4), or 0 if
+// outSize is too small.
+size_t hd44780Encode(const uint8_t *bytes, size_t count, bool isData, uint8_t backlight,
+                     uint8_t *out, size_t outSize);
+
+// HD44780 in 4-bit mode behind a PCF8574, written in whole-sequence bursts:
+// a cursor move plus a run of characters goes out as one I2C transaction
+// instead of one transaction per nibble and strobe.
+class HD44780Driver : public Print
+{
+private:
+    TwoWire &wire;
+    uint8_t address;
+    uint8_t cols;
+    uint8_t rows;
+    uint8_t backlightMask;
+
+    uint8_t burst[HD44780_MAX_BURST];
+    size_t burstLength;
+
+    unsigned long transactions;
+    unsigned long wireBytes;
+
+    void writeNibble(uint8_t nibble); // Init sequence only (8-bit mode)
+    void command(uint8_t value);
+    void append(const uint8_t *bytes, size_t count, bool isData);
+    void flushBurst();
+
+public:
+    HD44780Driver(uint8_t address, uint8_t cols, uint8_t rows, TwoWire &wire = Wire);
+
+    void init();
+    void clear();
+    void home();
+    void setCursor(uint8_t col, uint8_t row);
+    void backlight();
+    void noBacklight();
+
+    // Cursor move and characters in a single burst
+    void writeAt(uint8_t col, uint8_t row, const char *chars, size_t length);
+
+    size_t write(uint8_t value) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+    unsigned long getTransactions() const;
+    unsigned long getWireBytes() const;
+};
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef AXIS_PIPELINE_H
+#define AXIS_PIPELINE_H
+
+#include "config.h"
+#include "mapping_kernel.h"
+#include "input_stages.h"
+#include "noise_estimator.h"
+#include "glitch_filter.h"
+#include <stdlib.h>
+
+// Per-tick processing for Axes analog axes. Each stage is one loop over
+// all axes on plain int arrays indexed by axis (raw codes in, output units
+// out), so adding an axis lengthens the loops instead of adding code paths.
+// Stage order for one tick, as JoystickController::read() runs it:
+//   rejectGlitches -> map -> (drift update) -> trackNoise -> smooth -> applyDeadZone -> applyCurve
+// Smoothing, DeadZone and Curve are policy types (input_stages.h); the
+// defaults reproduce the original fixed path. Per-axis state (mapping
+// table, filters, noise window) lives in arrays of single-axis objects.
+template <int Axes, class Smoothing = DefaultSmoothing, class DeadZone = DefaultDeadZone, class Curve = DefaultCurve>
+class AxisPipeline
+{
+    static_assert(Axes > 0, "AxisPipeline needs at least one axis");
+
+private:
+    AxisMapper mappers[Axes];
+    GlitchFilter<GLITCH_MEDIAN_TAPS> glitch[Axes];
+    Smoothing smoothing[Axes];
+    DeadZone deadZones[Axes];
+    Curve curves[Axes];
+    NoiseEstimator<NOISE_WINDOW_SAMPLES> noise[Axes]; // ADC counts, at rest only
+    float noiseScale[Axes];                           // ADC counts to output units
+
+public:
+    AxisPipeline()
+    {
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            noiseScale[axis] = 0.0f;
+        }
+    }
+
+    // Each axis re-primes from its next sample
+    void reset()
+    {
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            glitch[axis].reset();
+            smoothing[axis].reset();
+        }
+    }
+
+    // False if any axis has an unusable range (it then maps to 0)
+    bool rebuild(const int *minVal, const int *maxVal, const int *centerVal)
+    {
+        bool ok = true;
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            ok = mappers[axis].build(minVal[axis], maxVal[axis], centerVal[axis]) && ok;
+
+            int span = maxVal[axis] - minVal[axis];
+            noiseScale[axis] = span > 0 ? (float)(MAX_OUTPUT - MIN_OUTPUT) / span : 0.0f;
+        }
+        return ok;
+    }
+
+    // Drops WiFi/PWM switching spikes, in place
+    void rejectGlitches(int *raw)
+    {
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            raw[axis] = glitch[axis].update(raw[axis]);
+        }
+    }
+
+    // Raw codes to MIN_OUTPUT..MAX_OUTPUT; true when every axis is in the
+    // dead zone
+    bool map(const int *raw, int *mapped) const
+    {
+        bool atRest = true;
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            mapped[axis] = mappers[axis].map(raw[axis]);
+            atRest = atRest && abs(mapped[axis]) < DEAD_ZONE_PERCENT;
+        }
+        return atRest;
+    }
+
+    // Tracks noise while an axis rests in the dead zone; adaptive filters
+    // retune from it, the others ignore it
+    void trackNoise(const int *raw, const int *mapped)
+    {
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            if (abs(mapped[axis]) >= DEAD_ZONE_PERCENT)
+                continue;
+
+            noise[axis].update((float)raw[axis]);
+            if (noise[axis].isValid())
+                smoothing[axis].setNoise(noise[axis].getStdDev() * noiseScale[axis]);
+        }
+    }
+
+    // O(1) per sample and axis; velocity in output units/s, 0 unless the
+    // smoothing policy estimates it
+    void smooth(const int *mapped, int *out, int *velocity)
+    {
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            out[axis] = smoothing[axis].update(mapped[axis]);
+            velocity[axis] = smoothing[axis].velocity();
+        }
+    }
+
+    // In place
+    void applyDeadZone(int *values) const
+    {
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            values[axis] = deadZones[axis].apply(values[axis]);
+        }
+    }
+
+    // In place
+    void applyCurve(int *values) const
+    {
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            values[axis] = curves[axis].apply(values[axis]);
+        }
+    }
+
+    float getNoise(int axis) const { return noise[axis].getStdDev(); }
+    float getFilterCutoff(int axis) const { return smoothing[axis].cutoffHz(); }
+
+    unsigned long getRejectedSamples() const
+    {
+        unsigned long total = 0;
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            total += glitch[axis].getRejected();
+        }
+        return total;
+    }
+
+    unsigned long getClippedSamples() const
+    {
+        unsigned long total = 0;
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            total += glitch[axis].getClipped();
+        }
+        return total;
+    }
+};
+
+#endif
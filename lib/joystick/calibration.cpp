@@ -0,0 +1,353 @@
+#include "calibration.h"
+
+CalibrationStateMachine::CalibrationStateMachine()
+{
+    state = CAL_IDLE;
+    stateStart = 0;
+    lastSampleTime = 0;
+    startTime = 0;
+    finishTime = 0;
+    centerAttempts = 0;
+    centerFallback = false;
+    lastGrowthTime = 0;
+    rangeSamples = 0;
+    rangeTimedOut = false;
+    verified = false;
+    verifyFailed = false;
+    resetAllStats();
+
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        result.min[axis] = ADC_MIN_VALUE;
+        result.max[axis] = ADC_MAX_VALUE;
+        result.center[axis] = ADC_DEFAULT_CENTER;
+    }
+    result.isCalibrated = false;
+}
+
+void CalibrationStateMachine::start(uint32_t nowMs)
+{
+    startTime = nowMs;
+    verifyFailed = false;
+    startFull(nowMs);
+}
+
+void CalibrationStateMachine::startVerify(uint32_t nowMs, const CalibrationData &stored)
+{
+    resetAllStats();
+    result = stored;
+    result.isCalibrated = false;
+    verified = false;
+    verifyFailed = false;
+    startTime = nowMs;
+    finishTime = nowMs;
+    lastSampleTime = nowMs;
+    enter(CAL_VERIFY, nowMs);
+}
+
+void CalibrationStateMachine::startFull(uint32_t nowMs)
+{
+    resetAllStats();
+    centerAttempts = 0;
+    centerFallback = false;
+    rangeSamples = 0;
+    rangeTimedOut = false;
+    verified = false;
+    result.isCalibrated = false;
+    finishTime = nowMs;
+    lastSampleTime = nowMs;
+    enter(CAL_CENTER_SETTLE, nowMs);
+}
+
+void CalibrationStateMachine::enter(CalibrationState next, uint32_t now)
+{
+    state = next;
+    stateStart = now;
+}
+
+CalibrationState CalibrationStateMachine::tick(uint32_t nowMs, const int *raw)
+{
+    bool valid = true;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        valid = valid && raw[axis] >= ADC_MIN_VALUE && raw[axis] <= ADC_MAX_VALUE;
+    }
+
+    switch (state)
+    {
+    case CAL_VERIFY:
+        tickVerify(nowMs, raw, valid);
+        break;
+
+    case CAL_CENTER_SETTLE:
+        if (nowMs - stateStart >= (uint32_t)CENTER_SETTLE_TIME)
+        {
+            enter(CAL_CENTER, nowMs);
+        }
+        break;
+
+    case CAL_CENTER:
+        tickCenter(nowMs, raw, valid);
+        break;
+
+    case CAL_RANGE_SETTLE:
+        if (nowMs - stateStart >= (uint32_t)RANGE_SETTLE_TIME)
+        {
+            lastGrowthTime = nowMs;
+            enter(CAL_RANGE, nowMs);
+        }
+        break;
+
+    case CAL_RANGE:
+        tickRange(nowMs, raw, valid);
+        break;
+
+    case CAL_IDLE:
+    case CAL_DONE:
+    default:
+        break;
+    }
+
+    return state;
+}
+
+void CalibrationStateMachine::tickVerify(uint32_t now, const int *raw, bool valid)
+{
+    if (valid)
+    {
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            addSample(stats[axis], raw[axis]);
+        }
+    }
+
+    if (now - stateStart < (uint32_t)CENTER_CHECK_TIME)
+        return;
+
+    bool ok = stats[0].count > 0;
+    for (int axis = 0; ok && axis < JOYSTICK_AXES; axis++)
+    {
+        int shift = (int)(stats[axis].sum / stats[axis].count) - result.center[axis];
+        ok = shift <= CENTER_CHECK_TOLERANCE && shift >= -CENTER_CHECK_TOLERANCE &&
+             getCenterNoise(axis) <= CENTER_CHECK_MAX_NOISE;
+    }
+
+    if (ok)
+    {
+        verified = true;
+        result.isCalibrated = true;
+        finishTime = now;
+        enter(CAL_DONE, now);
+    }
+    else
+    {
+        // Center moved, stick held off-center, or no samples: redo it all
+        verifyFailed = true;
+        startFull(now);
+    }
+}
+
+void CalibrationStateMachine::tickCenter(uint32_t now, const int *raw, bool valid)
+{
+    if (now - lastSampleTime < (uint32_t)CALIBRATION_DELAY)
+        return;
+    lastSampleTime = now;
+
+    centerAttempts++;
+    if (valid)
+    {
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            addSample(stats[axis], raw[axis]);
+        }
+    }
+
+    // Stop early once the mean is pinned down, at the latest after
+    // CALIBRATION_SAMPLES attempts
+    bool converged = stats[0].count >= CENTER_MIN_SAMPLES && centerConverged();
+    if (!converged && centerAttempts < CALIBRATION_SAMPLES)
+        return;
+
+    // Need at least 80% valid samples (frames are valid for all axes or none)
+    centerFallback = stats[0].count <= centerAttempts * 8 / 10;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        int center = centerFallback ? ADC_DEFAULT_CENTER : (int)(stats[axis].sum / stats[axis].count);
+        result.center[axis] = center;
+        result.min[axis] = center;
+        result.max[axis] = center;
+    }
+
+    enter(CAL_RANGE_SETTLE, now);
+}
+
+bool CalibrationStateMachine::centerConverged() const
+{
+    // Standard error of the mean below CENTER_CONVERGED_ERROR counts:
+    // var / n < e^2  <=>  var * n^2 < e^2 * n^3
+    long long n = stats[0].count;
+    long long limit = (long long)CENTER_CONVERGED_ERROR * CENTER_CONVERGED_ERROR * n * n * n;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        if (varianceTimesCountSq(stats[axis]) >= limit)
+            return false;
+    }
+    return true;
+}
+
+void CalibrationStateMachine::tickRange(uint32_t now, const int *raw, bool valid)
+{
+    if (valid)
+    {
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            // Only growth beyond the threshold counts as "still expanding",
+            // so ADC noise at an extreme does not keep the phase alive
+            int value = raw[axis];
+            if (value < result.min[axis] - RANGE_GROWTH_THRESHOLD || value > result.max[axis] + RANGE_GROWTH_THRESHOLD)
+            {
+                lastGrowthTime = now;
+            }
+
+            if (value < result.min[axis])
+                result.min[axis] = value;
+            if (value > result.max[axis])
+                result.max[axis] = value;
+        }
+
+        rangeSamples++;
+    }
+
+    int minExpectedRange = ADC_MAX_VALUE / 4; // Expect at least 25% of full range
+    bool coverage = true;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        coverage = coverage && (result.max[axis] - result.min[axis]) >= minExpectedRange;
+    }
+    bool stable = now - lastGrowthTime >= (uint32_t)RANGE_STABLE_TIME;
+    bool timedOut = now - stateStart >= (uint32_t)RANGE_CALIBRATION_TIME;
+
+    if ((coverage && stable) || timedOut)
+    {
+        rangeTimedOut = !(coverage && stable);
+        result.isCalibrated = true;
+        finishTime = now;
+        enter(CAL_DONE, now);
+    }
+}
+
+void CalibrationStateMachine::resetAllStats()
+{
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        resetStats(stats[axis]);
+    }
+}
+
+void CalibrationStateMachine::resetStats(CenterStats &stats)
+{
+    stats.count = 0;
+    stats.sum = 0;
+    stats.sumSquares = 0;
+    stats.min = ADC_MAX_VALUE;
+    stats.max = ADC_MIN_VALUE;
+}
+
+void CalibrationStateMachine::addSample(CenterStats &stats, int value)
+{
+    stats.count++;
+    stats.sum += value;
+    stats.sumSquares += (long long)value * value;
+    if (value < stats.min)
+        stats.min = value;
+    if (value > stats.max)
+        stats.max = value;
+}
+
+long long CalibrationStateMachine::varianceTimesCountSq(const CenterStats &stats)
+{
+    // n^2 * var = n * sum(x^2) - (sum x)^2
+    return stats.count * stats.sumSquares - stats.sum * stats.sum;
+}
+
+CalibrationState CalibrationStateMachine::getState() const
+{
+    return state;
+}
+
+bool CalibrationStateMachine::isActive() const
+{
+    return state != CAL_IDLE && state != CAL_DONE;
+}
+
+bool CalibrationStateMachine::isDone() const
+{
+    return state == CAL_DONE;
+}
+
+const CalibrationData &CalibrationStateMachine::getResult() const
+{
+    return result;
+}
+
+uint32_t CalibrationStateMachine::getElapsed() const
+{
+    return finishTime - startTime;
+}
+
+int CalibrationStateMachine::getCenterSamples() const
+{
+    return (int)stats[0].count;
+}
+
+int CalibrationStateMachine::getCenterNoise(int axis) const
+{
+    return stats[axis].count > 0 ? stats[axis].max - stats[axis].min : 0;
+}
+
+bool CalibrationStateMachine::usedDefaultCenter() const
+{
+    return centerFallback;
+}
+
+int CalibrationStateMachine::getRangeSamples() const
+{
+    return rangeSamples;
+}
+
+bool CalibrationStateMachine::wasVerified() const
+{
+    return verified;
+}
+
+bool CalibrationStateMachine::verificationFailed() const
+{
+    return verifyFailed;
+}
+
+bool CalibrationStateMachine::endedOnTimeout() const
+{
+    return rangeTimedOut;
+}
+
+const char *CalibrationStateMachine::stateName(CalibrationState state)
+{
+    switch (state)
+    {
+    case CAL_VERIFY:
+        return "Checking center";
+    case CAL_CENTER_SETTLE:
+        return "Release stick";
+    case CAL_CENTER:
+        return "Keep centered";
+    case CAL_RANGE_SETTLE:
+        return "Get ready";
+    case CAL_RANGE:
+        return "Move Joystick";
+    case CAL_DONE:
+        return "Success!";
+    case CAL_IDLE:
+    default:
+        return "Idle";
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include "config.h"
+#include <stdint.h>
+
+// Per-axis calibration, one array per field
+struct CalibrationData
+{
+    int min[JOYSTICK_AXES];
+    int max[JOYSTICK_AXES];
+    int center[JOYSTICK_AXES];
+    bool isCalibrated;
+};
+
+enum CalibrationState
+{
+    CAL_IDLE = 0,
+    CAL_VERIFY,        // Checking a stored calibration against the rest position
+    CAL_CENTER_SETTLE, // Waiting for the stick to be released
+    CAL_CENTER,        // Averaging the rest position
+    CAL_RANGE_SETTLE,  // Prompting the user to move the stick
+    CAL_RANGE,         // Tracking extremes
+    CAL_DONE
+};
+
+// Per-axis running statistics for center calibration (integer, exact)
+struct CenterStats
+{
+    long count;
+    long long sum;
+    long long sumSquares;
+    int min;
+    int max;
+};
+
+// Calibration as a state machine: tick() takes one sample and returns
+// immediately, so the LCD and control loop keep running while it works.
+// Time comes in through tick(), so it runs on a simulated clock and a
+// recorded ADC trace on the host.
+class CalibrationStateMachine
+{
+private:
+    CalibrationState state;
+    uint32_t stateStart;
+    uint32_t lastSampleTime;
+    uint32_t startTime;
+    uint32_t finishTime;
+
+    // Center phase
+    CenterStats stats[JOYSTICK_AXES];
+    int centerAttempts;
+    bool centerFallback;
+
+    // Range phase
+    uint32_t lastGrowthTime;
+    int rangeSamples;
+    bool rangeTimedOut;
+
+    // Stored calibration check
+    bool verified;
+    bool verifyFailed;
+
+    CalibrationData result;
+
+    void enter(CalibrationState next, uint32_t now);
+    void startFull(uint32_t now);
+    void tickVerify(uint32_t now, const int *raw, bool valid);
+    void tickCenter(uint32_t now, const int *raw, bool valid);
+    void tickRange(uint32_t now, const int *raw, bool valid);
+    bool centerConverged() const;
+    void resetAllStats();
+    static void resetStats(CenterStats &stats);
+    static void addSample(CenterStats &stats, int value);
+    static long long varianceTimesCountSq(const CenterStats &stats);
+
+public:
+    CalibrationStateMachine();
+
+    void start(uint32_t nowMs);
+    // Warm boot: accept stored data after a short center check, otherwise
+    // fall through to a full calibration
+    void startVerify(uint32_t nowMs, const CalibrationData &stored);
+    // One sample per axis; values outside the ADC range mark a missing frame
+    CalibrationState tick(uint32_t nowMs, const int *raw);
+
+    CalibrationState getState() const;
+    bool isActive() const;
+    bool isDone() const;
+    const CalibrationData &getResult() const;
+    uint32_t getElapsed() const; // Start to done, ms
+
+    // Diagnostics
+    int getCenterSamples() const;
+    int getCenterNoise(int axis) const; // Peak-to-peak at rest
+    bool usedDefaultCenter() const;
+    int getRangeSamples() const;
+    bool wasVerified() const;     // Finished by accepting stored data
+    bool verificationFailed() const; // Stored data was rejected
+    bool endedOnTimeout() const; // Range phase hit RANGE_CALIBRATION_TIME before settling
+
+    static const char *stateName(CalibrationState state);
+};
+
+#endif
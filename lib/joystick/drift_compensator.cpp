@@ -0,0 +1,133 @@
+#include "drift_compensator.h"
+#include <stdlib.h>
+
+DriftCompensator::DriftCompensator()
+    : base(), centerQ16(), beyondCount(), beyondMildest(), beyondSide(), restStart(0), lastRebuild(0), widenings(0),
+      resting(false), pending(false), active(false)
+{
+}
+
+void DriftCompensator::begin(const CalibrationData &calibration)
+{
+    base = calibration;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        centerQ16[axis] = (int32_t)calibration.center[axis] << 16;
+        beyondCount[axis] = 0;
+        beyondSide[axis] = 0;
+    }
+    resting = false;
+    pending = false;
+    active = calibration.isCalibrated;
+}
+
+void DriftCompensator::stop()
+{
+    active = false;
+}
+
+bool DriftCompensator::update(unsigned long nowMs, const int *raw, bool atRest, CalibrationData &calibration)
+{
+    if (!active)
+        return false;
+
+    // Readings that stay past the calibrated extremes become the new extreme
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        if (widen(axis, raw[axis], calibration.min[axis], calibration.max[axis]))
+            pending = true;
+    }
+
+    // Centers only follow after a continuous rest period
+    if (!atRest)
+    {
+        resting = false;
+    }
+    else if (!resting)
+    {
+        resting = true;
+        restStart = nowMs;
+    }
+    else if (nowMs - restStart >= (unsigned long)DRIFT_REST_TIME)
+    {
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            if (followCenter(centerQ16[axis], raw[axis], base.center[axis], calibration.min[axis],
+                             calibration.max[axis], calibration.center[axis]))
+                pending = true;
+        }
+    }
+
+    if (pending && nowMs - lastRebuild >= (unsigned long)DRIFT_REBUILD_INTERVAL)
+    {
+        pending = false;
+        lastRebuild = nowMs;
+        return true;
+    }
+    return false;
+}
+
+bool DriftCompensator::followCenter(int32_t &centerQ16, int raw, int baseCenter, int minVal, int maxVal, int &center)
+{
+    int32_t target = (int32_t)raw << 16;
+    centerQ16 += (target - centerQ16) / (1 << DRIFT_EMA_SHIFT);
+
+    // Bounded correction, and the center must stay inside the range
+    int32_t low = (int32_t)(baseCenter - DRIFT_MAX_CORRECTION) << 16;
+    int32_t high = (int32_t)(baseCenter + DRIFT_MAX_CORRECTION) << 16;
+    if (centerQ16 < low)
+        centerQ16 = low;
+    if (centerQ16 > high)
+        centerQ16 = high;
+
+    int rounded = (int)((centerQ16 + 0x8000) >> 16);
+    if (rounded <= minVal)
+        rounded = minVal + 1;
+    if (rounded >= maxVal)
+        rounded = maxVal - 1;
+
+    if (rounded == center)
+        return false;
+    center = rounded;
+    return true;
+}
+
+bool DriftCompensator::widen(int axis, int raw, int &minVal, int &maxVal)
+{
+    int8_t side = raw < minVal ? -1 : (raw > maxVal ? 1 : 0);
+    if (side == 0 || side != beyondSide[axis])
+    {
+        // Inside the range, or the streak switched sides: start over
+        beyondSide[axis] = side;
+        beyondCount[axis] = side != 0 ? 1 : 0;
+        beyondMildest[axis] = raw;
+    }
+    else
+    {
+        beyondCount[axis]++;
+        if ((side < 0 && raw > beyondMildest[axis]) || (side > 0 && raw < beyondMildest[axis]))
+            beyondMildest[axis] = raw;
+    }
+
+    if (beyondCount[axis] < DRIFT_WIDEN_SAMPLES)
+        return false;
+
+    if (side < 0)
+        minVal = beyondMildest[axis];
+    else
+        maxVal = beyondMildest[axis];
+    beyondSide[axis] = 0;
+    beyondCount[axis] = 0;
+    widenings++;
+    return true;
+}
+
+int DriftCompensator::getDrift(int axis) const
+{
+    return (int)((centerQ16[axis] + 0x8000) >> 16) - base.center[axis];
+}
+
+unsigned long DriftCompensator::getWidenings() const
+{
+    return widenings;
+}
@@ -0,0 +1,48 @@
+#ifndef DRIFT_COMPENSATOR_H
+#define DRIFT_COMPENSATOR_H
+
+#include "config.h"
+#include "calibration.h"
+#include <stdint.h>
+
+// Background recalibration while the controller runs. After the stick has
+// rested in the dead zone for DRIFT_REST_TIME, each center follows the raw
+// reading through a slow fixed-point EMA, bounded to DRIFT_MAX_CORRECTION
+// counts from the calibrated value. Readings that stay beyond the
+// calibrated range for DRIFT_WIDEN_SAMPLES in a row widen it, to the
+// mildest of those readings, so a lone spike never does. Works in place
+// on the caller's CalibrationData, no allocation; time comes in through
+// update() like CalibrationStateMachine.
+class DriftCompensator
+{
+private:
+    CalibrationData base; // As calibrated
+    int32_t centerQ16[JOYSTICK_AXES];
+    int beyondCount[JOYSTICK_AXES];   // Consecutive readings past one extreme
+    int beyondMildest[JOYSTICK_AXES]; // Of those, the one closest to the range
+    int8_t beyondSide[JOYSTICK_AXES]; // -1 below min, +1 above max, 0 inside
+    unsigned long restStart;
+    unsigned long lastRebuild;
+    unsigned long widenings;
+    bool resting;
+    bool pending; // Calibration changed since the last rebuild
+    bool active;
+
+    bool followCenter(int32_t &centerQ16, int raw, int baseCenter, int minVal, int maxVal, int &center);
+    bool widen(int axis, int raw, int &minVal, int &maxVal);
+
+public:
+    DriftCompensator();
+
+    void begin(const CalibrationData &calibration);
+    void stop();
+
+    // Returns true when calibration changed and the mapping should be
+    // rebuilt (at most once per DRIFT_REBUILD_INTERVAL)
+    bool update(unsigned long nowMs, const int *raw, bool atRest, CalibrationData &calibration);
+
+    int getDrift(int axis) const; // Current center minus calibrated center
+    unsigned long getWidenings() const;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef INPUT_STAGES_H
+#define INPUT_STAGES_H
+
+#include "config.h"
+#include "filters.h"
+#include <stdlib.h>
+#include <type_traits>
+
+// Stage policies for AxisPipeline. Each axis owns one instance of each
+// stage; the pipeline is composed from these types at compile time, so
+// every call below inlines and there is no per-sample dispatch.
+//
+// Smoothing:  int update(int), void reset(), void setNoise(float sd),
+//             float cutoffHz() const, int velocity() const
+// Dead zone:  int apply(int) const
+// Curve:      int apply(int) const   (MIN_OUTPUT..MAX_OUTPUT in and out)
+
+// Any filter from filters.h; no velocity estimate
+template <class Filter>
+class FilterSmoothing : public Filter
+{
+public:
+    int velocity() const { return 0; }
+};
+
+// Alpha-beta tracker: lag-compensated position kept inside the output
+// range, plus velocity in output units per second
+class TrackerSmoothing
+{
+private:
+    AlphaBetaTracker tracker;
+
+public:
+    void reset() { tracker.reset(); }
+
+    int update(int sample)
+    {
+        int value = tracker.update(sample);
+        return value < MIN_OUTPUT ? MIN_OUTPUT : (value > MAX_OUTPUT ? MAX_OUTPUT : value);
+    }
+
+    void setNoise(float) {}
+    float cutoffHz() const { return 0.0f; } // Not a fixed low-pass
+    int velocity() const { return (int)tracker.getVelocity(); }
+};
+
+// Values inside the band read as zero, the rest pass unchanged
+template <int Width>
+class AxisDeadZone
+{
+public:
+    int apply(int value) const { return abs(value) < Width ? 0 : value; }
+};
+
+// As AxisDeadZone, but the remaining travel is stretched back to full
+// scale so the output starts from zero at the edge of the band
+template <int Width>
+class ScaledDeadZone
+{
+    static_assert(Width >= 0 && Width < MAX_OUTPUT, "Dead zone must be narrower than the output range");
+
+public:
+    int apply(int value) const
+    {
+        int magnitude = abs(value);
+        if (magnitude < Width)
+            return 0;
+        int scaled = (magnitude - Width) * MAX_OUTPUT / (MAX_OUTPUT - Width);
+        return value < 0 ? -scaled : scaled;
+    }
+};
+
+class NoDeadZone
+{
+public:
+    int apply(int value) const { return value; }
+};
+
+class LinearCurve
+{
+public:
+    int apply(int value) const { return value; }
+};
+
+// Blend of linear and cubic response: Percent = 0 is linear, 100 fully
+// cubic (finer control around the center, same end points)
+template <int Percent>
+class ExpoCurve
+{
+    static_assert(Percent >= 0 && Percent <= 100, "Expo must be 0-100%");
+
+public:
+    int apply(int value) const
+    {
+        long long cubic = (long long)value * value * value / ((long long)MAX_OUTPUT * MAX_OUTPUT);
+        return value + (int)((cubic - value) * Percent / 100);
+    }
+};
+
+// Default composition: the original read() path (filter selected by
+// FILTER_TYPE or the tracker, DEAD_ZONE_PERCENT hard cut, linear response)
+typedef std::conditional<TRACKER_ENABLED, TrackerSmoothing, FilterSmoothing<AxisFilter> >::type DefaultSmoothing;
+typedef AxisDeadZone<DEAD_ZONE_PERCENT> DefaultDeadZone;
+typedef LinearCurve DefaultCurve;
+
+#endif
@@ -1,31 +1,102 @@
 #include "joystick.h"
+#include "esp32_adc_source.h"
+#include "esp32_adc_calibration.h"
+#include "profiler.h"
+#include "logger.h"
 #include <Arduino.h>
 
+static_assert(ADC_OVERSAMPLE_FRAMES <= ADC_RING_FRAMES, "Oversampling needs more frames than the sampler keeps");
+
+#ifdef ESP32
+// Default hardware backend: ADC1 DMA scan over all axis pins
+static Esp32ContinuousAdcSource continuousSource(AXIS_PINS, JOYSTICK_AXES, ADC_SAMPLE_RATE_HZ, ADC_ATTENUATION,
+                                                 ADC_FRAMES_PER_TICK);
+
+// Default calibration storage: NVS namespace "joystick"
+static PreferencesCalibrationStorage nvsStorage("joystick", "cal");
+
+// Default linearity correction: ADC1 eFuse characterization
+static Esp32AdcCalibration efuseCalibration;
+#endif
+
 JoystickController::JoystickController()
 {
     // Initialize calibration data with ESP32 12-bit defaults
-    calibration.xMin = ADC_MIN_VALUE;
-    calibration.xMax = ADC_MAX_VALUE;
-    calibration.xCenter = ADC_DEFAULT_CENTER;
-    calibration.yMin = ADC_MIN_VALUE;
-    calibration.yMax = ADC_MAX_VALUE;
-    calibration.yCenter = ADC_DEFAULT_CENTER;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        calibration.min[axis] = ADC_MIN_VALUE;
+        calibration.max[axis] = ADC_MAX_VALUE;
+        calibration.center[axis] = ADC_DEFAULT_CENTER;
+        lastRaw[axis] = 0;
+        lastSample[axis] = 0;
+    }
+    haveSample = false;
+    staleTicks = 0;
     calibration.isCalibrated = false;
 
+    adcSource = nullptr;
+    clock = nullptr;
+    clockLastUs = 0;
+    clockMs = 0;
+    clockRemainderUs = 0;
+    adcTransfer = nullptr;
+    adcTransferContext = nullptr;
+    adcTransferName = "off";
+    calibrationStorage = nullptr;
+    storedStatus = RECORD_MISSING;
+    storedCalibrationMs = 0;
+
     // Initialize filter
-    filterIndex = 0;
-    filterInitialized = false;
     initializeFilter();
 }
 
 void JoystickController::initializeFilter()
 {
-    for (int i = 0; i < FILTER_SAMPLES; i++)
+    // Each axis re-primes from its next sample
+    pipeline.reset();
+}
+
+void JoystickController::setAdcSource(AdcSource *source)
+{
+    adcSource = source;
+}
+
+void JoystickController::setCalibrationStorage(CalibrationStorage *storage)
+{
+    calibrationStorage = storage;
+}
+
+void JoystickController::setClock(SchedulerClock *newClock)
+{
+    clock = newClock;
+    if (clock != nullptr)
     {
-        xHistory[i] = 0;
-        yHistory[i] = 0;
+        clockLastUs = clock->nowMicros();
+        clockMs = 0;
+        clockRemainderUs = 0;
     }
-    filterInitialized = false;
+}
+
+// Milliseconds from the clock's microseconds, accumulated so the count
+// keeps running past the 32-bit microsecond wrap
+uint32_t JoystickController::nowMs()
+{
+    if (clock == nullptr)
+        return millis();
+
+    uint32_t us = clock->nowMicros();
+    clockRemainderUs += us - clockLastUs;
+    clockLastUs = us;
+    clockMs += clockRemainderUs / 1000;
+    clockRemainderUs %= 1000;
+    return clockMs;
+}
+
+void JoystickController::setAdcTransfer(AdcTransferFn transfer, void *context)
+{
+    adcTransfer = transfer;
+    adcTransferContext = context;
+    adcTransferName = "custom";
 }
 
 void JoystickController::begin()
@@ -35,12 +106,14 @@ void JoystickController::begin()
     // Configure ESP32 ADC
     analogReadResolution(ADC_RESOLUTION); // Set to 12-bit resolution
 
-    // Set ADC attenuation for both channels
+    // Set ADC attenuation for all channels
     analogSetAttenuation((adc_attenuation_t)ADC_ATTENUATION);
 
     // ESP32-specific: Set pin-specific attenuation if needed
-    analogSetPinAttenuation(X_PIN, (adc_attenuation_t)ADC_ATTENUATION);
-    analogSetPinAttenuation(Y_PIN, (adc_attenuation_t)ADC_ATTENUATION);
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        analogSetPinAttenuation(AXIS_PINS[axis], (adc_attenuation_t)ADC_ATTENUATION);
+    }
 
     Serial.println("=== ESP32 Joystick Controller ===");
     Serial.print("ADC Resolution: ");
@@ -50,201 +123,284 @@ void JoystickController::begin()
     Serial.println(")");
     Serial.print("ADC Attenuation: ");
     Serial.println(ADC_ATTENUATION);
-    Serial.print("X Pin: GPIO");
-    Serial.println(X_PIN);
-    Serial.print("Y Pin: GPIO");
-    Serial.println(Y_PIN);
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        Serial.print(AXIS_NAMES[axis]);
+        Serial.print(" Pin: GPIO");
+        Serial.println(AXIS_PINS[axis]);
+    }
+
+#ifdef ESP32
+    if (adcSource == nullptr && ADC_CONTINUOUS_MODE)
+    {
+        adcSource = &continuousSource;
+    }
+    if (calibrationStorage == nullptr && CALIBRATION_PERSIST)
+    {
+        calibrationStorage = &nvsStorage;
+    }
+    if (adcTransfer == nullptr && ADC_LINEARITY_CORRECTION &&
+        efuseCalibration.begin(ADC_ATTENUATION, ADC_DEFAULT_VREF_MV))
+    {
+        adcTransfer = Esp32AdcCalibration::transfer;
+        adcTransferContext = &efuseCalibration;
+        adcTransferName = efuseCalibration.getSource();
+    }
+#endif
+
+    if (adcTransfer != nullptr && linearizer.build(adcTransfer, adcTransferContext))
+    {
+        Serial.print("ADC Correction: ");
+        Serial.print(adcTransferName);
+        Serial.print(", ");
+        Serial.print(linearizer.toMillivolts(0));
+        Serial.print("-");
+        Serial.print(linearizer.toMillivolts(ADC_MAX_VALUE));
+        Serial.print(" mV (");
+        Serial.print(linearizer.getRepairs());
+        Serial.println(" codes made monotonic)");
+    }
+    else
+    {
+        Serial.println("ADC Correction: off");
+    }
+
+    haveSample = false;
+    staleTicks = 0;
+    if (adcSource != nullptr && sampler.begin(adcSource))
+    {
+        Serial.print("ADC Mode: continuous @ ");
+        Serial.print(ADC_SAMPLE_RATE_HZ);
+        Serial.println(" Hz");
+    }
+    else
+    {
+        Serial.println("ADC Mode: analogRead");
+    }
     Serial.println("================================");
 
     // Perform initial ADC readings to stabilize
     for (int i = 0; i < 10; i++)
     {
-        analogRead(X_PIN);
-        analogRead(Y_PIN);
+        int raw[JOYSTICK_AXES];
+        sampleRaw(raw);
         delay(10);
     }
 }
 
-void JoystickController::calibrate_center()
+bool JoystickController::sampleRaw(int *raw)
 {
-    Serial.println("=== JOYSTICK CALIBRATION ===");
-    Serial.println("1. Keep joystick centered...");
-    Serial.println("Starting in 3 seconds...");
-    delay(3000);
-
-    // Find center position with better error handling
-    long xSum = 0, ySum = 0;
-    int validSamples = 0;
-    int xMin = ADC_MAX_VALUE, xMax = ADC_MIN_VALUE;
-    int yMin = ADC_MAX_VALUE, yMax = ADC_MIN_VALUE;
+    PROFILE_SCOPE(PROFILE_SAMPLE);
 
-    Serial.println("Reading center position...");
-    for (int i = 0; i < CALIBRATION_SAMPLES; i++)
+    if (sampler.isRunning())
     {
-        // Small delay for ADC stabilization
-        delay(ESP32_ADC_STABILIZATION_DELAY);
-
-        int x = analogRead(X_PIN);
-        delay(ESP32_ADC_STABILIZATION_DELAY);
-        int y = analogRead(Y_PIN);
+        // Decimate the frames that arrived since the last read, never wait
+        // for a conversion. No new frame: repeat the previous reading.
+        sampler.poll();
 
-        // Validate readings (ESP32 ADC range)
-        if (x >= ADC_MIN_VALUE && x <= ADC_MAX_VALUE &&
-            y >= ADC_MIN_VALUE && y <= ADC_MAX_VALUE)
+        uint32_t sums[JOYSTICK_AXES];
+        size_t frames = sampler.sumNew(ADC_OVERSAMPLE_FRAMES, sums);
+        if (frames == 0)
         {
-            xSum += x;
-            ySum += y;
-            validSamples++;
-
-            // Track variation during center calibration
-            if (x < xMin)
-                xMin = x;
-            if (x > xMax)
-                xMax = x;
-            if (y < yMin)
-                yMin = y;
-            if (y > yMax)
-                yMax = y;
+            staleTicks++;
+            if (!haveSample)
+                return false;
+            for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+            {
+                raw[axis] = lastSample[axis];
+            }
+            return true;
         }
 
-        // Progress indicator
-        if (i % 20 == 0)
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
         {
-            Serial.print("Progress: ");
-            Serial.print((i * 100) / CALIBRATION_SAMPLES);
-            Serial.print("% - Current: X=");
-            Serial.print(x);
-            Serial.print(" Y=");
-            Serial.println(y);
+            raw[axis] = correctCode(decimate(sums[axis], frames, ADC_OVERSAMPLE_BITS), ADC_OVERSAMPLE_BITS);
+            lastSample[axis] = raw[axis];
         }
-
-        delay(CALIBRATION_DELAY);
+        haveSample = true;
+        return true;
     }
 
-    if (validSamples > CALIBRATION_SAMPLES * 0.8) // Need at least 80% valid samples
+    // Fallback: sequential single conversions
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
     {
-        calibration.xCenter = xSum / validSamples;
-        calibration.yCenter = ySum / validSamples;
+        delay(ESP32_ADC_STABILIZATION_DELAY);
+        raw[axis] = correctCode(analogRead(AXIS_PINS[axis]), 0);
+    }
+    return true;
+}
 
-        Serial.println("Center calibration successful!");
-        Serial.print("X Center: ");
-        Serial.print(calibration.xCenter);
-        Serial.print(" (variation: ");
-        Serial.print(xMax - xMin);
-        Serial.println(")");
-        Serial.print("Y Center: ");
-        Serial.print(calibration.yCenter);
-        Serial.print(" (variation: ");
-        Serial.print(yMax - yMin);
-        Serial.println(")");
+int JoystickController::correctCode(uint32_t value, int fracBits) const
+{
+    // Corrected and decimated values both land back on the 12-bit scale
+    if (linearizer.isReady())
+        return linearizer.toCode(value, fracBits);
+    return (int)((value + ((1u << fracBits) >> 1)) >> fracBits);
+}
 
-        // Check if joystick is too noisy
-        if ((xMax - xMin) > 200 || (yMax - yMin) > 200)
-        {
-            Serial.println("WARNING: High noise detected during center calibration!");
-            Serial.println("Consider using a more stable power supply or better connections.");
-        }
+void JoystickController::startCalibration(bool forceFull)
+{
+    calibration.isCalibrated = false;
+    driftCompensator.stop();
+    storedStatus = RECORD_MISSING;
+    storedCalibrationMs = 0;
+
+    StoredCalibration stored;
+    if (!forceFull && calibrationStorage != nullptr)
+    {
+        storedStatus = loadCalibration(*calibrationStorage, stored);
+    }
+
+    if (storedStatus == RECORD_OK)
+    {
+        storedCalibrationMs = stored.calibrationMs;
+        calibrator.startVerify(nowMs(), stored.data);
     }
     else
     {
-        Serial.println("ERROR: Center calibration failed - too few valid samples!");
-        Serial.print("Valid samples: ");
-        Serial.print(validSamples);
-        Serial.print(" out of ");
-        Serial.println(CALIBRATION_SAMPLES);
-
-        // Use default center values
-        calibration.xCenter = ADC_DEFAULT_CENTER;
-        calibration.yCenter = ADC_DEFAULT_CENTER;
-        Serial.println("Using default center values.");
+        calibrator.start(nowMs());
     }
 }
 
-void JoystickController::calibrate_range()
+bool JoystickController::saveCalibration(const CalibrationReport &report)
+{
+    // A timed-out range phase may not have seen the full travel
+    if (calibrationStorage == nullptr || !report.data.isCalibrated || report.timedOut)
+        return false;
+
+    StoredCalibration stored;
+    stored.data = report.data;
+    stored.calibrationMs = report.elapsedMs;
+    return ::saveCalibration(*calibrationStorage, stored);
+}
+
+CalibrationState JoystickController::updateCalibration()
 {
-    Serial.println("2. Move joystick to ALL extremes (circles and corners)...");
-    Serial.println("Starting in 3 seconds...");
-    delay(3000);
+    if (!calibrator.isActive())
+        return calibrator.getState();
+
+    // Missing frames stay at -1 and are rejected by the state machine
+    int raw[JOYSTICK_AXES];
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        raw[axis] = -1;
+    }
+    sampleRaw(raw);
 
-    // Initialize min/max values with center values
-    calibration.xMin = calibration.xCenter;
-    calibration.xMax = calibration.xCenter;
-    calibration.yMin = calibration.yCenter;
-    calibration.yMax = calibration.yCenter;
+    if (calibrator.tick(nowMs(), raw) == CAL_DONE)
+    {
+        calibration = calibrator.getResult();
+        rebuildMapping();
+        driftCompensator.begin(calibration);
 
-    unsigned long startTime = millis();
-    int sampleCount = 0;
-    int progressStep = RANGE_CALIBRATION_TIME / 10; // 10% increments
-    unsigned long nextProgressTime = startTime + progressStep;
+        // Initialize filter with the new calibration
+        initializeFilter();
+    }
 
-    Serial.println("Move joystick to all corners and edges NOW!");
+    return calibrator.getState();
+}
 
-    while (millis() - startTime < RANGE_CALIBRATION_TIME)
+CalibrationState JoystickController::getCalibrationState() const
+{
+    return calibrator.getState();
+}
+
+bool JoystickController::isCalibrating() const
+{
+    return calibrator.isActive();
+}
+
+void JoystickController::getCalibrationReport(CalibrationReport &report) const
+{
+    report.data = calibration;
+    report.storedStatus = storedStatus;
+    report.elapsedMs = calibrator.getElapsed();
+    report.storedCalibrationMs = storedCalibrationMs;
+    report.verified = calibrator.wasVerified();
+    report.bootTimeSavedMs = (report.verified && storedCalibrationMs >= report.elapsedMs)
+                                 ? storedCalibrationMs - report.elapsedMs
+                                 : 0;
+    report.centerSamples = calibrator.getCenterSamples();
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
     {
-        delay(ESP32_ADC_STABILIZATION_DELAY);
-        int x = analogRead(X_PIN);
-        delay(ESP32_ADC_STABILIZATION_DELAY);
-        int y = analogRead(Y_PIN);
+        report.centerNoise[axis] = calibrator.getCenterNoise(axis);
+    }
+    report.rangeSamples = calibrator.getRangeSamples();
+    report.verifyFailed = calibrator.verificationFailed();
+    report.defaultCenter = calibrator.usedDefaultCenter();
+    report.timedOut = calibrator.endedOnTimeout();
+}
 
-        // Validate readings
-        if (x >= ADC_MIN_VALUE && x <= ADC_MAX_VALUE &&
-            y >= ADC_MIN_VALUE && y <= ADC_MAX_VALUE)
+void JoystickController::printCalibrationReport(const CalibrationReport &report)
+{
+    Serial.println("=== JOYSTICK CALIBRATION ===");
+
+    if (report.verified)
+    {
+        Serial.print("Stored calibration verified in ");
+        Serial.print(report.elapsedMs);
+        Serial.print(" ms (full calibration took ");
+        Serial.print(report.storedCalibrationMs);
+        Serial.println(" ms)");
+        printCalibrationData(report.data);
+        return;
+    }
+
+    if (report.verifyFailed)
+    {
+        Serial.println("Stored calibration failed the center check - recalibrated.");
+    }
+    else if (report.storedStatus != RECORD_OK && report.storedStatus != RECORD_MISSING)
+    {
+        Serial.print("Stored calibration rejected: ");
+        Serial.println(calibrationRecordStatusName(report.storedStatus));
+    }
+
+    if (report.defaultCenter)
+    {
+        Serial.println("ERROR: Center calibration failed - too few valid samples!");
+        Serial.println("Using default center values.");
+    }
+    else
+    {
+        Serial.print("Center calibration successful! Samples: ");
+        Serial.println(report.centerSamples);
+
+        bool noisy = false;
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
         {
-            // Update min/max values
-            if (x < calibration.xMin)
-                calibration.xMin = x;
-            if (x > calibration.xMax)
-                calibration.xMax = x;
-            if (y < calibration.yMin)
-                calibration.yMin = y;
-            if (y > calibration.yMax)
-                calibration.yMax = y;
-
-            sampleCount++;
+            Serial.print(AXIS_NAMES[axis]);
+            Serial.print(" Center: ");
+            Serial.print(report.data.center[axis]);
+            Serial.print(" (variation: ");
+            Serial.print(report.centerNoise[axis]);
+            Serial.println(")");
+            noisy = noisy || report.centerNoise[axis] > 200;
         }
 
-        // Progress indicator
-        unsigned long currentTime = millis();
-        if (currentTime >= nextProgressTime)
+        // Check if joystick is too noisy
+        if (noisy)
         {
-            int progress = ((currentTime - startTime) * 100) / RANGE_CALIBRATION_TIME;
-            Serial.print("Progress: ");
-            Serial.print(progress);
-            Serial.print("% - Current ranges X: ");
-            Serial.print(calibration.xMin);
-            Serial.print("-");
-            Serial.print(calibration.xMax);
-            Serial.print(" Y: ");
-            Serial.print(calibration.yMin);
-            Serial.print("-");
-            Serial.println(calibration.yMax);
-            nextProgressTime += progressStep;
+            Serial.println("WARNING: High noise detected during center calibration!");
+            Serial.println("Consider using a more stable power supply or better connections.");
         }
-
-        delay(20); // Reasonable sampling rate
     }
 
-    // Validate calibration ranges
-    int xRange = calibration.xMax - calibration.xMin;
-    int yRange = calibration.yMax - calibration.yMin;
-
     Serial.print("Range calibration complete. Samples: ");
-    Serial.println(sampleCount);
+    Serial.println(report.rangeSamples);
 
-    // ESP32 should achieve much larger ranges due to 12-bit precision
-    int minExpectedRange = ADC_MAX_VALUE / 4; // Expect at least 25% of full range
-
-    if (xRange < minExpectedRange || yRange < minExpectedRange)
+    if (report.timedOut)
     {
+        int minExpectedRange = ADC_MAX_VALUE / 4;
         Serial.println("WARNING: Calibration range seems too small!");
-        Serial.print("X Range: ");
-        Serial.print(xRange);
-        Serial.print(" (expected > ");
-        Serial.print(minExpectedRange);
-        Serial.println(")");
-        Serial.print("Y Range: ");
-        Serial.print(yRange);
-        Serial.print(" (expected > ");
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            Serial.print(AXIS_NAMES[axis]);
+            Serial.print(" Range: ");
+            Serial.print(report.data.max[axis] - report.data.min[axis]);
+            Serial.print(" ");
+        }
+        Serial.print("(expected > ");
         Serial.print(minExpectedRange);
         Serial.println(")");
         Serial.println("Consider:");
@@ -257,138 +413,121 @@ void JoystickController::calibrate_range()
         Serial.println("Range calibration successful!");
     }
 
-    calibration.isCalibrated = true;
+    Serial.print("Calibration time: ");
+    Serial.print(report.elapsedMs);
+    Serial.println(" ms");
     Serial.println("\n=== CALIBRATION COMPLETE ===");
-    printCalibrationData();
-
-    // Initialize filter with center values
-    initializeFilter();
+    printCalibrationData(report.data);
 }
 
 JoystickPosition JoystickController::readRaw()
 {
-    JoystickPosition position;
-    delay(ESP32_ADC_STABILIZATION_DELAY);
-    position.x = analogRead(X_PIN);
-    delay(ESP32_ADC_STABILIZATION_DELAY);
-    position.y = analogRead(Y_PIN);
+    JoystickPosition position = {};
+    sampleRaw(position.axis);
     return position;
 }
 
 JoystickPosition JoystickController::read()
 {
-    JoystickPosition position = {0, 0};
+    JoystickPosition position = {};
 
     if (!calibration.isCalibrated)
     {
-        Serial.println("WARNING: Joystick not calibrated!");
+        // Calibration in progress: output stays centered
+        if (!calibrator.isActive())
+        {
+            logEvent(LOG_NOT_CALIBRATED);
+        }
         return position;
     }
 
-    // Read raw values with ESP32 stabilization
-    delay(ESP32_ADC_STABILIZATION_DELAY);
-    int xRaw = analogRead(X_PIN);
-    delay(ESP32_ADC_STABILIZATION_DELAY);
-    int yRaw = analogRead(Y_PIN);
+    // Latest sampled frame (no blocking in continuous mode)
+    int raw[JOYSTICK_AXES];
+    if (!sampleRaw(raw))
+    {
+        return position;
+    }
 
     // Validate raw readings
-    if (xRaw < ADC_MIN_VALUE || xRaw > ADC_MAX_VALUE ||
-        yRaw < ADC_MIN_VALUE || yRaw > ADC_MAX_VALUE)
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
     {
-        Serial.print("ERROR: Invalid ADC reading - X: ");
-        Serial.print(xRaw);
-        Serial.print(" Y: ");
-        Serial.println(yRaw);
-        return position;
+        if (raw[axis] < ADC_MIN_VALUE || raw[axis] > ADC_MAX_VALUE)
+        {
+            logEvent(LOG_INVALID_ADC, AXIS_NAMES[axis], raw[axis]);
+            return position;
+        }
+        lastRaw[axis] = raw[axis];
     }
 
-    // Map to output range
-    int xMapped = mapToRange(xRaw, calibration.xMin, calibration.xMax, calibration.xCenter);
-    int yMapped = mapToRange(yRaw, calibration.yMin, calibration.yMax, calibration.yCenter);
+    // Drop WiFi/PWM switching spikes before they reach the filters
+    if (GLITCH_REJECTION_ENABLED)
+    {
+        pipeline.rejectGlitches(raw);
+    }
+
+    // Map to output range (precomputed kernel, see mapping_kernel.h)
+    int mapped[JOYSTICK_AXES];
+    bool atRest = pipeline.map(raw, mapped);
+
+    // Follow slow center drift while resting, widen the range on overshoot;
+    // the new mapping applies from the next sample
+    if (DRIFT_TRACKING_ENABLED && driftCompensator.update(nowMs(), raw, atRest, calibration))
+    {
+        rebuildMapping();
+    }
 
-    // Apply smoothing
-    int xSmooth = applySmoothing(xMapped, xHistory);
-    int ySmooth = applySmoothing(yMapped, yHistory);
+    pipeline.trackNoise(raw, mapped);
 
-    // Update filter index
-    filterIndex = (filterIndex + 1) % FILTER_SAMPLES;
+    // Apply smoothing (O(1) per sample, independent state per axis)
+    pipeline.smooth(mapped, position.axis, position.velocity);
 
-    // Apply dead zone
-    position.x = (abs(xSmooth) < DEAD_ZONE_PERCENT) ? 0 : xSmooth;
-    position.y = (abs(ySmooth) < DEAD_ZONE_PERCENT) ? 0 : ySmooth;
+    // Apply dead zone and response curve
+    pipeline.applyDeadZone(position.axis);
+    pipeline.applyCurve(position.axis);
 
     return position;
 }
 
-int JoystickController::applySmoothing(int newValue, int *history)
+void JoystickController::rebuildMapping()
 {
-    // Store new value
-    history[filterIndex] = newValue;
-
-    // If filter not fully initialized, fill with current value
-    if (!filterInitialized)
-    {
-        for (int i = 0; i < FILTER_SAMPLES; i++)
-        {
-            history[i] = newValue;
-        }
-        filterInitialized = true;
-        return newValue;
-    }
-
-    // Calculate average
-    long sum = 0;
-    for (int i = 0; i < FILTER_SAMPLES; i++)
+    // Ensure we have valid ranges
+    if (!pipeline.rebuild(calibration.min, calibration.max, calibration.center))
     {
-        sum += history[i];
+        logEvent(LOG_INVALID_RANGE);
     }
+}
 
-    return (int)(sum / FILTER_SAMPLES);
+float JoystickController::getNoise(int axis) const
+{
+    return pipeline.getNoise(axis);
 }
 
-int JoystickController::mapToRange(int rawValue, int minVal, int maxVal, int centerVal)
+void JoystickController::getLastRaw(int *raw) const
 {
-    // Ensure we have valid ranges
-    if (maxVal <= minVal)
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
     {
-        Serial.println("ERROR: Invalid calibration range!");
-        return 0;
+        raw[axis] = lastRaw[axis];
     }
+}
 
-    // Ensure center is within range
-    centerVal = constrain(centerVal, minVal, maxVal);
-
-    int mapped;
+unsigned long JoystickController::getRejectedSamples() const
+{
+    return pipeline.getRejectedSamples();
+}
 
-    if (rawValue >= centerVal)
-    {
-        // Map upper half (center to max) to (0 to +100)
-        if (maxVal == centerVal)
-        {
-            mapped = 0; // Avoid division by zero
-        }
-        else
-        {
-            mapped = map(rawValue, centerVal, maxVal, 0, MAX_OUTPUT);
-        }
-    }
-    else
-    {
-        // Map lower half (min to center) to (-100 to 0)
-        if (minVal == centerVal)
-        {
-            mapped = 0; // Avoid division by zero
-        }
-        else
-        {
-            mapped = map(rawValue, minVal, centerVal, MIN_OUTPUT, 0);
-        }
-    }
+unsigned long JoystickController::getClippedSamples() const
+{
+    return pipeline.getClippedSamples();
+}
 
-    // Ensure output is within bounds
-    mapped = constrain(mapped, MIN_OUTPUT, MAX_OUTPUT);
+const DriftCompensator &JoystickController::getDriftCompensator() const
+{
+    return driftCompensator;
+}
 
-    return mapped;
+float JoystickController::getFilterCutoff(int axis) const
+{
+    return pipeline.getFilterCutoff(axis);
 }
 
 bool JoystickController::isCalibrated() const
@@ -396,53 +535,70 @@ bool JoystickController::isCalibrated() const
     return calibration.isCalibrated;
 }
 
-void JoystickController::printCalibrationData() const
+bool JoystickController::isContinuousSampling() const
+{
+    return sampler.isRunning();
+}
+
+unsigned long JoystickController::samplesReceived() const
+{
+    return sampler.framesReceived();
+}
+
+unsigned long JoystickController::getStaleTicks() const
+{
+    return staleTicks;
+}
+
+unsigned long JoystickController::getAdcOverruns() const
+{
+    return sampler.framesOverrun();
+}
+
+void JoystickController::printCalibrationData(const CalibrationData &calibration)
 {
     Serial.println("=== ESP32 CALIBRATION DATA ===");
-    Serial.print("X - Min: ");
-    Serial.print(calibration.xMin);
-    Serial.print(" (");
-    Serial.print((calibration.xMin * 100) / ADC_MAX_VALUE);
-    Serial.print("%) Center: ");
-    Serial.print(calibration.xCenter);
-    Serial.print(" (");
-    Serial.print((calibration.xCenter * 100) / ADC_MAX_VALUE);
-    Serial.print("%) Max: ");
-    Serial.print(calibration.xMax);
-    Serial.print(" (");
-    Serial.print((calibration.xMax * 100) / ADC_MAX_VALUE);
-    Serial.print("%) Range: ");
-    Serial.println(calibration.xMax - calibration.xMin);
-
-    Serial.print("Y - Min: ");
-    Serial.print(calibration.yMin);
-    Serial.print(" (");
-    Serial.print((calibration.yMin * 100) / ADC_MAX_VALUE);
-    Serial.print("%) Center: ");
-    Serial.print(calibration.yCenter);
-    Serial.print(" (");
-    Serial.print((calibration.yCenter * 100) / ADC_MAX_VALUE);
-    Serial.print("%) Max: ");
-    Serial.print(calibration.yMax);
-    Serial.print(" (");
-    Serial.print((calibration.yMax * 100) / ADC_MAX_VALUE);
-    Serial.print("%) Range: ");
-    Serial.println(calibration.yMax - calibration.yMin);
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        Serial.print(AXIS_NAMES[axis]);
+        Serial.print(" - Min: ");
+        Serial.print(calibration.min[axis]);
+        Serial.print(" (");
+        Serial.print((calibration.min[axis] * 100) / ADC_MAX_VALUE);
+        Serial.print("%) Center: ");
+        Serial.print(calibration.center[axis]);
+        Serial.print(" (");
+        Serial.print((calibration.center[axis] * 100) / ADC_MAX_VALUE);
+        Serial.print("%) Max: ");
+        Serial.print(calibration.max[axis]);
+        Serial.print(" (");
+        Serial.print((calibration.max[axis] * 100) / ADC_MAX_VALUE);
+        Serial.print("%) Range: ");
+        Serial.println(calibration.max[axis] - calibration.min[axis]);
+    }
     Serial.println("==============================");
 }
 
 void JoystickController::printDebugInfo(const JoystickPosition &raw, const JoystickPosition &processed) const
 {
-    Serial.print("Raw ADC: X=");
-    Serial.print(raw.x);
-    Serial.print(" (");
-    Serial.print((raw.x * 100) / ADC_MAX_VALUE);
-    Serial.print("%) Y=");
-    Serial.print(raw.y);
-    Serial.print(" (");
-    Serial.print((raw.y * 100) / ADC_MAX_VALUE);
-    Serial.print("%) | Processed: X=");
-    Serial.print(processed.x);
-    Serial.print(" Y=");
-    Serial.println(processed.y);
-}
\ No newline at end of file
+    Serial.print("Raw ADC:");
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        Serial.print(" ");
+        Serial.print(AXIS_NAMES[axis]);
+        Serial.print("=");
+        Serial.print(raw.axis[axis]);
+        Serial.print(" (");
+        Serial.print((raw.axis[axis] * 100) / ADC_MAX_VALUE);
+        Serial.print("%)");
+    }
+    Serial.print(" | Processed:");
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        Serial.print(" ");
+        Serial.print(AXIS_NAMES[axis]);
+        Serial.print("=");
+        Serial.print(processed.axis[axis]);
+    }
+    Serial.println();
+}
@@ -2,45 +2,108 @@
 #define JOYSTICK_H
 
 #include "config.h"
+#include "adc_sampler.h"
+#include "adc_correction.h"
+#include "calibration.h"
+#include "calibration_store.h"
+#include "drift_compensator.h"
+#include "axis_pipeline.h"
+#include "scheduler_clock.h"
 
-// Joystick position structure
+// Joystick position, indexed by JoystickAxis
 struct JoystickPosition
 {
-    int x;
-    int y;
+    int axis[JOYSTICK_AXES];
+    int velocity[JOYSTICK_AXES]; // Output units per second (tracker only, else 0)
 };
 
-struct CalibrationData
+// Outcome of a finished calibration. Copied out on the task that runs the
+// calibration, so another task can print and store it without touching
+// the controller's live state.
+struct CalibrationReport
 {
-    int xMin, xMax, xCenter;
-    int yMin, yMax, yCenter;
-    bool isCalibrated;
+    CalibrationData data;
+    CalibrationRecordStatus storedStatus; // Loading the stored record
+    uint32_t elapsedMs;                   // This calibration, start to done
+    uint32_t storedCalibrationMs;         // Full calibration time from the stored record
+    uint32_t bootTimeSavedMs;             // Versus that full calibration (warm boot only)
+    int centerSamples;
+    int centerNoise[JOYSTICK_AXES]; // Peak-to-peak at rest
+    int rangeSamples;
+    bool verified;      // Stored calibration accepted by the center check
+    bool verifyFailed;  // Stored calibration rejected, recalibrated
+    bool defaultCenter; // Too few valid center samples
+    bool timedOut;      // Range phase hit RANGE_CALIBRATION_TIME
 };
 
 class JoystickController
 {
 private:
     CalibrationData calibration;
-    int xHistory[FILTER_SAMPLES];
-    int yHistory[FILTER_SAMPLES];
-    int filterIndex;
-    bool filterInitialized;
+    AxisPipeline<JOYSTICK_AXES> pipeline;
+    CalibrationStateMachine calibrator;
+    DriftCompensator driftCompensator;
+    CalibrationStorage *calibrationStorage;
+    CalibrationRecordStatus storedStatus;
+    uint32_t storedCalibrationMs;
+    AdcSampler sampler;
+    AdcSource *adcSource;
+    AdcLinearizer linearizer;
+    AdcTransferFn adcTransfer;
+    void *adcTransferContext;
+    const char *adcTransferName;
+    SchedulerClock *clock; // nullptr: millis()
+    uint32_t clockLastUs;
+    uint32_t clockMs;
+    uint32_t clockRemainderUs;
+    int lastRaw[JOYSTICK_AXES];
+    int lastSample[JOYSTICK_AXES]; // Newest decimated reading, reused on a stale tick
+    bool haveSample;
+    unsigned long staleTicks;
 
-    int applySmoothing(int newValue, int *history);
-    int mapToRange(int rawValue, int minVal, int maxVal, int centerVal);
+    bool sampleRaw(int *raw);
+    uint32_t nowMs();
+    int correctCode(uint32_t value, int fracBits) const;
+    void rebuildMapping();
     void initializeFilter();
 
 public:
     JoystickController();
 
+    void setAdcSource(AdcSource *source); // Call before begin() to override the ADC backend
+    void setCalibrationStorage(CalibrationStorage *storage); // Call before begin(); nullptr disables
+    void setAdcTransfer(AdcTransferFn transfer, void *context); // Call before begin(); raw code -> mV
+    void setClock(SchedulerClock *clock); // Time for calibration and drift tracking; nullptr uses millis()
     void begin();
-    void calibrate_center();
-    void calibrate_range();
+
+    // Non-blocking calibration: start once, then update every loop
+    void startCalibration(bool forceFull = false); // Tries the stored calibration first
+    CalibrationState updateCalibration();
+    CalibrationState getCalibrationState() const;
+    bool isCalibrating() const;
+    void getCalibrationReport(CalibrationReport &report) const; // Once CAL_DONE
+
+    // Writes a fresh calibration to the storage backend; refuses one that
+    // timed out or has an invalid axis. Touches nothing else, so the UI
+    // task may call it while the control task reads.
+    bool saveCalibration(const CalibrationReport &report);
+
     JoystickPosition read();
+    void getLastRaw(int *raw) const; // Corrected ADC codes behind the last read(), one per axis
+    float getNoise(int axis) const; // At-rest std dev in ADC counts
+    float getFilterCutoff(int axis) const; // Current smoothing cutoff in Hz
+    unsigned long getRejectedSamples() const; // Glitches removed by the median, all axes
+    unsigned long getClippedSamples() const;  // Steps held back by the rate limit, all axes
+    const DriftCompensator &getDriftCompensator() const;
     JoystickPosition readRaw(); // For debugging
 
     bool isCalibrated() const;
-    void printCalibrationData() const;
+    bool isContinuousSampling() const;
+    unsigned long samplesReceived() const;
+    unsigned long getStaleTicks() const;    // Reads with no new ADC frame (previous value reused)
+    unsigned long getAdcOverruns() const;   // Frames overwritten before a read took them
+    static void printCalibrationData(const CalibrationData &data);
+    static void printCalibrationReport(const CalibrationReport &report);
     void printDebugInfo(const JoystickPosition &raw, const JoystickPosition &processed) const;
 };
 
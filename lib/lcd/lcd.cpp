@@ -1,12 +1,26 @@
 #include "lcd.h"
 #include <Arduino.h>
+#include <string.h>
+
+static uint32_t lcdMicros()
+{
+    return micros();
+}
 
 LCDController::LCDController() : lcd(LCD_ADDRESS, LCD_COLS, LCD_ROWS)
 {
     lastUpdateTime = 0;
     isInitialized = false;
-    lastLine1 = "";
-    lastLine2 = "";
+    sinkCol = 0;
+    sinkRow = 0;
+    coalescedFrames = 0;
+}
+
+void LCDController::markShownText(uint8_t row, const char *text)
+{
+    LcdLine line;
+    formatTextLine(line, text);
+    framebuffer.markShown(row, line);
 }
 
 void LCDController::begin()
@@ -22,7 +36,9 @@ void LCDController::begin()
     lcd.setCursor(0, 1);
     lcd.print("Initializing...");
 
-    delay(LCD_STARTUP_DELAY);
+    framebuffer.markCleared();
+    markShownText(0, "Joystick Control");
+    markShownText(1, "Initializing...");
 
     isInitialized = true;
     lastUpdateTime = millis();
@@ -42,8 +58,7 @@ void LCDController::clear()
         return;
 
     lcd.clear();
-    lastLine1 = "";
-    lastLine2 = "";
+    framebuffer.markCleared();
 }
 
 void LCDController::backlight(bool on)
@@ -73,71 +88,37 @@ void LCDController::displayJoystickStatus(const JoystickPosition &joy, const Sim
         return;
     }
 
-    String line1 = formatJoystickData(joy, cmd);
-    String line2 = formatDirectionSpeed(cmd);
+    LcdLine line1;
+    LcdLine line2;
+    formatJoystickLine(line1, joy, cmd);
+    formatDirectionLine(line2, cmd);
 
     updateDisplay(line1, line2);
     lastUpdateTime = currentTime;
 }
 
-String LCDController::formatJoystickData(const JoystickPosition &joy, const SimpleMotorCommand &cmd)
-{
-    // Format: "±123,±456 67%" - handle larger numbers
-    String line = String(joy.x) + "," + String(joy.y) + " " + String(cmd.speedPercent) + "%";
-
-    // Pad with spaces to fill the line and clear any previous text
-    while (line.length() < LCD_COLS)
-    {
-        line += " ";
-    }
-
-    return line;
-}
-
-String LCDController::formatDirectionSpeed(const SimpleMotorCommand &cmd)
+void LCDController::updateDisplay(const LcdLine line1, const LcdLine line2)
 {
-    // Format: "BACKWARD" (just the direction, no "DIR:" prefix)
-    String line = getDirectionString(cmd.direction);
-
-    // Pad the rest with spaces to clear any previous text
-    while (line.length() < LCD_COLS)
+    // Queue only: update() sends the changed runs later
+    if (framebuffer.isDirty())
     {
-        line += " ";
+        coalescedFrames++;
     }
 
-    return line;
+    framebuffer.setLine(0, line1);
+    framebuffer.setLine(1, line2);
 }
 
-String LCDController::getDirectionString(MotorDirection direction)
+void LCDController::setCursor(uint8_t col, uint8_t row)
 {
-    switch (direction)
-    {
-    case MOTOR_FORWARD:
-        return "FORWARD";
-    case MOTOR_BACKWARD:
-        return "BACKWARD";
-    case MOTOR_STOP:
-    default:
-        return "STOPPED";
-    }
+    // Deferred so the address command rides in the same burst as the run
+    sinkCol = col;
+    sinkRow = row;
 }
 
-void LCDController::updateDisplay(const String &line1, const String &line2)
+void LCDController::write(const char *chars, uint8_t length)
 {
-    // Only update if content has changed
-    if (line1 != lastLine1)
-    {
-        lcd.setCursor(0, 0);
-        lcd.print(line1);
-        lastLine1 = line1;
-    }
-
-    if (line2 != lastLine2)
-    {
-        lcd.setCursor(0, 1);
-        lcd.print(line2);
-        lastLine2 = line2;
-    }
+    lcd.writeAt(sinkCol, sinkRow, chars, length);
 }
 
 void LCDController::displayMessage(const String &message, int duration)
@@ -152,12 +133,15 @@ void LCDController::displayMessage(const String &message, int duration)
     if (message.length() <= LCD_COLS)
     {
         lcd.print(message);
+        markShownText(0, message.c_str());
     }
     else
     {
         lcd.print(message.substring(0, LCD_COLS));
         lcd.setCursor(0, 1);
         lcd.print(message.substring(LCD_COLS, LCD_COLS * 2));
+        markShownText(0, message.c_str());
+        markShownText(1, message.c_str() + LCD_COLS);
     }
 
     if (duration > 0)
@@ -179,8 +163,8 @@ void LCDController::displayTwoLineMessage(const String &line1, const String &lin
     lcd.setCursor(0, 1);
     lcd.print(line2.substring(0, LCD_COLS));
 
-    lastLine1 = line1;
-    lastLine2 = line2;
+    markShownText(0, line1.c_str());
+    markShownText(1, line2.c_str());
 
     if (duration > 0)
     {
@@ -214,14 +198,28 @@ void LCDController::displayInstruction(const String &title, const String &subtit
     }
 
     // Update tracking variables
-    lastLine1 = title;
-    lastLine2 = subtitle;
+    markShownText(0, title.c_str());
+    markShownText(1, subtitle.c_str());
 }
 
 void LCDController::update()
 {
-    // This method can be used for future enhancements like scrolling text
-    // Currently, the main updates happen in displayJoystickStatus
+    if (!isInitialized)
+        return;
+
+    // Drain queued cell runs in a bounded slice so callers never wait on
+    // the whole frame
+    framebuffer.flushFor(*this, LCD_UPDATE_BUDGET_US, lcdMicros);
+}
+
+bool LCDController::hasPendingWrites() const
+{
+    return framebuffer.isDirty();
+}
+
+unsigned long LCDController::getCoalescedFrames() const
+{
+    return coalescedFrames;
 }
 
 bool LCDController::isReady() const
@@ -229,6 +227,11 @@ bool LCDController::isReady() const
     return isInitialized;
 }
 
+const LcdFlushStats &LCDController::getFlushStats() const
+{
+    return framebuffer.getLastFlush();
+}
+
 void LCDController::printDebug() const
 {
     Serial.println("=== LCD DEBUG INFO ===");
@@ -240,9 +243,29 @@ void LCDController::printDebug() const
     Serial.print(LCD_COLS);
     Serial.print("x");
     Serial.println(LCD_ROWS);
-    Serial.print("Last Line 1: ");
-    Serial.println(lastLine1);
-    Serial.print("Last Line 2: ");
-    Serial.println(lastLine2);
+    for (uint8_t row = 0; row < LCD_ROWS; row++)
+    {
+        LcdLine line;
+        memcpy(line, framebuffer.shownRow(row), LCD_COLS);
+        line[LCD_COLS] = '\0';
+        Serial.print("Line ");
+        Serial.print(row + 1);
+        Serial.print(": ");
+        Serial.println(line);
+    }
+    const LcdFlushStats &stats = framebuffer.getLastFlush();
+    Serial.print("Last flush: ");
+    Serial.print(stats.runs);
+    Serial.print(" runs, ");
+    Serial.print(stats.bytes);
+    Serial.print(" bytes, ");
+    Serial.print(stats.wireBytes);
+    Serial.print(" wire bytes in ");
+    Serial.print(stats.transactions);
+    Serial.println(" I2C bursts");
+    Serial.print("Coalesced frames: ");
+    Serial.println(coalescedFrames);
+    Serial.print("Avg bytes/frame: ");
+    Serial.println(framebuffer.getFrameCount() > 0 ? framebuffer.getTotalBytes() / framebuffer.getFrameCount() : 0);
     Serial.println("=====================");
 }
\ No newline at end of file
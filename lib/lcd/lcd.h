@@ -4,24 +4,30 @@
 #include "config.h"
 #include "joystick.h"
 #include "control_mapper.h"
-#include <LiquidCrystal_I2C.h>
+#include "lcd_format.h"
+#include "lcd_framebuffer.h"
+#include "hd44780.h"
 
-class LCDController
+class LCDController : private LcdSink
 {
 private:
-    LiquidCrystal_I2C lcd;
+    HD44780Driver lcd;
     unsigned long lastUpdateTime;
     bool isInitialized;
 
-    // Display state tracking
-    String lastLine1;
-    String lastLine2;
+    // Display state tracking: shadow of every cell, only diffs are sent
+    LcdFramebuffer framebuffer;
+    unsigned long coalescedFrames; // Frames replaced before fully sent
 
     // Helper methods
-    String formatJoystickData(const JoystickPosition &joy, const SimpleMotorCommand &cmd);
-    String formatDirectionSpeed(const SimpleMotorCommand &cmd);
-    void updateDisplay(const String &line1, const String &line2);
-    String getDirectionString(MotorDirection direction);
+    void updateDisplay(const LcdLine line1, const LcdLine line2);
+    void markShownText(uint8_t row, const char *text);
+
+    // LcdSink (framebuffer flush target): each run is one I2C burst
+    uint8_t sinkCol;
+    uint8_t sinkRow;
+    void setCursor(uint8_t col, uint8_t row) override;
+    void write(const char *chars, uint8_t length) override;
 
 public:
     LCDController();
@@ -38,8 +44,11 @@ public:
     void displayInstruction(const String &title, const String &subtitle = "");
 
     // Utility functions
-    void update(); // Call in loop for timed updates
+    void update(); // Call in loop: sends pending LCD writes within LCD_UPDATE_BUDGET_US
+    bool hasPendingWrites() const;
+    unsigned long getCoalescedFrames() const;
     bool isReady() const;
+    const LcdFlushStats &getFlushStats() const; // Last status refresh
     void printDebug() const;
 };
 
@@ -0,0 +1,78 @@
+#include "lcd_format.h"
+
+static int appendText(LcdLine line, int pos, const char *text)
+{
+    while (*text != '\0' && pos < LCD_COLS)
+    {
+        line[pos++] = *text++;
+    }
+    return pos;
+}
+
+static int appendInt(LcdLine line, int pos, int value)
+{
+    // Digits are produced in reverse into a scratch buffer
+    char digits[11];
+    int count = 0;
+    unsigned int magnitude = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+
+    do
+    {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (value < 0 && pos < LCD_COLS)
+    {
+        line[pos++] = '-';
+    }
+    while (count > 0 && pos < LCD_COLS)
+    {
+        line[pos++] = digits[--count];
+    }
+    return pos;
+}
+
+static void padLine(LcdLine line, int pos)
+{
+    while (pos < LCD_COLS)
+    {
+        line[pos++] = ' ';
+    }
+    line[LCD_COLS] = '\0';
+}
+
+void formatJoystickLine(LcdLine line, const JoystickPosition &joy, const SimpleMotorCommand &cmd)
+{
+    int pos = appendInt(line, 0, joy.axis[AXIS_X]);
+    pos = appendText(line, pos, ",");
+    pos = appendInt(line, pos, joy.axis[AXIS_Y]);
+    pos = appendText(line, pos, " ");
+    pos = appendInt(line, pos, cmd.speedPercent);
+    pos = appendText(line, pos, "%");
+    padLine(line, pos);
+}
+
+void formatDirectionLine(LcdLine line, const SimpleMotorCommand &cmd)
+{
+    padLine(line, appendText(line, 0, directionName(cmd.direction)));
+}
+
+void formatTextLine(LcdLine line, const char *text)
+{
+    padLine(line, appendText(line, 0, text));
+}
+
+const char *directionName(MotorDirection direction)
+{
+    switch (direction)
+    {
+    case MOTOR_FORWARD:
+        return "FORWARD";
+    case MOTOR_BACKWARD:
+        return "BACKWARD";
+    case MOTOR_STOP:
+    default:
+        return "STOPPED";
+    }
+}
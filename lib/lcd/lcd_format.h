@@ -0,0 +1,24 @@
+#ifndef LCD_FORMAT_H
+#define LCD_FORMAT_H
+
+#include "config.h"
+#include "control_mapper.h"
+
+// Fixed-size LCD line: LCD_COLS characters plus terminator
+typedef char LcdLine[LCD_COLS + 1];
+
+// Heap-free status formatting. Every function writes a full line,
+// space-padded to LCD_COLS and truncated if the content is longer.
+
+// "±123,±456 67%"
+void formatJoystickLine(LcdLine line, const JoystickPosition &joy, const SimpleMotorCommand &cmd);
+
+// "BACKWARD"
+void formatDirectionLine(LcdLine line, const SimpleMotorCommand &cmd);
+
+// Copy arbitrary text into a padded line
+void formatTextLine(LcdLine line, const char *text);
+
+const char *directionName(MotorDirection direction);
+
+#endif
@@ -0,0 +1,178 @@
+#include "lcd_framebuffer.h"
+#include "hd44780.h"
+#include <string.h>
+
+LcdFramebuffer::LcdFramebuffer()
+{
+    memset(pending, ' ', sizeof(pending));
+    invalidate();
+
+    resetStats(lastFlush);
+    resetStats(frameStats);
+    totalBytes = 0;
+    frames = 0;
+}
+
+void LcdFramebuffer::setLine(uint8_t row, const LcdLine line)
+{
+    if (row >= LCD_ROWS)
+        return;
+
+    if (memcmp(pending[row], line, LCD_COLS) != 0)
+    {
+        memcpy(pending[row], line, LCD_COLS);
+    }
+    if (memcmp(pending[row], shown[row], LCD_COLS) != 0)
+    {
+        dirtyRows |= (uint8_t)(1 << row);
+    }
+}
+
+void LcdFramebuffer::setCell(uint8_t col, uint8_t row, char c)
+{
+    if (row >= LCD_ROWS || col >= LCD_COLS)
+        return;
+
+    pending[row][col] = c;
+    if (shown[row][col] != c)
+    {
+        dirtyRows |= (uint8_t)(1 << row);
+    }
+}
+
+void LcdFramebuffer::markShown(uint8_t row, const LcdLine line)
+{
+    if (row >= LCD_ROWS)
+        return;
+
+    memcpy(shown[row], line, LCD_COLS);
+    memcpy(pending[row], line, LCD_COLS);
+    dirtyRows &= (uint8_t)~(1 << row);
+}
+
+void LcdFramebuffer::markCleared()
+{
+    memset(shown, ' ', sizeof(shown));
+    memset(pending, ' ', sizeof(pending));
+    dirtyRows = 0;
+}
+
+void LcdFramebuffer::invalidate()
+{
+    // NUL never matches a printable cell
+    memset(shown, 0, sizeof(shown));
+    dirtyRows = (uint8_t)((1 << LCD_ROWS) - 1);
+}
+
+bool LcdFramebuffer::isDirty() const
+{
+    return dirtyRows != 0;
+}
+
+bool LcdFramebuffer::flushRun(LcdSink &sink)
+{
+    for (uint8_t row = 0; row < LCD_ROWS; row++)
+    {
+        if ((dirtyRows & (1 << row)) == 0)
+            continue;
+
+        // Find the start of the first changed run
+        int start = 0;
+        while (start < LCD_COLS && pending[row][start] == shown[row][start])
+        {
+            start++;
+        }
+        if (start == LCD_COLS)
+        {
+            dirtyRows &= (uint8_t)~(1 << row);
+            continue;
+        }
+
+        // Extend while cells differ or the unchanged gap is short
+        int end = start + 1; // Exclusive
+        int scan = end;
+        while (scan < LCD_COLS && scan - end <= LCD_RUN_MERGE_GAP)
+        {
+            if (pending[row][scan] != shown[row][scan])
+            {
+                end = scan + 1;
+            }
+            scan++;
+        }
+
+        uint8_t length = (uint8_t)(end - start);
+        sink.setCursor((uint8_t)start, row);
+        sink.write(&pending[row][start], length);
+        memcpy(&shown[row][start], &pending[row][start], length);
+        if (memcmp(shown[row], pending[row], LCD_COLS) == 0)
+        {
+            dirtyRows &= (uint8_t)~(1 << row);
+        }
+
+        frameStats.runs++;
+        frameStats.bytes += 1 + length; // Set DDRAM address + characters
+        return true;
+    }
+
+    // Display matches the pending frame: close out its statistics
+    if (frameStats.runs > 0)
+    {
+        frameStats.transactions = frameStats.runs;
+        frameStats.wireBytes = (uint16_t)(frameStats.bytes * HD44780_WIRE_BYTES_PER_BYTE);
+        lastFlush = frameStats;
+        totalBytes += frameStats.bytes;
+        frames++;
+        resetStats(frameStats);
+    }
+    return false;
+}
+
+LcdFlushStats LcdFramebuffer::flush(LcdSink &sink)
+{
+    while (flushRun(sink))
+    {
+    }
+    return lastFlush;
+}
+
+bool LcdFramebuffer::flushFor(LcdSink &sink, uint32_t budgetMicros, LcdMicrosFn nowMicros)
+{
+    uint32_t start = nowMicros();
+
+    // At least one run per call, so a budget shorter than a single burst
+    // still makes progress
+    while (flushRun(sink))
+    {
+        if (nowMicros() - start >= budgetMicros)
+            return true;
+    }
+    return false;
+}
+
+void LcdFramebuffer::resetStats(LcdFlushStats &stats)
+{
+    stats.runs = 0;
+    stats.bytes = 0;
+    stats.transactions = 0;
+    stats.wireBytes = 0;
+}
+
+const char *LcdFramebuffer::shownRow(uint8_t row) const
+{
+    return shown[row < LCD_ROWS ? row : 0];
+}
+
+const LcdFlushStats &LcdFramebuffer::getLastFlush() const
+{
+    return lastFlush;
+}
+
+unsigned long LcdFramebuffer::getTotalBytes() const
+{
+    return totalBytes;
+}
+
+unsigned long LcdFramebuffer::getFrameCount() const
+{
+    return frames;
+}
@@ -0,0 +1,73 @@
+#ifndef LCD_FRAMEBUFFER_H
+#define LCD_FRAMEBUFFER_H
+
+#include "config.h"
+#include "lcd_format.h"
+#include <stdint.h>
+
+// Unchanged cells allowed inside a run before it is split; a gap of one
+// cell costs the same as the setCursor that splitting would add
+const int LCD_RUN_MERGE_GAP = 1;
+
+typedef uint32_t (*LcdMicrosFn)();
+
+// Destination for framebuffer flushes (LCD driver, recorder, counter)
+class LcdSink
+{
+public:
+    virtual ~LcdSink() {}
+    virtual void setCursor(uint8_t col, uint8_t row) = 0;
+    virtual void write(const char *chars, uint8_t length) = 0;
+};
+
+struct LcdFlushStats
+{
+    uint16_t runs;         // setCursor + write pairs
+    uint16_t bytes;        // HD44780 bytes (commands + characters)
+    uint16_t transactions; // I2C bursts (one per run)
+    uint16_t wireBytes;    // PCF8574 bytes on the bus
+};
+
+// Shadow copy of the display. Callers draw into the pending frame; flush()
+// sends only the runs of cells that differ from what the LCD shows.
+// The pending frame doubles as the update queue: it is bounded by the cell
+// count, and a newer frame drawn before the last one finished sending simply
+// replaces the cells that are still pending.
+class LcdFramebuffer
+{
+private:
+    char shown[LCD_ROWS][LCD_COLS];
+    char pending[LCD_ROWS][LCD_COLS];
+    uint8_t dirtyRows; // Bit per row with pending changes
+
+    LcdFlushStats lastFlush;  // Last fully sent frame
+    LcdFlushStats frameStats; // Frame currently being sent
+    unsigned long totalBytes;
+    unsigned long frames;
+
+    static void resetStats(LcdFlushStats &stats);
+
+public:
+    LcdFramebuffer();
+
+    void setLine(uint8_t row, const LcdLine line);
+    void setCell(uint8_t col, uint8_t row, char c);
+
+    // Record content written to the LCD outside the framebuffer
+    void markShown(uint8_t row, const LcdLine line);
+    void markCleared(); // LCD cleared: every cell is a space
+    void invalidate();  // LCD content unknown: next flush redraws everything
+
+    bool isDirty() const;
+    bool flushRun(LcdSink &sink);     // Send one run; false when nothing is pending
+    LcdFlushStats flush(LcdSink &sink); // Send everything
+    // Send runs until budgetMicros has elapsed; true if work remains
+    bool flushFor(LcdSink &sink, uint32_t budgetMicros, LcdMicrosFn nowMicros);
+
+    const char *shownRow(uint8_t row) const; // Not NUL-terminated
+    const LcdFlushStats &getLastFlush() const;
+    unsigned long getTotalBytes() const;
+    unsigned long getFrameCount() const;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bounded multi-producer/single-consumer queue (Vyukov's per-slot sequence
+// scheme). Any number of tasks may push; one task pops. Producers claim a
+// slot with one compare-and-swap and never wait for each other or for the
+// consumer. Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class MpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "MpscQueue capacity must be a power of two");
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence; // == position: free, == position + 1: full
+        T item;
+    };
+
+    Slot slots[Capacity];
+    std::atomic<size_t> tail; // Next position to claim (shared by producers)
+    size_t head;              // Next position to pop (consumer only)
+    std::atomic<unsigned long> dropped;
+
+public:
+    MpscQueue() : tail(0), head(0), dropped(0)
+    {
+        for (size_t i = 0; i < Capacity; i++)
+        {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Producer side, any task. Returns false (and counts a drop) when full.
+    bool push(const T &item)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Slot &slot = slots[position & (Capacity - 1)];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)position;
+
+            if (diff == 0)
+            {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.item = item;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+                // Lost the race: position now holds the current tail
+            }
+            else if (diff < 0)
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer side. Returns false when empty (or the next slot is still
+    // being written).
+    bool pop(T &item)
+    {
+        Slot &slot = slots[head & (Capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+            return false;
+
+        item = slot.item;
+        slot.sequence.store(head + Capacity, std::memory_order_release);
+        head++;
+        return true;
+    }
+
+    size_t capacity() const { return Capacity; }
+    unsigned long droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <stdint.h>
+
+// Latest-value snapshot for one writer and any number of readers.
+// The writer never waits; readers retry if they raced with a write.
+// T must be trivially copyable.
+template <typename T>
+class Seqlock
+{
+private:
+    std::atomic<uint32_t> sequence; // Odd while a write is in progress
+    T value;
+
+public:
+    Seqlock() : sequence(0), value() {}
+
+    void write(const T &newValue)
+    {
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        value = newValue;
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Single attempt; false if a write was in progress or overlapped
+    bool tryRead(T &out) const
+    {
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1)
+            return false;
+
+        out = value;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence.load(std::memory_order_relaxed) == before;
+    }
+
+    T read() const
+    {
+        T out;
+        while (!tryRead(out))
+        {
+        }
+        return out;
+    }
+
+    // Number of completed writes
+    uint32_t version() const { return sequence.load(std::memory_order_acquire) / 2; }
+};
+
+#endif
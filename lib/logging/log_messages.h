@@ -0,0 +1,26 @@
+#ifndef LOG_MESSAGES_H
+#define LOG_MESSAGES_H
+
+// Deferred log messages: id, minimum ms between emissions (0 = every
+// one), and the text. Each {} takes the next argument (integer or static
+// string) when the log task formats the record.
+#define LOG_MESSAGE_LIST(X)                                                          \
+    X(LOG_NOT_CALIBRATED, 1000, "WARNING: Joystick not calibrated!")                 \
+    X(LOG_INVALID_ADC, 1000, "ERROR: Invalid ADC reading - {}: {}")                  \
+    X(LOG_INVALID_RANGE, 1000, "ERROR: Invalid calibration range!")                  \
+    X(LOG_COMMAND, 0, "Command - Direction: {} | Speed: {}% (PWM: {})")              \
+    X(LOG_MOTOR_STOPPED, 0, "Motor stopped")                                         \
+    X(LOG_MOTOR_RUNNING, 0, "Motor: {} at {}%")                                      \
+    X(LOG_RECALIBRATION_REQUESTED, 0, "Recalibration requested")                     \
+    X(LOG_SPEED_CURVE, 0, "Speed curve: {}")                                         \
+    X(LOG_TIMER_UNAVAILABLE, 0, "WARNING: Hardware timer unavailable, using clock polling")
+
+enum LogMessageId
+{
+#define LOG_MESSAGE_ENUM(id, interval, text) id,
+    LOG_MESSAGE_LIST(LOG_MESSAGE_ENUM)
+#undef LOG_MESSAGE_ENUM
+        LOG_MESSAGE_COUNT
+};
+
+#endif
@@ -0,0 +1,127 @@
+#include "logger.h"
+#include <stdio.h>
+#include <string.h>
+
+Logger logger;
+
+static const char *const messageTexts[LOG_MESSAGE_COUNT] = {
+#define LOG_MESSAGE_TEXT(id, interval, text) text,
+    LOG_MESSAGE_LIST(LOG_MESSAGE_TEXT)
+#undef LOG_MESSAGE_TEXT
+};
+
+static const uint16_t messageIntervals[LOG_MESSAGE_COUNT] = {
+#define LOG_MESSAGE_INTERVAL(id, interval, text) interval,
+    LOG_MESSAGE_LIST(LOG_MESSAGE_INTERVAL)
+#undef LOG_MESSAGE_INTERVAL
+};
+
+Logger::Logger()
+    : reportedDrops(0)
+{
+    for (int i = 0; i < LOG_MESSAGE_COUNT; i++)
+    {
+        nextAllowed[i].store(0, std::memory_order_relaxed);
+        suppressed[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+bool Logger::post(uint32_t nowMs, LogMessageId id, const LogArg *args, uint8_t count)
+{
+    if (id >= LOG_MESSAGE_COUNT)
+        return false;
+
+    uint16_t interval = messageIntervals[id];
+    if (interval > 0)
+    {
+        // One poster per window wins the compare-and-swap; the rest count
+        uint32_t allowed = nextAllowed[id].load(std::memory_order_relaxed);
+        if ((int32_t)(nowMs - allowed) < 0 ||
+            !nextAllowed[id].compare_exchange_strong(allowed, nowMs + interval, std::memory_order_relaxed))
+        {
+            suppressed[id].fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    LogRecord record;
+    record.timestamp = nowMs;
+    record.id = (uint16_t)id;
+    record.argCount = count > LOG_MAX_ARGS ? LOG_MAX_ARGS : count;
+    uint32_t skipped = interval > 0 ? suppressed[id].exchange(0, std::memory_order_relaxed) : 0;
+    record.suppressed = skipped > 0xFFFF ? 0xFFFF : (uint16_t)skipped;
+    for (uint8_t i = 0; i < record.argCount; i++)
+    {
+        record.args[i] = args[i];
+    }
+
+    return queue.push(record);
+}
+
+size_t Logger::format(const LogRecord &record, char *line, size_t size) const
+{
+    const char *text = messageTexts[record.id];
+    size_t length = 0;
+    uint8_t arg = 0;
+
+    while (*text != '\0' && length + 1 < size)
+    {
+        if (text[0] == '{' && text[1] == '}' && arg < record.argCount)
+        {
+            const LogArg &value = record.args[arg++];
+            int written = value.isString ? snprintf(line + length, size - length, "%s", value.text)
+                                         : snprintf(line + length, size - length, "%ld", (long)value.number);
+            if (written > 0)
+                length += (size_t)written < size - length ? (size_t)written : size - length - 1;
+            text += 2;
+            continue;
+        }
+        line[length++] = *text++;
+    }
+
+    if (record.suppressed > 0 && length + 1 < size)
+    {
+        int written = snprintf(line + length, size - length, " (%u suppressed)", (unsigned)record.suppressed);
+        if (written > 0)
+            length += (size_t)written < size - length ? (size_t)written : size - length - 1;
+    }
+
+    line[length] = '\0';
+    return length;
+}
+
+size_t Logger::drain(Print &out, size_t maxRecords)
+{
+    char line[LOG_LINE_LENGTH];
+    size_t drained = 0;
+
+    unsigned long drops = queue.droppedCount();
+    if (drops != reportedDrops)
+    {
+        int length = snprintf(line, sizeof(line), "LOG: %lu records dropped\r\n", drops - reportedDrops);
+        out.write((const uint8_t *)line, (size_t)length < sizeof(line) ? (size_t)length : sizeof(line) - 1);
+        reportedDrops = drops;
+    }
+
+    LogRecord record;
+    while (drained < maxRecords && queue.pop(record))
+    {
+        // One write per line, so lines stay whole next to other UART users
+        size_t length = format(record, line, sizeof(line) - 2);
+        line[length++] = '\r';
+        line[length++] = '\n';
+        out.write((const uint8_t *)line, length);
+        drained++;
+    }
+    return drained;
+}
+
+unsigned long Logger::getDropped() const
+{
+    return queue.droppedCount();
+}
+
+const char *Logger::messageText(LogMessageId id)
+{
+    return id < LOG_MESSAGE_COUNT ? messageTexts[id] : "?";
+}
@@ -0,0 +1,82 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include "config.h"
+#include "log_messages.h"
+#include "mpsc_queue.h"
+#include <Arduino.h>
+#include <atomic>
+#include <stdint.h>
+
+// Deferred logging: callers post a fixed-size record (message id plus up
+// to LOG_MAX_ARGS integer or static-string arguments) and return at once.
+// Formatting and the UART write happen later in drain(), called from a
+// low-priority task. A full queue drops the record and counts it;
+// messages with a rate limit count suppressed repeats instead.
+
+const int LOG_MAX_ARGS = 4;
+
+struct LogArg
+{
+    bool isString;
+    union
+    {
+        int32_t number;
+        const char *text; // Must outlive the record: literals and static tables only
+    };
+
+    LogArg() : isString(false), number(0) {}
+    LogArg(int value) : isString(false), number(value) {}
+    LogArg(long value) : isString(false), number((int32_t)value) {}
+    LogArg(unsigned long value) : isString(false), number((int32_t)value) {}
+    LogArg(const char *value) : isString(true), text(value) {}
+};
+
+struct LogRecord
+{
+    uint32_t timestamp;
+    uint16_t id;
+    uint8_t argCount;
+    uint16_t suppressed; // Repeats skipped by the rate limit before this one
+    LogArg args[LOG_MAX_ARGS];
+};
+
+class Logger
+{
+private:
+    MpscQueue<LogRecord, LOG_QUEUE_DEPTH> queue;
+    std::atomic<uint32_t> nextAllowed[LOG_MESSAGE_COUNT]; // Rate limit, ms
+    std::atomic<uint32_t> suppressed[LOG_MESSAGE_COUNT];
+    unsigned long reportedDrops; // Consumer only
+
+    size_t format(const LogRecord &record, char *line, size_t size) const;
+
+public:
+    Logger();
+
+    // Any task; never blocks. False when rate limited or dropped.
+    bool post(uint32_t nowMs, LogMessageId id, const LogArg *args, uint8_t count);
+
+    // One consumer task. Formats and writes up to maxRecords records.
+    size_t drain(Print &out, size_t maxRecords = LOG_QUEUE_DEPTH);
+
+    unsigned long getDropped() const;
+    static const char *messageText(LogMessageId id);
+};
+
+extern Logger logger;
+
+template <typename... Args>
+inline bool logEvent(LogMessageId id, Args... args)
+{
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Too many log arguments");
+    LogArg list[] = {LogArg(args)...};
+    return logger.post(millis(), id, list, (uint8_t)sizeof...(Args));
+}
+
+inline bool logEvent(LogMessageId id)
+{
+    return logger.post(millis(), id, nullptr, 0);
+}
+
+#endif
@@ -0,0 +1,113 @@
+#include "mapping_kernel.h"
+
+LinearMap::LinearMap()
+{
+    configure(0, 1, 0, 1);
+}
+
+void LinearMap::configure(int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax)
+{
+    int32_t run = inMax - inMin;
+    int32_t rise = outMax - outMin;
+    if (run <= 0)
+        run = 1;
+
+    this->inMin = inMin;
+    this->outMin = outMin;
+    riseSign = (rise < 0) ? -1 : 1;
+    riseMagnitude = (uint32_t)(rise < 0 ? -rise : rise);
+
+    // shift = N + ceil(log2(run)), magic = ceil(2^shift / run)
+    uint8_t log2Run = 0;
+    while ((1UL << log2Run) < (uint32_t)run)
+    {
+        log2Run++;
+    }
+    shift = (uint8_t)(MAP_NUMERATOR_BITS + log2Run);
+    magic = ((1ULL << shift) + (uint64_t)run - 1) / (uint64_t)run;
+}
+
+int32_t arduinoMap(int32_t x, int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+static int32_t clampInt(int32_t value, int32_t low, int32_t high)
+{
+    return value < low ? low : (value > high ? high : value);
+}
+
+int referenceMapToRange(int rawValue, int minVal, int maxVal, int centerVal)
+{
+    if (maxVal <= minVal)
+        return 0;
+
+    centerVal = clampInt(centerVal, minVal, maxVal);
+
+    int mapped;
+    if (rawValue >= centerVal)
+    {
+        mapped = (maxVal == centerVal) ? 0 : arduinoMap(rawValue, centerVal, maxVal, 0, MAX_OUTPUT);
+    }
+    else
+    {
+        mapped = (minVal == centerVal) ? 0 : arduinoMap(rawValue, minVal, centerVal, MIN_OUTPUT, 0);
+    }
+
+    return clampInt(mapped, MIN_OUTPUT, MAX_OUTPUT);
+}
+
+int referencePercentToPWM(int percent)
+{
+    return arduinoMap(percent, 0, 100, MIN_SPEED, MAX_SPEED);
+}
+
+AxisMapper::AxisMapper()
+{
+    build(ADC_MIN_VALUE, ADC_MAX_VALUE, ADC_DEFAULT_CENTER);
+}
+
+bool AxisMapper::build(int minVal, int maxVal, int centerVal)
+{
+    valid = maxVal > minVal;
+
+#if MAPPING_KERNEL == MAPPING_KERNEL_LUT
+    for (int raw = ADC_MIN_VALUE; raw <= ADC_MAX_VALUE; raw++)
+    {
+        table[raw] = (int16_t)referenceMapToRange(raw, minVal, maxVal, centerVal);
+    }
+#else
+    if (!valid)
+        return false;
+
+    centerVal = clampInt(centerVal, minVal, maxVal);
+    this->minVal = minVal;
+    this->maxVal = maxVal;
+    this->centerVal = centerVal;
+    upperFlat = (maxVal == centerVal);
+    lowerFlat = (minVal == centerVal);
+    if (!upperFlat)
+        upper.configure(centerVal, maxVal, 0, MAX_OUTPUT);
+    if (!lowerFlat)
+        lower.configure(minVal, centerVal, MIN_OUTPUT, 0);
+#endif
+
+    return valid;
+}
+
+bool AxisMapper::isValid() const
+{
+    return valid;
+}
+
+SpeedMapper::SpeedMapper()
+{
+#if MAPPING_KERNEL == MAPPING_KERNEL_LUT
+    for (int percent = 0; percent <= 100; percent++)
+    {
+        pwmTable[percent] = (uint8_t)referencePercentToPWM(percent);
+    }
+#else
+    pwmMap.configure(0, 100, MIN_SPEED, MAX_SPEED);
+#endif
+}
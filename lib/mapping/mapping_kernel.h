@@ -0,0 +1,112 @@
+#ifndef MAPPING_KERNEL_H
+#define MAPPING_KERNEL_H
+
+#include "config.h"
+#include <stdint.h>
+
+// Exact Arduino map() for x >= inMin, without a division.
+// Quotients come from a multiply-shift by a rounded-up reciprocal, which is
+// exact for every numerator below 2^MAP_NUMERATOR_BITS (Granlund-Montgomery),
+// so results are bit-identical to map()'s truncating division.
+const int MAP_NUMERATOR_BITS = 21; // (ADC_MAX_VALUE) * MAX_OUTPUT < 2^21
+
+class LinearMap
+{
+private:
+    int32_t inMin;
+    int32_t outMin;
+    uint32_t riseMagnitude;
+    int32_t riseSign; // +1 or -1 (map() truncates toward zero)
+    uint64_t magic;
+    uint8_t shift;
+
+public:
+    LinearMap();
+    void configure(int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax);
+
+    inline int32_t apply(int32_t x) const
+    {
+        uint64_t numerator = (uint64_t)(uint32_t)(x - inMin) * riseMagnitude;
+        int32_t quotient = (int32_t)((numerator * magic) >> shift);
+        return outMin + riseSign * quotient;
+    }
+};
+
+// Reference implementations (the original code paths), used to build the
+// lookup tables and as the ground truth for equivalence checks
+int32_t arduinoMap(int32_t x, int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax);
+int referenceMapToRange(int rawValue, int minVal, int maxVal, int centerVal);
+int referencePercentToPWM(int percent);
+
+// Raw 12-bit ADC -> MIN_OUTPUT..MAX_OUTPUT for one calibrated axis.
+// Rebuild whenever the calibration changes.
+class AxisMapper
+{
+private:
+    bool valid;
+#if MAPPING_KERNEL == MAPPING_KERNEL_LUT
+    int16_t table[ADC_MAX_VALUE + 1];
+#else
+    int32_t minVal;
+    int32_t maxVal;
+    int32_t centerVal;
+    bool upperFlat; // maxVal == centerVal
+    bool lowerFlat; // minVal == centerVal
+    LinearMap upper;
+    LinearMap lower;
+#endif
+
+public:
+    AxisMapper();
+
+    bool build(int minVal, int maxVal, int centerVal); // False for an unusable range
+    bool isValid() const;
+
+    inline int map(int rawValue) const
+    {
+        if (rawValue < ADC_MIN_VALUE)
+            rawValue = ADC_MIN_VALUE;
+        if (rawValue > ADC_MAX_VALUE)
+            rawValue = ADC_MAX_VALUE;
+#if MAPPING_KERNEL == MAPPING_KERNEL_LUT
+        return table[rawValue];
+#else
+        // Clamping to the calibrated range first gives the same results as
+        // map() + constrain() and keeps every numerator non-negative
+        int32_t raw = rawValue < minVal ? minVal : (rawValue > maxVal ? maxVal : rawValue);
+        int32_t high = upperFlat ? 0 : upper.apply(raw);
+        int32_t low = lowerFlat ? 0 : lower.apply(raw);
+        return valid ? (int)(raw >= centerVal ? high : low) : 0;
+#endif
+    }
+};
+
+// Speed percent -> PWM duty (the stick -> percent step is a response
+// curve, see response_curve.h)
+class SpeedMapper
+{
+private:
+#if MAPPING_KERNEL == MAPPING_KERNEL_LUT
+    uint8_t pwmTable[101];
+#else
+    LinearMap pwmMap;
+#endif
+
+public:
+    SpeedMapper();
+
+    inline int percentToPWM(int percent) const
+    {
+        if (percent < 0)
+            percent = 0;
+        if (percent > 100)
+            percent = 100;
+#if MAPPING_KERNEL == MAPPING_KERNEL_LUT
+        return pwmTable[percent];
+#else
+        return (int)pwmMap.apply(percent);
+#endif
+    }
+};
+
+#endif
@@ -0,0 +1,213 @@
+#include "response_curve.h"
+#include <math.h>
+
+static const CurvePoint S_CURVE_POINTS[] = {{0, 0}, {25, 10}, {50, 50}, {75, 90}, {100, 100}};
+static const CurvePoint PRECISION_POINTS[] = {{0, 0}, {60, 25}, {85, 55}, {100, 100}};
+
+const CurveSpec SPEED_CURVE_PROFILES[] = {
+    {"linear", CURVE_EXPO, 0, nullptr, 0},
+    {"expo", CURVE_EXPO, SPEED_CURVE_EXPO_PERCENT, nullptr, 0},
+    {"s-curve", CURVE_SPLINE, 0, S_CURVE_POINTS, 5},
+    {"precision", CURVE_PIECEWISE, 0, PRECISION_POINTS, 4},
+};
+const int SPEED_CURVE_COUNT = sizeof(SPEED_CURVE_PROFILES) / sizeof(SPEED_CURVE_PROFILES[0]);
+
+static const CurveSpec LINEAR_FALLBACK = {"linear", CURVE_EXPO, 0, nullptr, 0};
+
+// Normalized shape, evaluated only while compiling a table
+class CurveShape
+{
+private:
+    const CurveSpec &spec;
+    float xs[CURVE_MAX_POINTS];
+    float ys[CURVE_MAX_POINTS];
+    float slopes[CURVE_MAX_POINTS]; // Spline tangents
+
+    void fitTangents();
+
+public:
+    CurveShape(const CurveSpec &spec) : spec(spec) {}
+
+    bool prepare();
+    float at(float t) const;
+};
+
+bool CurveShape::prepare()
+{
+    if (spec.kind == CURVE_EXPO)
+        return spec.expoPercent >= 0 && spec.expoPercent <= 100;
+
+    int n = spec.pointCount;
+    if (spec.points == nullptr || n < 2 || n > CURVE_MAX_POINTS)
+        return false;
+    if (spec.points[0].x != 0 || spec.points[0].y != 0 || spec.points[n - 1].x != 100 || spec.points[n - 1].y != 100)
+        return false;
+
+    for (int i = 0; i < n; i++)
+    {
+        if (i > 0 && (spec.points[i].x <= spec.points[i - 1].x || spec.points[i].y < spec.points[i - 1].y))
+            return false;
+        xs[i] = spec.points[i].x / 100.0f;
+        ys[i] = spec.points[i].y / 100.0f;
+    }
+
+    if (spec.kind == CURVE_SPLINE)
+        fitTangents();
+    return true;
+}
+
+// Fritsch-Carlson: secant-average tangents, flattened at plateaus and
+// limited so no segment overshoots, which keeps the spline monotonic
+void CurveShape::fitTangents()
+{
+    int n = spec.pointCount;
+    float secants[CURVE_MAX_POINTS] = {};
+    for (int i = 0; i < n - 1; i++)
+    {
+        secants[i] = (ys[i + 1] - ys[i]) / (xs[i + 1] - xs[i]);
+    }
+
+    slopes[0] = secants[0];
+    slopes[n - 1] = secants[n - 2];
+    for (int i = 1; i < n - 1; i++)
+    {
+        slopes[i] = (secants[i - 1] == 0.0f || secants[i] == 0.0f) ? 0.0f : (secants[i - 1] + secants[i]) / 2.0f;
+    }
+
+    for (int i = 0; i < n - 1; i++)
+    {
+        if (secants[i] == 0.0f)
+        {
+            slopes[i] = 0.0f;
+            slopes[i + 1] = 0.0f;
+            continue;
+        }
+
+        float a = slopes[i] / secants[i];
+        float b = slopes[i + 1] / secants[i];
+        float length = a * a + b * b;
+        if (length > 9.0f)
+        {
+            float tau = 3.0f / sqrtf(length);
+            slopes[i] = tau * a * secants[i];
+            slopes[i + 1] = tau * b * secants[i];
+        }
+    }
+}
+
+float CurveShape::at(float t) const
+{
+    if (spec.kind == CURVE_EXPO)
+    {
+        float expo = spec.expoPercent / 100.0f;
+        return (1.0f - expo) * t + expo * t * t * t;
+    }
+
+    int segment = 0;
+    while (segment < spec.pointCount - 2 && t > xs[segment + 1])
+    {
+        segment++;
+    }
+
+    float h = xs[segment + 1] - xs[segment];
+    float s = (t - xs[segment]) / h;
+    if (spec.kind == CURVE_PIECEWISE)
+        return ys[segment] + s * (ys[segment + 1] - ys[segment]);
+
+    // Cubic Hermite basis
+    float s2 = s * s;
+    float s3 = s2 * s;
+    return (2 * s3 - 3 * s2 + 1) * ys[segment] + (s3 - 2 * s2 + s) * h * slopes[segment] +
+           (-2 * s3 + 3 * s2) * ys[segment + 1] + (s3 - s2) * h * slopes[segment + 1];
+}
+
+CurveTable::CurveTable() : inStart(0), indexScale(0)
+{
+    for (int i = 0; i <= CURVE_SEGMENTS; i++)
+    {
+        table[i] = 0;
+    }
+}
+
+bool CurveTable::compile(const CurveSpec &spec, int inStart, int inEnd, int outMin, int outMax)
+{
+    if (inEnd <= inStart || outMin < 0 || outMax > 255 || outMax < outMin)
+        return false;
+
+    CurveShape shape(spec);
+    if (!shape.prepare())
+        return false;
+
+    for (int i = 0; i <= CURVE_SEGMENTS; i++)
+    {
+        float f = shape.at((float)i / CURVE_SEGMENTS);
+        f = f < 0.0f ? 0.0f : (f > 1.0f ? 1.0f : f);
+        long value = lroundf((outMin + (outMax - outMin) * f) * 256.0f);
+
+        // Exact end points, and rounding never makes the table fall
+        if (i == 0)
+            value = (long)outMin << 8;
+        else if (i == CURVE_SEGMENTS)
+            value = (long)outMax << 8;
+        else if (value < table[i - 1])
+            value = table[i - 1];
+        table[i] = (uint16_t)value;
+    }
+
+    // Rounded up so inEnd lands on the last entry, not just short of it
+    uint32_t span = (uint32_t)(inEnd - inStart);
+    this->inStart = inStart;
+    indexScale = (((uint32_t)CURVE_SEGMENTS << 16) + span - 1) / span;
+    return true;
+}
+
+ResponseCurveSet::ResponseCurveSet() : count(0), active(0)
+{
+    for (int i = 0; i < CURVE_MAX_PROFILES; i++)
+    {
+        names[i] = nullptr;
+    }
+}
+
+int ResponseCurveSet::begin(const CurveSpec *specs, int specCount, int inStart, int inEnd, int outMin, int outMax)
+{
+    count = 0;
+    for (int i = 0; i < specCount && count < CURVE_MAX_PROFILES; i++)
+    {
+        if (tables[count].compile(specs[i], inStart, inEnd, outMin, outMax))
+        {
+            names[count] = specs[i].name;
+            count++;
+        }
+    }
+
+    if (count == 0 && tables[0].compile(LINEAR_FALLBACK, inStart, inEnd, outMin, outMax))
+    {
+        names[0] = LINEAR_FALLBACK.name;
+        count = 1;
+    }
+
+    active.store(0, std::memory_order_release);
+    return count;
+}
+
+bool ResponseCurveSet::select(int profile)
+{
+    if (profile < 0 || profile >= count)
+        return false;
+
+    active.store(profile, std::memory_order_release);
+    return true;
+}
+
+int ResponseCurveSet::selectNext()
+{
+    int next = count > 0 ? (getActive() + 1) % count : 0;
+    active.store(next, std::memory_order_release);
+    return next;
+}
+
+const char *ResponseCurveSet::getName(int profile) const
+{
+    return (profile >= 0 && profile < count) ? names[profile] : "none";
+}
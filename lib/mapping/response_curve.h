@@ -0,0 +1,105 @@
+#ifndef RESPONSE_CURVE_H
+#define RESPONSE_CURVE_H
+
+#include "config.h"
+#include <atomic>
+#include <stdint.h>
+
+const int CURVE_SEGMENTS = 32;    // Table intervals (segments + 1 entries per profile)
+const int CURVE_MAX_POINTS = 8;   // Control points per spline or piecewise profile
+const int CURVE_MAX_PROFILES = 8;
+
+enum CurveKind
+{
+    CURVE_EXPO,      // (1 - e) * t + e * t^3
+    CURVE_SPLINE,    // Monotone cubic (Fritsch-Carlson) through the points
+    CURVE_PIECEWISE  // Straight lines between the points
+};
+
+// Control point in percent of input travel and of output range
+struct CurvePoint
+{
+    uint8_t x;
+    uint8_t y;
+};
+
+// Shape on normalized travel, 0..1 -> 0..1. Points run from (0, 0) to
+// (100, 100) with x strictly increasing and y never falling.
+struct CurveSpec
+{
+    const char *name;
+    CurveKind kind;
+    int expoPercent;          // CURVE_EXPO: 0 linear .. 100 fully cubic
+    const CurvePoint *points; // CURVE_SPLINE, CURVE_PIECEWISE
+    int pointCount;
+};
+
+// Built-in speed profiles (linear, expo, S-curve, precision)
+extern const CurveSpec SPEED_CURVE_PROFILES[];
+extern const int SPEED_CURVE_COUNT;
+
+// A curve compiled to CURVE_SEGMENTS linear pieces: inStart..inEnd maps to
+// outMin..outMax (0..255), inputs outside the span clamp to the ends. The
+// table is Q8 and forced monotonic, so evaluate() never decreases with x
+// and hits both end points exactly. One multiply, no division.
+class CurveTable
+{
+private:
+    uint16_t table[CURVE_SEGMENTS + 1]; // Output, Q8
+    int32_t inStart;
+    uint32_t indexScale; // Q16 table position per input count, rounded up
+
+public:
+    CurveTable();
+
+    bool compile(const CurveSpec &spec, int inStart, int inEnd, int outMin, int outMax);
+
+    inline int evaluate(int x) const
+    {
+        int32_t offset = x - inStart;
+        if (offset <= 0)
+            return (table[0] + 128) >> 8;
+
+        uint32_t position = (uint32_t)offset * indexScale;
+        uint32_t index = position >> 16;
+        if (index >= (uint32_t)CURVE_SEGMENTS)
+            return (table[CURVE_SEGMENTS] + 128) >> 8;
+
+        // Monotonic table: the rise is never negative
+        uint32_t low = table[index];
+        uint32_t rise = table[index + 1] - low;
+        uint32_t value = low + ((rise * (position & 0xFFFF)) >> 16);
+        return (int)((value + 128) >> 8);
+    }
+};
+
+// A set of curve profiles compiled once by begin(), with one of them
+// active. The tables never change afterwards, so select() is a single
+// atomic store: a control task evaluating while another task switches
+// sees either the old profile or the new one, never a mix.
+class ResponseCurveSet
+{
+private:
+    CurveTable tables[CURVE_MAX_PROFILES];
+    const char *names[CURVE_MAX_PROFILES];
+    int count;
+    std::atomic<int> active;
+
+public:
+    ResponseCurveSet();
+
+    // Specs that do not compile are skipped; falls back to a single linear
+    // profile if none does. Returns the number of profiles kept.
+    int begin(const CurveSpec *specs, int specCount, int inStart, int inEnd, int outMin, int outMax);
+
+    bool select(int profile);
+    int selectNext(); // Wraps around; returns the new profile
+
+    int getActive() const { return active.load(std::memory_order_relaxed); }
+    int getCount() const { return count; }
+    const char *getName(int profile) const;
+
+    inline int evaluate(int x) const { return tables[active.load(std::memory_order_acquire)].evaluate(x); }
+};
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef ENCODER_SOURCE_H
+#define ENCODER_SOURCE_H
+
+#include <stdint.h>
+
+// Motor shaft position feedback (PCNT quadrature decoder, simulated plant)
+class EncoderSource
+{
+public:
+    virtual ~EncoderSource() {}
+
+    virtual bool begin() = 0;
+
+    // Accumulated count, four per encoder line, positive turning forward.
+    // Callers take differences, so wrap-around is harmless.
+    virtual int32_t readCount() = 0;
+};
+
+#endif
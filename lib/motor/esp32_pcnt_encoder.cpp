@@ -0,0 +1,101 @@
+#ifdef ESP32
+
+#include "esp32_pcnt_encoder.h"
+#include <Arduino.h>
+#include <driver/pcnt.h>
+
+Esp32PcntEncoder::Esp32PcntEncoder(int pinA, int pinB, int unit, int16_t limit, uint16_t filterCycles)
+    : pinA(pinA), pinB(pinB), unit(unit), limit(limit), filterCycles(filterCycles), overflow(0), running(false)
+{
+}
+
+void IRAM_ATTR Esp32PcntEncoder::overflowIsr(void *arg)
+{
+    Esp32PcntEncoder *self = static_cast<Esp32PcntEncoder *>(arg);
+    uint32_t status = 0;
+    pcnt_get_event_status((pcnt_unit_t)self->unit, &status);
+
+    if (status & PCNT_EVT_H_LIM)
+    {
+        self->overflow.fetch_add(self->limit, std::memory_order_relaxed);
+    }
+    else if (status & PCNT_EVT_L_LIM)
+    {
+        self->overflow.fetch_sub(self->limit, std::memory_order_relaxed);
+    }
+}
+
+bool Esp32PcntEncoder::begin()
+{
+    if (running)
+        return true;
+
+    pcnt_unit_t pcntUnit = (pcnt_unit_t)unit;
+
+    // Channel 0 counts A edges, direction from B; channel 1 the reverse
+    pcnt_config_t config = {};
+    config.unit = pcntUnit;
+    config.channel = PCNT_CHANNEL_0;
+    config.pulse_gpio_num = pinA;
+    config.ctrl_gpio_num = pinB;
+    config.pos_mode = PCNT_COUNT_DEC;
+    config.neg_mode = PCNT_COUNT_INC;
+    config.lctrl_mode = PCNT_MODE_REVERSE;
+    config.hctrl_mode = PCNT_MODE_KEEP;
+    config.counter_h_lim = limit;
+    config.counter_l_lim = -limit;
+    if (pcnt_unit_config(&config) != ESP_OK)
+    {
+        Serial.println("ERROR: PCNT encoder config failed!");
+        return false;
+    }
+
+    config.channel = PCNT_CHANNEL_1;
+    config.pulse_gpio_num = pinB;
+    config.ctrl_gpio_num = pinA;
+    config.pos_mode = PCNT_COUNT_INC;
+    config.neg_mode = PCNT_COUNT_DEC;
+    pcnt_unit_config(&config);
+
+    pcnt_set_filter_value(pcntUnit, filterCycles);
+    pcnt_filter_enable(pcntUnit);
+
+    pcnt_event_enable(pcntUnit, PCNT_EVT_H_LIM);
+    pcnt_event_enable(pcntUnit, PCNT_EVT_L_LIM);
+    pcnt_counter_pause(pcntUnit);
+    pcnt_counter_clear(pcntUnit);
+    overflow.store(0);
+
+    // The service may already be installed by another unit
+    esp_err_t installed = pcnt_isr_service_install(0);
+    if ((installed != ESP_OK && installed != ESP_ERR_INVALID_STATE) ||
+        pcnt_isr_handler_add(pcntUnit, overflowIsr, this) != ESP_OK)
+    {
+        Serial.println("ERROR: PCNT interrupt setup failed!");
+        return false;
+    }
+
+    pcnt_counter_resume(pcntUnit);
+    running = true;
+    return true;
+}
+
+int32_t Esp32PcntEncoder::readCount()
+{
+    if (!running)
+        return 0;
+
+    // Retry if an overflow interrupt lands between the two reads
+    int32_t before, after;
+    int16_t counter = 0;
+    do
+    {
+        before = overflow.load(std::memory_order_relaxed);
+        pcnt_get_counter_value((pcnt_unit_t)unit, &counter);
+        after = overflow.load(std::memory_order_relaxed);
+    } while (before != after);
+
+    return before + counter;
+}
+
+#endif
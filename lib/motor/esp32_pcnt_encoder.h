@@ -0,0 +1,32 @@
+#ifndef ESP32_PCNT_ENCODER_H
+#define ESP32_PCNT_ENCODER_H
+
+#include "encoder_source.h"
+#include <atomic>
+
+// Quadrature decoding in the PCNT peripheral: both channels of one unit
+// count every edge of A and B (x4), with the hardware glitch filter on.
+// The 16-bit counter resets at +/-limit; an interrupt folds each reset
+// into a software accumulator, so the count never saturates and no CPU
+// time is spent per edge.
+class Esp32PcntEncoder : public EncoderSource
+{
+private:
+    int pinA;
+    int pinB;
+    int unit;
+    int16_t limit;
+    uint16_t filterCycles;
+    std::atomic<int32_t> overflow;
+    bool running;
+
+    static void overflowIsr(void *arg);
+
+public:
+    Esp32PcntEncoder(int pinA, int pinB, int unit, int16_t limit, uint16_t filterCycles);
+
+    bool begin() override;
+    int32_t readCount() override;
+};
+
+#endif
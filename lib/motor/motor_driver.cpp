@@ -0,0 +1,256 @@
+#include "motor_driver.h"
+#include <Arduino.h>
+#include <stdlib.h>
+
+#ifdef ESP32
+#include "esp32_pcnt_encoder.h"
+static Esp32PcntEncoder pcntEncoder(ENCODER_A_PIN, ENCODER_B_PIN, ENCODER_PCNT_UNIT, ENCODER_PCNT_LIMIT,
+                                    ENCODER_FILTER_CYCLES);
+#endif
+
+static const uint32_t SPEED_PERIOD_US = 1000000UL / SPEED_PID_RATE_HZ;
+
+#if MOTOR_USE_LEDC_FADE
+#include <driver/ledc.h>
+
+// arduino-esp32 maps channels 0-7 to the high-speed group, 8-15 to low speed
+static const ledc_mode_t FADE_SPEED_MODE = (ledc_mode_t)(PWM_CHANNEL / 8);
+static const ledc_channel_t FADE_CHANNEL = (ledc_channel_t)(PWM_CHANNEL % 8);
+#endif
+
+MotorDriver::MotorDriver()
+    : appliedDirection(MOTOR_STOP), appliedDuty(0), fading(false), fadeEndUs(0),
+      encoder(nullptr), closedLoop(false), speedPrimed(false), lastCount(0), lastSpeedUs(0), nextSpeedUs(0),
+      measuredSpeed(0), loopTrim(0)
+{
+}
+
+void MotorDriver::setEncoder(EncoderSource *source)
+{
+    encoder = source;
+}
+
+void MotorDriver::begin()
+{
+    pinMode(MOTOR_IN1_PIN, OUTPUT);
+    pinMode(MOTOR_IN2_PIN, OUTPUT);
+    writeDirection(MOTOR_STOP);
+
+    ledcSetup(PWM_CHANNEL, PWM_FREQUENCY, PWM_RESOLUTION);
+    ledcAttachPin(MOTOR_ENA_PIN, PWM_CHANNEL);
+    ledcWrite(PWM_CHANNEL, 0);
+
+#ifdef ESP32
+    if (encoder == nullptr && MOTOR_CLOSED_LOOP)
+    {
+        encoder = &pcntEncoder;
+    }
+#endif
+    if (encoder != nullptr && !encoder->begin())
+    {
+        Serial.println("ERROR: Encoder unavailable, running open loop");
+        encoder = nullptr;
+    }
+    closedLoop = MOTOR_CLOSED_LOOP && encoder != nullptr;
+
+#if MOTOR_USE_LEDC_FADE
+    if (!closedLoop)
+    {
+        ledc_fade_func_install(0);
+    }
+#endif
+
+    Serial.print("Motor driver initialized (slew ");
+    Serial.print(planner.getSlewRate());
+    Serial.print(" counts/s");
+    if (closedLoop)
+    {
+        Serial.print(", closed loop at ");
+        Serial.print(SPEED_PID_RATE_HZ);
+        Serial.print(" Hz");
+    }
+    else if (MOTOR_USE_LEDC_FADE)
+    {
+        Serial.print(", hardware fade");
+    }
+    Serial.println(")");
+}
+
+void MotorDriver::apply(const SimpleMotorCommand &command)
+{
+    planner.setTarget(command.direction, command.speedPWM);
+}
+
+void MotorDriver::stop()
+{
+    planner.setTarget(MOTOR_STOP, 0);
+}
+
+void MotorDriver::emergencyStop()
+{
+    planner.stopNow();
+    pid.reset();
+    loopTrim = 0;
+    writeDirection(MOTOR_STOP);
+#if MOTOR_USE_LEDC_FADE
+    // Cancels a fade in flight
+    ledc_stop(FADE_SPEED_MODE, FADE_CHANNEL, 0);
+    fading = false;
+#endif
+    writeDuty(0);
+}
+
+MotorOutput MotorDriver::update(uint32_t nowUs)
+{
+    MotorOutput output = planner.update(nowUs);
+    bool speedStep = encoder != nullptr && updateSpeed(nowUs);
+
+    if (closedLoop)
+    {
+        output.duty = closedLoopDuty(speedStep);
+    }
+
+    if (MOTOR_USE_LEDC_FADE && !closedLoop)
+    {
+        updateFade(nowUs);
+    }
+    else
+    {
+        writeOutput(output);
+    }
+
+    return output;
+}
+
+// Samples the encoder once per speed period; true when a new measurement
+// was taken
+bool MotorDriver::updateSpeed(uint32_t nowUs)
+{
+    if (!speedPrimed)
+    {
+        lastCount = encoder->readCount();
+        lastSpeedUs = nowUs;
+        nextSpeedUs = nowUs + SPEED_PERIOD_US;
+        speedPrimed = true;
+        return false;
+    }
+
+    if ((int32_t)(nowUs - nextSpeedUs) < 0)
+        return false;
+
+    int32_t count = encoder->readCount();
+    uint32_t elapsed = nowUs - lastSpeedUs;
+    measuredSpeed = (int)((int64_t)(count - lastCount) * 1000000 / (int64_t)elapsed);
+    lastCount = count;
+    lastSpeedUs = nowUs;
+
+    // Keep the average rate; resynchronise after a stall
+    nextSpeedUs += SPEED_PERIOD_US;
+    if ((int32_t)(nowUs - nextSpeedUs) >= 0)
+    {
+        nextSpeedUs = nowUs + SPEED_PERIOD_US;
+    }
+    return true;
+}
+
+// The ramped duty is both the speed target and the feed-forward term. The
+// PID runs on magnitudes along the ramped direction, so its output never
+// reverses the motor by itself. Between PID steps the ramp keeps moving
+// and the last correction rides on top of it.
+int MotorDriver::closedLoopDuty(bool pidStep)
+{
+    int planned = abs(planner.getDuty());
+    if (planned == 0)
+    {
+        pid.reset();
+        loopTrim = 0;
+        return 0;
+    }
+
+    if (pidStep)
+    {
+        int32_t setpoint = (int32_t)planned * MOTOR_MAX_COUNTS_PER_SEC / MAX_SPEED;
+        int32_t measured = planner.getDuty() > 0 ? measuredSpeed : -measuredSpeed;
+        loopTrim = pid.update(setpoint, measured, planned) - planned;
+    }
+    return constrain(planned + loopTrim, 0, MAX_SPEED);
+}
+
+void MotorDriver::writeOutput(const MotorOutput &output)
+{
+    int duty = output.direction == MOTOR_BACKWARD ? -output.duty : output.duty;
+    if (output.direction != appliedDirection)
+    {
+        // The ramp passes through zero, so the bridge never flips under load
+        if (output.direction == MOTOR_STOP)
+        {
+            writeDuty(0);
+            writeDirection(MOTOR_STOP);
+        }
+        else
+        {
+            writeDirection(output.direction);
+            writeDuty(duty);
+        }
+    }
+    else if (duty != appliedDuty)
+    {
+        writeDuty(duty);
+    }
+}
+
+// Hands the next stretch of the ramp to the LEDC fade engine once the
+// previous one has finished. Each chunk ends at zero when reversing, so
+// the direction pins only change with the output already at zero.
+void MotorDriver::updateFade(uint32_t nowUs)
+{
+#if MOTOR_USE_LEDC_FADE
+    if (fading && (int32_t)(nowUs - fadeEndUs) < 0)
+        return;
+    fading = false;
+
+    int next = planner.dutyAfter(MOTOR_FADE_CHUNK_US);
+    if (next == appliedDuty)
+    {
+        if (next == 0 && appliedDirection != MOTOR_STOP)
+        {
+            writeDirection(MOTOR_STOP);
+        }
+        return;
+    }
+
+    if (appliedDuty == 0)
+    {
+        writeDirection(next > 0 ? MOTOR_FORWARD : MOTOR_BACKWARD);
+    }
+
+    uint32_t fadeMs = (uint32_t)abs(next - appliedDuty) * 1000UL / (uint32_t)planner.getSlewRate();
+    if (fadeMs == 0)
+    {
+        writeDuty(next);
+        return;
+    }
+
+    ledc_set_fade_with_time(FADE_SPEED_MODE, FADE_CHANNEL, (uint32_t)abs(next), (int)fadeMs);
+    ledc_fade_start(FADE_SPEED_MODE, FADE_CHANNEL, LEDC_FADE_NO_WAIT);
+    appliedDuty = next;
+    fadeEndUs = nowUs + fadeMs * 1000UL;
+    fading = true;
+#else
+    (void)nowUs;
+#endif
+}
+
+void MotorDriver::writeDirection(MotorDirection direction)
+{
+    // Both inputs low lets the motor coast
+    digitalWrite(MOTOR_IN1_PIN, direction == MOTOR_FORWARD ? HIGH : LOW);
+    digitalWrite(MOTOR_IN2_PIN, direction == MOTOR_BACKWARD ? HIGH : LOW);
+    appliedDirection = direction;
+}
+
+void MotorDriver::writeDuty(int duty)
+{
+    ledcWrite(PWM_CHANNEL, (uint32_t)abs(duty));
+    appliedDuty = duty;
+}
@@ -0,0 +1,78 @@
+#ifndef MOTOR_DRIVER_H
+#define MOTOR_DRIVER_H
+
+#include "config.h"
+#include "control_mapper.h"
+#include "encoder_source.h"
+#include "ramp_planner.h"
+#include "speed_pid.h"
+#include <stdint.h>
+
+#if MOTOR_HARDWARE_FADE && defined(ESP32)
+#define MOTOR_USE_LEDC_FADE 1
+#else
+#define MOTOR_USE_LEDC_FADE 0
+#endif
+
+// H-bridge output stage: IN1/IN2 select the direction, ENA carries the
+// LEDC PWM duty. apply() only sets the target; update() advances the ramp
+// from the control loop and never waits. Direction pins change only while
+// the duty is zero. With MOTOR_HARDWARE_FADE the LEDC fade engine runs the
+// ramp in chunks of up to MOTOR_FADE_CHUNK_US, so a new target is picked up
+// at the end of the current chunk.
+//
+// With an encoder attached, the shaft speed is measured every
+// SPEED_PID_RATE_HZ period. With MOTOR_CLOSED_LOOP the ramped duty then
+// sets the target speed (full duty = MOTOR_MAX_COUNTS_PER_SEC) and is fed
+// forward into a PID that sets the actual duty; direction changes still
+// follow the ramp through zero. Closed loop bypasses the hardware fade.
+class MotorDriver
+{
+private:
+    RampPlanner planner;
+    MotorDirection appliedDirection;
+    int appliedDuty; // Signed, as last written (or faded to)
+    bool fading;
+    uint32_t fadeEndUs;
+
+    EncoderSource *encoder;
+    SpeedPid pid;
+    bool closedLoop;
+    bool speedPrimed;
+    int32_t lastCount;
+    uint32_t lastSpeedUs;
+    uint32_t nextSpeedUs;
+    int measuredSpeed; // Counts/s, signed
+    int loopTrim;      // PID output minus feed-forward, held between PID steps
+
+    void writeOutput(const MotorOutput &output);
+    void writeDirection(MotorDirection direction);
+    void writeDuty(int duty);
+    void updateFade(uint32_t nowUs);
+    bool updateSpeed(uint32_t nowUs);
+    int closedLoopDuty(bool pidStep);
+
+public:
+    MotorDriver();
+
+    // Before begin(); on the ESP32 the PCNT encoder is used when closed
+    // loop is enabled and no source was set
+    void setEncoder(EncoderSource *source);
+
+    void begin();
+    void apply(const SimpleMotorCommand &command);
+    MotorOutput update(uint32_t nowUs);
+
+    // Ramped stop
+    void stop();
+    // Duty to zero at once, bypassing the ramp
+    void emergencyStop();
+
+    int getDuty() const { return appliedDuty; }
+    int getTarget() const { return planner.getTarget(); }
+    int getMeasuredSpeed() const { return measuredSpeed; }
+    bool hasEncoder() const { return encoder != nullptr; }
+    bool isClosedLoop() const { return closedLoop; }
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include "ramp_planner.h"
+#include <stdlib.h>
+
+static const uint32_t MICROS_PER_SECOND = 1000000UL;
+
+static int sign(int value)
+{
+    return (value > 0) - (value < 0);
+}
+
+RampPlanner::RampPlanner(int slewRate, uint32_t reverseDeadTimeUs)
+    : slewRate(slewRate), reverseDeadTimeUs(reverseDeadTimeUs), target(0), current(0), remainder(0),
+      lastUs(0), zeroSinceUs(0), lastSign(0), started(false)
+{
+}
+
+void RampPlanner::setTarget(MotorDirection direction, int duty)
+{
+    if (duty < 0)
+        duty = 0;
+    if (duty > MAX_SPEED)
+        duty = MAX_SPEED;
+    target = direction == MOTOR_FORWARD ? duty : direction == MOTOR_BACKWARD ? -duty : 0;
+}
+
+// Next point the duty heads for: zero first when the target is on the
+// other side of it
+int RampPlanner::waypoint() const
+{
+    if (sign(current) * sign(target) < 0)
+        return 0;
+    return target;
+}
+
+MotorOutput RampPlanner::update(uint32_t nowUs)
+{
+    if (!started)
+    {
+        lastUs = nowUs;
+        zeroSinceUs = nowUs;
+        started = true;
+    }
+
+    uint32_t elapsed = nowUs - lastUs;
+    lastUs = nowUs;
+
+    int goal = waypoint();
+
+    // Leaving zero against the last direction waits out the dead time
+    if (current == 0 && goal != 0 && lastSign != 0 && sign(goal) != lastSign)
+    {
+        if (nowUs - zeroSinceUs < reverseDeadTimeUs)
+        {
+            goal = 0;
+        }
+        else
+        {
+            lastSign = 0;
+        }
+    }
+
+    if (current == goal)
+    {
+        remainder = 0;
+    }
+    else
+    {
+        uint64_t budget = remainder + (uint64_t)elapsed * (uint32_t)slewRate;
+        int distance = abs(goal - current);
+        if (budget >= (uint64_t)distance * MICROS_PER_SECOND)
+        {
+            current = goal;
+            remainder = 0;
+        }
+        else
+        {
+            current += sign(goal - current) * (int)(budget / MICROS_PER_SECOND);
+            remainder = (uint32_t)(budget % MICROS_PER_SECOND);
+        }
+
+        if (current == 0)
+        {
+            zeroSinceUs = nowUs;
+        }
+        else
+        {
+            lastSign = sign(current);
+        }
+    }
+
+    MotorOutput output;
+    output.direction = current > 0 ? MOTOR_FORWARD : current < 0 ? MOTOR_BACKWARD : MOTOR_STOP;
+    output.duty = abs(current);
+    return output;
+}
+
+void RampPlanner::stopNow()
+{
+    target = 0;
+    current = 0;
+    remainder = 0;
+    zeroSinceUs = lastUs;
+}
+
+int RampPlanner::dutyAfter(uint32_t elapsedUs) const
+{
+    int goal = waypoint();
+
+    if (current == 0 && goal != 0 && lastSign != 0 && sign(goal) != lastSign)
+    {
+        uint32_t held = lastUs - zeroSinceUs;
+        uint32_t hold = held < reverseDeadTimeUs ? reverseDeadTimeUs - held : 0;
+        if (elapsedUs <= hold)
+            return 0;
+        elapsedUs -= hold;
+    }
+
+    uint64_t budget = remainder + (uint64_t)elapsedUs * (uint32_t)slewRate;
+    int distance = abs(goal - current);
+    if (budget >= (uint64_t)distance * MICROS_PER_SECOND)
+        return goal;
+    return current + sign(goal - current) * (int)(budget / MICROS_PER_SECOND);
+}
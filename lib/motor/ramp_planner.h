@@ -0,0 +1,53 @@
+#ifndef RAMP_PLANNER_H
+#define RAMP_PLANNER_H
+
+#include "config.h"
+#include <stdint.h>
+
+struct MotorOutput
+{
+    MotorDirection direction;
+    int duty; // 0 to MAX_SPEED
+};
+
+// Time-based slew limiter for the motor duty cycle. The duty is kept
+// signed (positive forward, negative backward) and moves toward the target
+// by at most slewRate counts per second of elapsed time, whatever the call
+// rate; sub-count progress carries over between calls. A direction change
+// always ramps through zero and holds there for reverseDeadTimeUs before
+// starting the other way. Pure logic: time comes in through update().
+class RampPlanner
+{
+private:
+    int slewRate;              // Duty counts per second
+    uint32_t reverseDeadTimeUs;
+    int target;                // Signed duty
+    int current;               // Signed duty
+    uint32_t remainder;        // Progress below one count, in count-microseconds
+    uint32_t lastUs;
+    uint32_t zeroSinceUs;      // When the duty last reached zero
+    int lastSign;              // Sign of the last non-zero duty, 0 once free to reverse
+    bool started;
+
+    int waypoint() const;
+
+public:
+    RampPlanner(int slewRate = MOTOR_SLEW_RATE, uint32_t reverseDeadTimeUs = MOTOR_REVERSE_DEAD_TIME_US);
+
+    void setTarget(MotorDirection direction, int duty);
+    MotorOutput update(uint32_t nowUs);
+
+    // Drops the duty to zero at once (fault or calibration), no ramp
+    void stopNow();
+
+    // Signed duty after another elapsedUs, stopping at zero when reversing
+    // (for handing a ramp segment to the LEDC fade engine)
+    int dutyAfter(uint32_t elapsedUs) const;
+
+    int getSlewRate() const { return slewRate; }
+    int getTarget() const { return target; }
+    int getDuty() const { return current; }
+    bool isSettled() const { return current == target; }
+};
+
+#endif
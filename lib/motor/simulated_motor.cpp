@@ -0,0 +1,58 @@
+#include "simulated_motor.h"
+#include <math.h>
+
+static const uint32_t SIM_STEP_US = 100;
+
+SimulatedDcMotor::SimulatedDcMotor(float maxSpeed, float timeConstant, float friction)
+    : maxSpeed(maxSpeed), timeConstant(timeConstant), friction(friction), load(0.0f), speed(0.0f),
+      position(0.0), lastUs(0), started(false)
+{
+}
+
+void SimulatedDcMotor::advance(uint32_t nowUs, int signedDuty)
+{
+    if (!started)
+    {
+        lastUs = nowUs;
+        started = true;
+        return;
+    }
+
+    float drive = (float)signedDuty / MAX_SPEED;
+    uint32_t elapsed = nowUs - lastUs;
+    lastUs = nowUs;
+
+    while (elapsed >= SIM_STEP_US)
+    {
+        step(SIM_STEP_US * 1e-6f, drive);
+        elapsed -= SIM_STEP_US;
+    }
+    if (elapsed > 0)
+    {
+        step(elapsed * 1e-6f, drive);
+    }
+}
+
+void SimulatedDcMotor::step(float dt, float drive)
+{
+    // Friction and load oppose the motion (or the drive, when stopped)
+    float direction = speed != 0.0f ? (speed > 0.0f ? 1.0f : -1.0f) : (drive > 0.0f ? 1.0f : -1.0f);
+    float opposing = friction + load;
+
+    if (speed == 0.0f && fabsf(drive) <= opposing)
+        return;
+
+    float next = speed + (maxSpeed * (drive - direction * opposing) - speed) * dt / timeConstant;
+
+    // Friction stops the shaft rather than reversing it
+    if (speed != 0.0f && next * speed < 0.0f)
+        next = 0.0f;
+
+    position += 0.5 * (speed + next) * dt;
+    speed = next;
+}
+
+int32_t SimulatedDcMotor::readCount()
+{
+    return (int32_t)(int64_t)floor(position);
+}
@@ -0,0 +1,42 @@
+#ifndef SIMULATED_MOTOR_H
+#define SIMULATED_MOTOR_H
+
+#include "config.h"
+#include "encoder_source.h"
+#include <stdint.h>
+
+// First-order DC motor model for host runs of the speed loop. Speed in
+// encoder counts per second approaches maxSpeed * (duty - friction - load)
+// with the mechanical time constant; below the friction level a stopped
+// shaft stays stopped. Load is a fraction of full-scale torque, so 0.3
+// drops the open-loop speed by 30% of maxSpeed. Integrates in fixed
+// sub-steps; time comes in through advance() like SimulatedClock.
+class SimulatedDcMotor : public EncoderSource
+{
+private:
+    float maxSpeed;      // Counts/s at full duty, no load
+    float timeConstant;  // Seconds
+    float friction;      // Fraction of full-scale torque
+    float load;          // Fraction of full-scale torque, opposing motion
+    float speed;         // Counts/s
+    double position;     // Counts
+    uint32_t lastUs;
+    bool started;
+
+    void step(float dt, float drive);
+
+public:
+    SimulatedDcMotor(float maxSpeed = MOTOR_MAX_COUNTS_PER_SEC, float timeConstant = 0.05f, float friction = 0.04f);
+
+    void setLoad(float fraction) { load = fraction; }
+
+    // Runs the model up to nowUs with the given signed duty applied
+    void advance(uint32_t nowUs, int signedDuty);
+
+    bool begin() override { return true; }
+    int32_t readCount() override;
+
+    float getSpeed() const { return speed; }
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "speed_pid.h"
+
+// Errors are clamped so that each Q16 gain-times-error product fits in
+// int32 for gains below 1.0; the sum is formed in 64 bits
+static const int32_t ERROR_LIMIT = 32767;
+
+static int32_t toQ16(float value)
+{
+    return (int32_t)(value * 65536.0f + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+static int32_t clampError(int32_t value)
+{
+    return value > ERROR_LIMIT ? ERROR_LIMIT : value < -ERROR_LIMIT ? -ERROR_LIMIT : value;
+}
+
+SpeedPid::SpeedPid(float kp, float ki, float kd, int rateHz, int maxOutput)
+    : kp(toQ16(kp)), kiStep(toQ16(ki / rateHz)), kdStep(toQ16(kd * rateHz)), maxOutput(maxOutput)
+{
+    reset();
+}
+
+void SpeedPid::reset()
+{
+    integral = 0;
+    lastMeasured = 0;
+    primed = false;
+}
+
+int SpeedPid::update(int32_t setpoint, int32_t measured, int feedForward)
+{
+    int32_t error = clampError(setpoint - measured);
+    int32_t change = primed ? clampError(measured - lastMeasured) : 0;
+    lastMeasured = measured;
+    primed = true;
+
+    const int32_t maxQ16 = (int32_t)maxOutput << 16;
+    int64_t base = ((int64_t)feedForward << 16) + (int64_t)kp * error - (int64_t)kdStep * change;
+
+    // Conditional integration: skip the step that would wind further into
+    // saturation
+    int64_t candidate = (int64_t)integral + (int64_t)kiStep * error;
+    if (candidate > maxQ16)
+        candidate = maxQ16;
+    if (candidate < -maxQ16)
+        candidate = -maxQ16;
+
+    int64_t output = base + candidate;
+    if ((output > maxQ16 && error > 0) || (output < 0 && error < 0))
+    {
+        output = base + integral;
+    }
+    else
+    {
+        integral = (int32_t)candidate;
+    }
+
+    if (output <= 0)
+        return 0;
+    if (output >= maxQ16)
+        return maxOutput;
+    return (int)((output + 0x8000) >> 16);
+}
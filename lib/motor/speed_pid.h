@@ -0,0 +1,38 @@
+#ifndef SPEED_PID_H
+#define SPEED_PID_H
+
+#include "config.h"
+#include <stdint.h>
+
+// Fixed-point PI-D speed controller stepped at a fixed rate. Speeds are in
+// encoder counts per second, the output in PWM duty counts. The mapped
+// open-loop duty comes in as feed-forward, so the loop only trims the
+// error left by load and supply changes.
+//   - Gains are Q16, with the step period folded into Ki and Kd.
+//   - Derivative acts on the measurement, so setpoint steps do not kick.
+//   - Anti-windup: the integrator stops while the output is saturated in
+//     the direction the error pushes, and is clamped to the output range.
+class SpeedPid
+{
+private:
+    int32_t kp;       // Q16 duty per count/s
+    int32_t kiStep;   // Q16 duty per count/s, per step
+    int32_t kdStep;   // Q16 duty per count/s change, per step
+    int32_t integral; // Q16 duty
+    int32_t lastMeasured;
+    int maxOutput;
+    bool primed;
+
+public:
+    SpeedPid(float kp = SPEED_PID_KP, float ki = SPEED_PID_KI, float kd = SPEED_PID_KD,
+             int rateHz = SPEED_PID_RATE_HZ, int maxOutput = MAX_SPEED);
+
+    void reset();
+
+    // One control step; returns the duty, 0 to maxOutput
+    int update(int32_t setpoint, int32_t measured, int feedForward);
+
+    int getIntegral() const { return (int)(integral >> 16); }
+};
+
+#endif
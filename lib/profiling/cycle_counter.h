@@ -0,0 +1,23 @@
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include <stdint.h>
+
+#if defined(__XTENSA__)
+// CCOUNT ticks once per CPU clock and is per core; probes start and stop
+// on the same core because the tasks are pinned
+inline uint32_t readCycleCount()
+{
+    uint32_t cycles;
+    __asm__ __volatile__("rsr %0, ccount" : "=a"(cycles));
+    return cycles;
+}
+#else
+// Host: replaceable so tests can drive a fake counter; the default is the
+// host clock scaled to PROFILE_CPU_MHZ cycles per microsecond
+typedef uint32_t (*CycleCounterFn)();
+void setCycleCounter(CycleCounterFn counter);
+uint32_t readCycleCount();
+#endif
+
+#endif
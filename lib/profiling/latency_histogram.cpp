@@ -0,0 +1,94 @@
+#include "latency_histogram.h"
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+void LatencyHistogram::reset()
+{
+    for (int i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        buckets[i] = 0;
+    }
+    count = 0;
+    minCycles = UINT32_MAX;
+    maxCycles = 0;
+    totalCycles = 0;
+}
+
+int LatencyHistogram::bucketFor(uint32_t cycles)
+{
+    return 31 - __builtin_clz(cycles | 1);
+}
+
+void LatencyHistogram::record(uint32_t cycles)
+{
+    buckets[bucketFor(cycles)]++;
+    count++;
+    totalCycles += cycles;
+    if (cycles < minCycles)
+        minCycles = cycles;
+    if (cycles > maxCycles)
+        maxCycles = cycles;
+}
+
+uint32_t LatencyHistogram::getCount() const
+{
+    return count;
+}
+
+uint32_t LatencyHistogram::getMin() const
+{
+    return count > 0 ? minCycles : 0;
+}
+
+uint32_t LatencyHistogram::getMax() const
+{
+    return maxCycles;
+}
+
+uint32_t LatencyHistogram::getMean() const
+{
+    return count > 0 ? (uint32_t)(totalCycles / count) : 0;
+}
+
+uint32_t LatencyHistogram::getBucket(int bucket) const
+{
+    return (bucket >= 0 && bucket < LATENCY_BUCKETS) ? buckets[bucket] : 0;
+}
+
+uint32_t LatencyHistogram::percentile(int percent) const
+{
+    if (count == 0)
+        return 0;
+
+    // Rank of the wanted sample, 1-based
+    uint32_t rank = (uint32_t)(((uint64_t)count * percent + 99) / 100);
+    if (rank == 0)
+        rank = 1;
+
+    uint32_t seen = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++)
+    {
+        if (buckets[b] == 0)
+            continue;
+        if (seen + buckets[b] < rank)
+        {
+            seen += buckets[b];
+            continue;
+        }
+
+        // Linear position of the rank inside this bucket's range
+        uint64_t low = (b == 0) ? 0 : (1ULL << b);
+        uint64_t high = (2ULL << b) - 1;
+        uint64_t value = low + (high - low) * (rank - seen) / buckets[b];
+
+        if (value < getMin())
+            value = getMin();
+        if (value > maxCycles)
+            value = maxCycles;
+        return (uint32_t)value;
+    }
+    return maxCycles;
+}
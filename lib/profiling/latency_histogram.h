@@ -0,0 +1,37 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+
+const int LATENCY_BUCKETS = 32; // Bucket b holds [2^b, 2^(b+1)), bucket 0 also holds 0
+
+// Fixed-size log2 histogram of cycle counts. record() is a count-leading-
+// zeros and a few adds, cheap enough to leave in the control loop.
+// Percentiles interpolate inside the bucket, so they are approximate to
+// within a factor of two; min and max are exact.
+class LatencyHistogram
+{
+private:
+    uint32_t buckets[LATENCY_BUCKETS];
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+
+public:
+    LatencyHistogram();
+
+    void reset();
+    void record(uint32_t cycles);
+
+    static int bucketFor(uint32_t cycles);
+
+    uint32_t getCount() const;
+    uint32_t getMin() const;
+    uint32_t getMax() const;
+    uint32_t getMean() const;
+    uint32_t getBucket(int bucket) const;
+    uint32_t percentile(int percent) const;
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "profiler.h"
+
+#if PROFILING_ENABLED
+LatencyHistogram profileHistograms[PROFILE_STAGE_COUNT];
+#endif
+
+#if !defined(__XTENSA__)
+static uint32_t hostCycleCount()
+{
+    return (uint32_t)(micros() * (unsigned long)PROFILE_CPU_MHZ);
+}
+
+static CycleCounterFn cycleCounter = hostCycleCount;
+
+void setCycleCounter(CycleCounterFn counter)
+{
+    cycleCounter = counter != nullptr ? counter : hostCycleCount;
+}
+
+uint32_t readCycleCount()
+{
+    return cycleCounter();
+}
+#endif
+
+const char *profileStageName(ProfileStage stage)
+{
+    switch (stage)
+    {
+    case PROFILE_LOOP:
+        return "loop";
+    case PROFILE_SAMPLE:
+        return "sample";
+    case PROFILE_READ:
+        return "read";
+    case PROFILE_MAP:
+        return "map";
+    case PROFILE_MOTOR:
+        return "motor";
+    case PROFILE_LCD:
+        return "lcd";
+    case PROFILE_SERIAL:
+        return "serial";
+    default:
+        return "?";
+    }
+}
+
+LatencyHistogram *profileHistogram(ProfileStage stage)
+{
+#if PROFILING_ENABLED
+    return stage < PROFILE_STAGE_COUNT ? &profileHistograms[stage] : nullptr;
+#else
+    (void)stage;
+    return nullptr;
+#endif
+}
+
+void profileReset()
+{
+#if PROFILING_ENABLED
+    for (int i = 0; i < PROFILE_STAGE_COUNT; i++)
+    {
+        profileHistograms[i].reset();
+    }
+#endif
+}
+
+#if PROFILING_ENABLED
+// Cycles to microseconds with one decimal
+static void printMicros(Print &out, uint32_t cycles)
+{
+    uint32_t tenths = (uint32_t)(((uint64_t)cycles * 10 + PROFILE_CPU_MHZ / 2) / PROFILE_CPU_MHZ);
+    out.print((unsigned long)(tenths / 10));
+    out.print('.');
+    out.print((unsigned long)(tenths % 10));
+}
+#endif
+
+void profileDump(Print &out)
+{
+#if PROFILING_ENABLED
+    out.println("=== PROFILE (us) ===");
+    for (int i = 0; i < PROFILE_STAGE_COUNT; i++)
+    {
+        const LatencyHistogram &h = profileHistograms[i];
+        const char *name = profileStageName((ProfileStage)i);
+        out.print(name);
+        for (size_t pad = strlen(name); pad < 7; pad++)
+        {
+            out.print(' ');
+        }
+        out.print("n=");
+        out.print((unsigned long)h.getCount());
+        out.print(" min ");
+        printMicros(out, h.getMin());
+        out.print(" p50 ");
+        printMicros(out, h.percentile(50));
+        out.print(" p99 ");
+        printMicros(out, h.percentile(99));
+        out.print(" max ");
+        printMicros(out, h.getMax());
+        out.println();
+    }
+    out.println("====================");
+#else
+    out.println("Profiling disabled (build with -DPROFILING_ENABLED=1)");
+#endif
+}
@@ -0,0 +1,64 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "config.h"
+#include "cycle_counter.h"
+#include "latency_histogram.h"
+#include <Arduino.h>
+
+// Per-stage latency probes. With PROFILING_ENABLED 0 (the default)
+// PROFILE_SCOPE expands to nothing and no histogram storage exists.
+enum ProfileStage
+{
+    PROFILE_LOOP = 0, // Whole control step
+    PROFILE_SAMPLE,   // ADC sampling, decimation and correction
+    PROFILE_READ,     // joystick.read(): sampling through filtering
+    PROFILE_MAP,      // Speed/direction mapping
+    PROFILE_MOTOR,    // Ramp step and PWM output
+    PROFILE_LCD,      // LCD queueing and flush slice
+    PROFILE_SERIAL,   // Serial reporting
+    PROFILE_STAGE_COUNT
+};
+
+const char *profileStageName(ProfileStage stage);
+LatencyHistogram *profileHistogram(ProfileStage stage); // nullptr when disabled
+void profileReset();
+void profileDump(Print &out);
+
+// Records the cycles between construction and destruction. Each stage is
+// written by one task only; dumps from another task may see a histogram
+// mid-update, which only skews that one report.
+class ScopedProbe
+{
+private:
+    LatencyHistogram &histogram;
+    uint32_t start;
+
+    ScopedProbe(const ScopedProbe &);
+    ScopedProbe &operator=(const ScopedProbe &);
+
+public:
+    explicit ScopedProbe(LatencyHistogram &histogram)
+        : histogram(histogram), start(readCycleCount())
+    {
+    }
+
+    ~ScopedProbe()
+    {
+        histogram.record(readCycleCount() - start);
+    }
+};
+
+#if PROFILING_ENABLED
+extern LatencyHistogram profileHistograms[PROFILE_STAGE_COUNT];
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(stage) ScopedProbe PROFILE_CONCAT(profileProbe, __LINE__)(profileHistograms[stage])
+#else
+#define PROFILE_SCOPE(stage) \
+    do                       \
+    {                        \
+    } while (0)
+#endif
+
+#endif
@@ -4,9 +4,50 @@
 #include "runner.h"
 #include "joystick.h"
 #include "control_mapper.h"
+#include "motor_driver.h"
+#include "simulated_motor.h"
 #include "lcd.h"
+#include "fixed_rate_scheduler.h"
+#include "spsc_queue.h"
+#include "seqlock.h"
+#include "profiler.h"
+#include "telemetry.h"
+#include "logger.h"
 #include <Wire.h>
 #include <Arduino.h>
+#include <atomic>
+
+// Result of one control cycle, handed from the control task to the UI task.
+// Carries everything the UI shows, so the UI never reads the controller,
+// the filters or the scheduler while the control task updates them.
+struct ControlSnapshot
+{
+    JoystickPosition joy;
+    SimpleMotorCommand cmd;
+    int raw[JOYSTICK_AXES]; // Corrected ADC codes
+    int motorDuty;  // Applied PWM duty, negative when backward
+    int motorSpeed; // Encoder counts/s (0 without an encoder)
+    bool motorHasEncoder;
+    bool motorClosedLoop;
+    unsigned long timestamp;
+    CalibrationState calibrationState;
+
+    // Input diagnostics
+    float noise[JOYSTICK_AXES];        // At-rest std dev, ADC counts
+    float filterCutoff[JOYSTICK_AXES]; // Hz
+    unsigned long rejectedSamples; // Median outliers
+    unsigned long clippedSamples;  // Step-limited samples
+    int drift[JOYSTICK_AXES]; // Center drift, ADC counts
+    unsigned long rangeWidenings;
+
+    // Control loop timing (the tick before this one)
+    uint32_t loopLastUs;
+    uint32_t loopMaxUs;
+    unsigned long overruns;
+    unsigned long missedDeadlines;
+    unsigned long staleAdcTicks; // Reads that found no new ADC frame
+    unsigned long adcOverruns;   // ADC frames overwritten unread
+};
 
 class MainRunner : public Runner
 {
@@ -14,74 +55,395 @@ private:
     // Component instances
     JoystickController joystick;
     SimpleControlMapper mapper;
+    MotorDriver motor;
+#ifndef ESP32
+    SimulatedDcMotor motorPlant; // Host build: the motor the driver spins
+#endif
     LCDController lcdDisplay;
 
+    // Control loop timing
+    ArduinoClock clock;
+    FixedRateScheduler scheduler{&clock, 1000000UL / CONTROL_RATE_HZ};
+
+    // Control -> UI hand-off (lock-free, control side never waits)
+    Seqlock<ControlSnapshot> latestSnapshot;
+    SpscQueue<ControlSnapshot, COMMAND_QUEUE_DEPTH> commandEvents;
+    SpscQueue<CalibrationReport, 2> calibrationEvents; // Finished calibrations, to report and store
+    bool pipelineRunning = false;
+
     // Status tracking
     unsigned long lastStatusTime = 0;
+    CalibrationState shownCalibrationState = CAL_IDLE;
+    unsigned long readyTime = 0; // millis() when calibration finished
+    CalibrationReport calibrationResult = {}; // Last finished calibration (UI side)
+    std::atomic<bool> recalibrationRequested{false}; // Set by UI, consumed by control
     static const unsigned long STATUS_INTERVAL = 2000;
 
+    // Binary telemetry
+    uint16_t telemetrySequence = 0;
+    unsigned long lastTelemetryTime = 0;
+    unsigned long telemetryDropped = 0; // Frames skipped because the UART was busy
+
     // Helper methods
-    void printSystemStatus(const JoystickPosition &joy, const SimpleMotorCommand &cmd)
+    void printSystemStatus(const ControlSnapshot &snapshot)
     {
+        const JoystickPosition &joy = snapshot.joy;
+        const SimpleMotorCommand &cmd = snapshot.cmd;
+
         Serial.println("=== STATUS ===");
+        int x = joy.axis[AXIS_X];
         Serial.print("Joystick - X: ");
-        Serial.print(joy.x);
+        Serial.print(x);
         Serial.print(" (");
-        Serial.print(joy.x > DIRECTION_DEAD_ZONE ? "FORWARD" : joy.x < -DIRECTION_DEAD_ZONE ? "BACKWARD"
-                                                                                            : "NEUTRAL");
+        Serial.print(x > DIRECTION_DEAD_ZONE ? "FORWARD" : x < -DIRECTION_DEAD_ZONE ? "BACKWARD"
+                                                                                    : "NEUTRAL");
         Serial.print(") | Y: ");
-        Serial.print(joy.y);
+        Serial.print(joy.axis[AXIS_Y]);
         Serial.print(" (Speed: ");
         Serial.print(cmd.speedPercent);
         Serial.println("%)");
 
+        Serial.print("Motor duty: ");
+        Serial.print(snapshot.motorDuty);
+        Serial.print(" (target ");
+        Serial.print(cmd.direction == MOTOR_BACKWARD ? -cmd.speedPWM : cmd.direction == MOTOR_FORWARD ? cmd.speedPWM : 0);
+        Serial.print(")");
+        if (snapshot.motorHasEncoder)
+        {
+            Serial.print(" | Speed: ");
+            Serial.print(snapshot.motorSpeed);
+            Serial.print(" counts/s");
+            Serial.print(snapshot.motorClosedLoop ? " (closed loop)" : " (open loop)");
+        }
+        Serial.println();
+
+        Serial.print("Noise -");
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            Serial.print(axis == 0 ? " " : " | ");
+            Serial.print(AXIS_NAMES[axis]);
+            Serial.print(": ");
+            Serial.print(snapshot.noise[axis], 1);
+        }
+        Serial.print(" counts | Filter cutoff -");
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            Serial.print(axis == 0 ? " " : " | ");
+            Serial.print(AXIS_NAMES[axis]);
+            Serial.print(": ");
+            Serial.print(snapshot.filterCutoff[axis], 1);
+        }
+        Serial.print(" Hz | Glitches rejected: ");
+        Serial.print(snapshot.rejectedSamples);
+        Serial.print(" clipped: ");
+        Serial.println(snapshot.clippedSamples);
+
+        if (DRIFT_TRACKING_ENABLED)
+        {
+            Serial.print("Center drift -");
+            for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+            {
+                Serial.print(axis == 0 ? " " : " | ");
+                Serial.print(AXIS_NAMES[axis]);
+                Serial.print(": ");
+                Serial.print(snapshot.drift[axis]);
+            }
+            Serial.print(" counts | range widened: ");
+            Serial.println(snapshot.rangeWidenings);
+        }
+
+        if (TRACKER_ENABLED)
+        {
+            Serial.print("Velocity -");
+            for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+            {
+                Serial.print(axis == 0 ? " " : " | ");
+                Serial.print(AXIS_NAMES[axis]);
+                Serial.print(": ");
+                Serial.print(joy.velocity[axis]);
+            }
+            Serial.print(" units/s (lead ");
+            Serial.print(PIPELINE_DELAY_MS);
+            Serial.println(" ms)");
+        }
+
+        Serial.print("Boot-to-ready: ");
+        Serial.print(readyTime);
+        Serial.print(" ms (calibration ");
+        Serial.print(calibrationResult.elapsedMs);
+        if (calibrationResult.verified)
+        {
+            Serial.print(" ms, warm boot saved ");
+            Serial.print(calibrationResult.bootTimeSavedMs);
+        }
+        Serial.println(" ms)");
+
+        if (FIXED_RATE_LOOP)
+        {
+            Serial.print("Loop - ");
+            Serial.print(CONTROL_RATE_HZ);
+            Serial.print(" Hz | last: ");
+            Serial.print(snapshot.loopLastUs);
+            Serial.print(" us | max: ");
+            Serial.print(snapshot.loopMaxUs);
+            Serial.print(" us | overruns: ");
+            Serial.print(snapshot.overruns);
+            Serial.print(" | missed: ");
+            Serial.print(snapshot.missedDeadlines);
+            Serial.print(" | stale ADC: ");
+            Serial.print(snapshot.staleAdcTicks);
+            Serial.print(" | ADC overruns: ");
+            Serial.println(snapshot.adcOverruns);
+        }
+
+        const LcdFlushStats &lcdStats = lcdDisplay.getFlushStats();
+        Serial.print("LCD - last frame: ");
+        Serial.print(lcdStats.bytes);
+        Serial.print(" bytes (");
+        Serial.print(lcdStats.transactions);
+        Serial.println(" I2C bursts)");
+
         Serial.println("==============");
     }
 
     void initializeI2C()
     {
         // Initialize I2C with custom pins
-        Wire.begin(LCD_SDA_PIN, LCD_SCL_PIN);
+        Wire.begin(LCD_SDA_PIN, LCD_SCL_PIN, LCD_I2C_CLOCK);
+        Wire.setClock(LCD_I2C_CLOCK);
         Serial.print("I2C initialized - SDA: ");
         Serial.print(LCD_SDA_PIN);
         Serial.print(", SCL: ");
-        Serial.println(LCD_SCL_PIN);
+        Serial.print(LCD_SCL_PIN);
+        Serial.print(", ");
+        Serial.print(LCD_I2C_CLOCK / 1000);
+        Serial.println(" kHz");
     }
 
-public:
-    void setup() override
+    // Real-time half: sample, map, publish
+    ControlSnapshot controlStep()
     {
-        Serial.begin(SERIAL_BAUD);
-        Serial.println("=== SIMPLE JOYSTICK MOTOR CONTROL ===");
-        Serial.println("X-axis: Direction (Left/Right → Back/Forward)");
-        Serial.println("Y-axis: Speed (Up = Faster)");
-        Serial.println("=====================================");
+        PROFILE_SCOPE(PROFILE_LOOP);
+        ControlSnapshot snapshot;
 
-        // Initialize I2C first
-        initializeI2C();
+        if (recalibrationRequested.exchange(false))
+        {
+            joystick.startCalibration(true);
+        }
 
-        // Initialize LCD
-        lcdDisplay.begin();
-        lcdDisplay.displayInstruction("System Starting", "Please wait...");
+        // Calibration advances one step per cycle; the result goes to the
+        // UI side, which reports and stores it
+        if (joystick.isCalibrating() && joystick.updateCalibration() == CAL_DONE)
+        {
+            CalibrationReport report;
+            joystick.getCalibrationReport(report);
+            calibrationEvents.push(report);
+        }
+        snapshot.calibrationState = joystick.getCalibrationState();
 
-        // Initialize components
-        joystick.begin();
-        mapper.begin();
+        // Read joystick position
+        {
+            PROFILE_SCOPE(PROFILE_READ);
+            snapshot.joy = joystick.read();
+        }
 
-        // Display calibration instruction
-        Serial.println("Starting joystick calibration...");
+        // Process joystick input
+        {
+            PROFILE_SCOPE(PROFILE_MAP);
+            snapshot.cmd = mapper.processInput(snapshot.joy);
+        }
+
+        // Advance the motor ramp toward the new command
+        {
+            PROFILE_SCOPE(PROFILE_MOTOR);
+            uint32_t now = micros();
+#ifndef ESP32
+            motorPlant.advance(now, motor.getDuty());
+#endif
+            motor.apply(snapshot.cmd);
+            motor.update(now);
+        }
+        snapshot.motorDuty = motor.getDuty();
+        snapshot.motorSpeed = motor.getMeasuredSpeed();
+        snapshot.motorHasEncoder = motor.hasEncoder();
+        snapshot.motorClosedLoop = motor.isClosedLoop();
+        joystick.getLastRaw(snapshot.raw);
+        snapshot.timestamp = millis();
+        captureDiagnostics(snapshot);
+
+        return snapshot;
+    }
+
+    // Status values read here, on the task that changes them
+    void captureDiagnostics(ControlSnapshot &snapshot)
+    {
+        const DriftCompensator &drift = joystick.getDriftCompensator();
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            snapshot.noise[axis] = joystick.getNoise(axis);
+            snapshot.filterCutoff[axis] = joystick.getFilterCutoff(axis);
+            snapshot.drift[axis] = drift.getDrift(axis);
+        }
+        snapshot.rejectedSamples = joystick.getRejectedSamples();
+        snapshot.clippedSamples = joystick.getClippedSamples();
+        snapshot.rangeWidenings = drift.getWidenings();
+
+        snapshot.loopLastUs = scheduler.getLastDuration();
+        snapshot.loopMaxUs = scheduler.getMaxDuration();
+        snapshot.overruns = scheduler.getOverruns();
+        snapshot.missedDeadlines = scheduler.getMissedDeadlines();
+        snapshot.staleAdcTicks = joystick.getStaleTicks();
+        snapshot.adcOverruns = joystick.getAdcOverruns();
+    }
+
+    static uint16_t saturate16(unsigned long value)
+    {
+        return value > 0xFFFF ? 0xFFFF : (uint16_t)value;
+    }
+
+    void sendTelemetry(const ControlSnapshot &snapshot, uint8_t flags)
+    {
+        TelemetryFrame frame;
+        frame.flags = flags;
+        frame.sequence = telemetrySequence++;
+        frame.timestamp = (uint32_t)snapshot.timestamp;
+        frame.rawX = (uint16_t)snapshot.raw[AXIS_X];
+        frame.rawY = (uint16_t)snapshot.raw[AXIS_Y];
+        frame.x = (int16_t)snapshot.joy.axis[AXIS_X];
+        frame.y = (int16_t)snapshot.joy.axis[AXIS_Y];
+        frame.direction = (uint8_t)snapshot.cmd.direction;
+        frame.speedPercent = (uint8_t)snapshot.cmd.speedPercent;
+        frame.speedPWM = (uint8_t)snapshot.cmd.speedPWM;
+        frame.dropped = telemetryDropped > 0xFF ? 0xFF : (uint8_t)telemetryDropped;
+        frame.loopLastUs = saturate16(snapshot.loopLastUs);
+        frame.loopMaxUs = saturate16(snapshot.loopMaxUs);
+        frame.overruns = saturate16(snapshot.overruns);
+
+        uint8_t wire[TELEMETRY_WIRE_SIZE];
+        size_t length = encodeTelemetryFrame(frame, wire);
+
+        // Never wait on the UART: a skipped frame shows up as a sequence gap
+        if (Serial.availableForWrite() < (int)length)
+        {
+            telemetryDropped++;
+            return;
+        }
+        Serial.write(wire, length);
+    }
+
+    void reportCommand(const ControlSnapshot &snapshot)
+    {
+        PROFILE_SCOPE(PROFILE_SERIAL);
+        if (TELEMETRY_MODE == TELEMETRY_BINARY)
+        {
+            sendTelemetry(snapshot, TELEMETRY_FLAG_COMMAND_CHANGED);
+            return;
+        }
+
+        const SimpleMotorCommand &motorCmd = snapshot.cmd;
+        mapper.printCommand(motorCmd);
+
+        if (motorCmd.direction == MOTOR_STOP || motorCmd.speedPercent == 0)
+        {
+            logEvent(LOG_MOTOR_STOPPED);
+        }
+        else
+        {
+            logEvent(LOG_MOTOR_RUNNING, motorCmd.direction == MOTOR_FORWARD ? "Forward" : "Backward",
+                     motorCmd.speedPercent);
+        }
+    }
+
+    // Presentation half: LCD and periodic Serial status
+    void presentationStep(const ControlSnapshot &snapshot)
+    {
+        // Serial commands
+        if (Serial.available() > 0)
+        {
+            int command = Serial.read();
+            if (command == RECALIBRATE_COMMAND)
+            {
+                logEvent(LOG_RECALIBRATION_REQUESTED);
+                recalibrationRequested = true;
+            }
+            else if (command == PROFILE_DUMP_COMMAND)
+            {
+                profileDump(Serial);
+            }
+            else if (command == SPEED_CURVE_COMMAND)
+            {
+                logEvent(LOG_SPEED_CURVE, mapper.selectNextSpeedCurve());
+            }
+        }
+
+        CalibrationState calibrationState = snapshot.calibrationState;
+
+        // Periodic telemetry runs through calibration too
+        unsigned long currentTime = millis();
+        if (TELEMETRY_MODE == TELEMETRY_BINARY &&
+            currentTime - lastTelemetryTime >= 1000UL / TELEMETRY_RATE_HZ)
+        {
+            PROFILE_SCOPE(PROFILE_SERIAL);
+            sendTelemetry(snapshot, calibrationState != CAL_DONE ? TELEMETRY_FLAG_CALIBRATING : 0);
+            lastTelemetryTime = currentTime;
+        }
+
+        if (calibrationState != shownCalibrationState)
+        {
+            shownCalibrationState = calibrationState;
+            if (calibrationState != CAL_DONE)
+            {
+                lcdDisplay.displayInstruction("Calibrating", CalibrationStateMachine::stateName(calibrationState));
+            }
+        }
+
+        // Pushed before the snapshot that reports CAL_DONE
+        CalibrationReport report;
+        while (calibrationEvents.pop(report))
+        {
+            showCalibrationResult(report);
+        }
+
+        // Keep the instruction screen up until calibration is done
+        if (calibrationState != CAL_DONE)
+            return;
+
+        // Queue LCD changes, then send a budgeted slice of them
+        {
+            PROFILE_SCOPE(PROFILE_LCD);
+            lcdDisplay.displayJoystickStatus(snapshot.joy, snapshot.cmd);
+            lcdDisplay.update();
+        }
+
+        // Print periodic status to Serial
+        if (TELEMETRY_MODE == TELEMETRY_TEXT && currentTime - lastStatusTime >= STATUS_INTERVAL)
+        {
+            PROFILE_SCOPE(PROFILE_SERIAL);
+            printSystemStatus(snapshot);
+            lastStatusTime = currentTime;
+        }
+    }
 
-        // Calibrate joystick
-        lcdDisplay.displayInstruction("Calibrating", "Keep centered");
-        joystick.calibrate_center();
+    void showCalibrationResult(const CalibrationReport &report)
+    {
+        calibrationResult = report;
+        if (readyTime == 0)
+        {
+            readyTime = millis();
+        }
+        JoystickController::printCalibrationReport(report);
 
-        lcdDisplay.displayInstruction("Calibrating", "Move Joystick");
-        joystick.calibrate_range();
+        // Persist fresh calibrations; verified ones are already stored
+        if (report.data.isCalibrated && !report.verified)
+        {
+            Serial.println(joystick.saveCalibration(report) ? "Calibration saved"
+                                                            : "Calibration not saved (timed out or invalid range)");
+        }
 
         // Display calibration result
-        if (joystick.isCalibrated())
+        if (report.data.isCalibrated)
         {
-            lcdDisplay.displayInstruction("Calibration", "Success!");
+            lcdDisplay.displayTwoLineMessage("System Ready", "Move joystick");
         }
         else
         {
@@ -89,53 +451,222 @@ public:
         }
 
         Serial.println("=== READY FOR CONTROL ===");
+        Serial.print("Boot-to-ready: ");
+        Serial.print(readyTime);
+        Serial.println(" ms");
+        if (report.verified)
+        {
+            Serial.print("Warm boot saved ");
+            Serial.print(report.bootTimeSavedMs);
+            Serial.println(" ms");
+        }
+        Serial.print("Send '");
+        Serial.print(RECALIBRATE_COMMAND);
+        Serial.println("' to recalibrate");
+        Serial.print("Send '");
+        Serial.print(SPEED_CURVE_COMMAND);
+        Serial.print("' to change the speed curve (now ");
+        Serial.print(mapper.getSpeedCurveName());
+        Serial.println(")");
+        if (PROFILING_ENABLED)
+        {
+            Serial.print("Send '");
+            Serial.print(PROFILE_DUMP_COMMAND);
+            Serial.println("' for stage timings");
+        }
         Serial.println("Move joystick:");
         Serial.println("- Left/Right: Choose direction");
         Serial.println("- Up: Increase speed");
         Serial.println("- Center: Stop motor");
         Serial.println("========================");
-
-        // Display ready message
-        lcdDisplay.displayTwoLineMessage("System Ready", "Move joystick", 1000);
     }
 
-    void loop() override
+    // Single-task mode: both halves inline
+    void runControlCycle()
     {
+        ControlSnapshot snapshot = controlStep();
 
-        // Read joystick position
-        JoystickPosition joyPos = joystick.read();
+        // Report motor command if it has changed
+        if (snapshot.cmd.hasChanged)
+        {
+            reportCommand(snapshot);
+        }
 
-        // Process joystick input
-        SimpleMotorCommand motorCmd = mapper.processInput(joyPos);
+        presentationStep(snapshot);
 
-        // Update LCD with real-time data
-        lcdDisplay.displayJoystickStatus(joyPos, motorCmd);
+        // Deferred log output, after the time-critical work
+        logger.drain(Serial);
+    }
 
-        // Execute motor command if it has changed
-        if (motorCmd.hasChanged)
+    void runFixedRateLoop()
+    {
+        if (FIXED_RATE_LOOP)
+        {
+            scheduler.waitForTick();
+            scheduler.beginTick();
+            runControlCycle();
+            scheduler.endTick();
+        }
+        else
         {
-            mapper.printCommand(motorCmd);
+            runControlCycle();
+            delay(LOOP_DELAY);
+        }
+    }
 
-            if (motorCmd.direction == MOTOR_STOP || motorCmd.speedPercent == 0)
+#ifdef ESP32
+    // Dual-core mode: control task publishes, UI task consumes
+    static void controlTaskEntry(void *arg)
+    {
+        MainRunner *self = static_cast<MainRunner *>(arg);
+
+        // The scheduler's timer notifies the task that starts it
+        if (FIXED_RATE_LOOP)
+        {
+            self->scheduler.start();
+            if (!self->scheduler.isHardwareTimed())
             {
-                Serial.println("Motor stopped");
+                logEvent(LOG_TIMER_UNAVAILABLE);
             }
-            else
+        }
+
+        for (;;)
+        {
+            if (FIXED_RATE_LOOP)
             {
-                String direction = (motorCmd.direction == MOTOR_FORWARD) ? "Forward" : "Backward";
-                Serial.println("Motor: " + direction + " at " + String(motorCmd.speedPercent) + "%");
+                self->scheduler.waitForTick();
+            }
+            self->scheduler.beginTick();
+
+            ControlSnapshot snapshot = self->controlStep();
+            self->latestSnapshot.write(snapshot);
+            if (snapshot.cmd.hasChanged)
+            {
+                // Full queue drops the event (counted) rather than blocking
+                self->commandEvents.push(snapshot);
+            }
+
+            self->scheduler.endTick();
+
+            if (!FIXED_RATE_LOOP)
+            {
+                delay(LOOP_DELAY);
             }
         }
+    }
 
-        // Print periodic status to Serial
-        unsigned long currentTime = millis();
-        if (currentTime - lastStatusTime >= STATUS_INTERVAL)
+    static void presentationTaskEntry(void *arg)
+    {
+        MainRunner *self = static_cast<MainRunner *>(arg);
+
+        for (;;)
         {
-            printSystemStatus(joyPos, motorCmd);
-            lastStatusTime = currentTime;
+            ControlSnapshot event;
+            while (self->commandEvents.pop(event))
+            {
+                self->reportCommand(event);
+            }
+
+            if (self->latestSnapshot.version() > 0)
+            {
+                self->presentationStep(self->latestSnapshot.read());
+            }
+
+            delay(UI_TASK_PERIOD);
+        }
+    }
+
+    static void logTaskEntry(void *)
+    {
+        for (;;)
+        {
+            logger.drain(Serial);
+            delay(LOG_TASK_PERIOD);
+        }
+    }
+
+    bool startPipeline()
+    {
+        // Create the consumers first so no early events are missed
+        BaseType_t logOk = xTaskCreatePinnedToCore(logTaskEntry, "log", TASK_STACK_SIZE, nullptr,
+                                                   LOG_TASK_PRIORITY, nullptr, UI_TASK_CORE);
+        if (logOk != pdPASS)
+            return false;
+
+        BaseType_t uiOk = xTaskCreatePinnedToCore(presentationTaskEntry, "ui", TASK_STACK_SIZE, this,
+                                                  UI_TASK_PRIORITY, nullptr, UI_TASK_CORE);
+        if (uiOk != pdPASS)
+            return false;
+
+        BaseType_t controlOk = xTaskCreatePinnedToCore(controlTaskEntry, "control", TASK_STACK_SIZE, this,
+                                                       CONTROL_TASK_PRIORITY, nullptr, CONTROL_TASK_CORE);
+        return controlOk == pdPASS;
+    }
+#else
+    bool startPipeline()
+    {
+        return false;
+    }
+#endif
+
+public:
+    void setup() override
+    {
+        Serial.begin(SERIAL_BAUD);
+        Serial.println("=== SIMPLE JOYSTICK MOTOR CONTROL ===");
+        Serial.println("X-axis: Direction (Left/Right → Back/Forward)");
+        Serial.println("Y-axis: Speed (Up = Faster)");
+        Serial.println("=====================================");
+
+        // Initialize I2C first
+        initializeI2C();
+
+        // Initialize LCD
+        lcdDisplay.begin();
+        lcdDisplay.displayInstruction("System Starting", "Please wait...");
+
+        // Initialize components
+        joystick.begin();
+        mapper.begin();
+#ifndef ESP32
+        motor.setEncoder(&motorPlant);
+#endif
+        motor.begin();
+
+        // Calibration runs in the background from the control loop;
+        // the LCD follows its progress
+        Serial.println("Starting joystick calibration...");
+        joystick.startCalibration();
+
+        if (DUAL_CORE_PIPELINE && startPipeline())
+        {
+            pipelineRunning = true;
+            Serial.print("Pipeline: control task on core ");
+            Serial.print(CONTROL_TASK_CORE);
+            Serial.print(", UI task on core ");
+            Serial.println(UI_TASK_CORE);
+            return;
+        }
+
+        if (FIXED_RATE_LOOP)
+        {
+            scheduler.start();
+            Serial.print("Control loop: ");
+            Serial.print(CONTROL_RATE_HZ);
+            Serial.println(scheduler.isHardwareTimed() ? " Hz (hardware timer)" : " Hz (polled)");
+        }
+    }
+
+    void loop() override
+    {
+        if (pipelineRunning)
+        {
+            // All work happens in the pipeline tasks
+            delay(1000);
+            return;
         }
 
-        delay(LOOP_DELAY);
+        runFixedRateLoop();
     }
 };
 
@@ -4,8 +4,9 @@
 class Runner
 {
 public:
-    virtual void setup();
-    virtual void loop();
+    virtual ~Runner() {}
+    virtual void setup() = 0;
+    virtual void loop() = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,226 @@
+#include "fixed_rate_scheduler.h"
+#include <Arduino.h>
+
+#ifdef ESP32
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+uint32_t ArduinoClock::nowMicros()
+{
+    return micros();
+}
+
+FixedRateScheduler::FixedRateScheduler(SchedulerClock *clock, uint32_t periodMicros)
+    : clock(clock), periodMicros(periodMicros > 0 ? periodMicros : 1),
+      nextDeadline(0), started(false), timerHandle(nullptr), waitingTask(nullptr)
+{
+    resetStats();
+}
+
+FixedRateScheduler::~FixedRateScheduler()
+{
+    stop();
+}
+
+void FixedRateScheduler::start(bool useHardwareTimer)
+{
+    stop();
+
+    // First tick is due immediately
+    nextDeadline = clock->nowMicros();
+    started = true;
+
+    // Falls back to polling the clock; isHardwareTimed() tells which
+    if (useHardwareTimer)
+    {
+        startHardwareTimer();
+    }
+}
+
+void FixedRateScheduler::stop()
+{
+    stopHardwareTimer();
+    started = false;
+}
+
+bool FixedRateScheduler::poll()
+{
+    if (!started)
+        return false;
+
+    uint32_t now = clock->nowMicros();
+    uint32_t late = now - nextDeadline;
+    if ((int32_t)late < 0)
+        return false;
+
+    // Whole periods that passed without being serviced are missed, and the
+    // schedule skips ahead instead of bursting to catch up
+    uint32_t skipped = late / periodMicros;
+    missedDeadlines += skipped;
+    nextDeadline += (skipped + 1) * periodMicros;
+    tickCount++;
+    return true;
+}
+
+void FixedRateScheduler::waitForTick()
+{
+    if (!started)
+        return;
+
+    while (!poll())
+    {
+#ifdef ESP32
+        if (waitingTask != nullptr)
+        {
+            // Sleep until the timer callback notifies this task
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(periodMicros / 1000 + 2));
+            continue;
+        }
+#endif
+        uint32_t remaining = microsUntilNextTick();
+        if (remaining >= 1000)
+        {
+            delay(remaining / 1000);
+        }
+        else if (remaining > 0)
+        {
+            delayMicroseconds(remaining);
+        }
+    }
+}
+
+void FixedRateScheduler::beginTick()
+{
+    tickStart = clock->nowMicros();
+}
+
+void FixedRateScheduler::endTick()
+{
+    lastDuration = clock->nowMicros() - tickStart;
+    if (lastDuration > maxDuration)
+    {
+        maxDuration = lastDuration;
+    }
+    if (lastDuration > periodMicros)
+    {
+        overruns++;
+    }
+}
+
+uint32_t FixedRateScheduler::getPeriodMicros() const
+{
+    return periodMicros;
+}
+
+uint32_t FixedRateScheduler::microsUntilNextTick() const
+{
+    int32_t remaining = (int32_t)(nextDeadline - clock->nowMicros());
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+unsigned long FixedRateScheduler::getTickCount() const
+{
+    return tickCount;
+}
+
+unsigned long FixedRateScheduler::getMissedDeadlines() const
+{
+    return missedDeadlines;
+}
+
+unsigned long FixedRateScheduler::getOverruns() const
+{
+    return overruns;
+}
+
+uint32_t FixedRateScheduler::getLastDuration() const
+{
+    return lastDuration;
+}
+
+uint32_t FixedRateScheduler::getMaxDuration() const
+{
+    return maxDuration;
+}
+
+bool FixedRateScheduler::isHardwareTimed() const
+{
+    return timerHandle != nullptr;
+}
+
+void FixedRateScheduler::resetStats()
+{
+    tickCount = 0;
+    missedDeadlines = 0;
+    overruns = 0;
+    tickStart = 0;
+    lastDuration = 0;
+    maxDuration = 0;
+}
+
+#ifdef ESP32
+
+void FixedRateScheduler::onTimer(void *arg)
+{
+    FixedRateScheduler *self = (FixedRateScheduler *)arg;
+    if (self->waitingTask != nullptr)
+    {
+        xTaskNotifyGive((TaskHandle_t)self->waitingTask);
+    }
+}
+
+bool FixedRateScheduler::startHardwareTimer()
+{
+    esp_timer_create_args_t args = {};
+    args.callback = &FixedRateScheduler::onTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "fixed_rate";
+
+    esp_timer_handle_t handle = nullptr;
+    if (esp_timer_create(&args, &handle) != ESP_OK)
+        return false;
+
+    // The task that started the scheduler is the one that waits on it
+    waitingTask = xTaskGetCurrentTaskHandle();
+    if (esp_timer_start_periodic(handle, periodMicros) != ESP_OK)
+    {
+        esp_timer_delete(handle);
+        waitingTask = nullptr;
+        return false;
+    }
+
+    timerHandle = handle;
+    return true;
+}
+
+void FixedRateScheduler::stopHardwareTimer()
+{
+    if (timerHandle == nullptr)
+        return;
+
+    esp_timer_stop((esp_timer_handle_t)timerHandle);
+    esp_timer_delete((esp_timer_handle_t)timerHandle);
+    timerHandle = nullptr;
+    waitingTask = nullptr;
+}
+
+#else
+
+void FixedRateScheduler::onTimer(void *arg)
+{
+    (void)arg;
+}
+
+bool FixedRateScheduler::startHardwareTimer()
+{
+    return false;
+}
+
+void FixedRateScheduler::stopHardwareTimer()
+{
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef FIXED_RATE_SCHEDULER_H
+#define FIXED_RATE_SCHEDULER_H
+
+#include "scheduler_clock.h"
+
+// Fixed-rate tick scheduler.
+// Deadlines advance by whole periods from the start time, so the rate does
+// not drift with the work done per tick. On ESP32 an esp_timer wakes the
+// waiting task each period; elsewhere waitForTick() sleeps on the clock.
+class FixedRateScheduler
+{
+private:
+    SchedulerClock *clock;
+    uint32_t periodMicros;
+    uint32_t nextDeadline;
+    bool started;
+
+    // Statistics
+    unsigned long tickCount;
+    unsigned long missedDeadlines; // Periods skipped entirely
+    unsigned long overruns;        // Ticks whose work exceeded the period
+    uint32_t tickStart;
+    uint32_t lastDuration;
+    uint32_t maxDuration;
+
+    // Hardware timer (opaque so this header stays IDF-free)
+    void *timerHandle;
+    void *waitingTask;
+
+    bool startHardwareTimer();
+    void stopHardwareTimer();
+    static void onTimer(void *arg);
+
+public:
+    FixedRateScheduler(SchedulerClock *clock, uint32_t periodMicros);
+    ~FixedRateScheduler();
+
+    void start(bool useHardwareTimer = true);
+    void stop();
+
+    bool poll();        // True once per elapsed period, never blocks
+    void waitForTick(); // Blocks until the next period starts
+    void beginTick();
+    void endTick();
+
+    uint32_t getPeriodMicros() const;
+    uint32_t microsUntilNextTick() const;
+    unsigned long getTickCount() const;
+    unsigned long getMissedDeadlines() const;
+    unsigned long getOverruns() const;
+    uint32_t getLastDuration() const;
+    uint32_t getMaxDuration() const;
+    bool isHardwareTimed() const;
+    void resetStats();
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef SCHEDULER_CLOCK_H
+#define SCHEDULER_CLOCK_H
+
+#include <stdint.h>
+
+// Microsecond time source used by the scheduler (wraps every ~71 minutes)
+class SchedulerClock
+{
+public:
+    virtual ~SchedulerClock() {}
+    virtual uint32_t nowMicros() = 0;
+};
+
+// Board clock (Arduino micros())
+class ArduinoClock : public SchedulerClock
+{
+public:
+    uint32_t nowMicros() override;
+};
+
+// Manually advanced clock for host simulation
+class SimulatedClock : public SchedulerClock
+{
+private:
+    uint32_t now;
+
+public:
+    SimulatedClock(uint32_t start = 0) : now(start) {}
+
+    uint32_t nowMicros() override { return now; }
+    void advance(uint32_t micros) { now += micros; }
+    void set(uint32_t micros) { now = micros; }
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "cobs.h"
+
+size_t cobsEncode(const uint8_t *in, size_t length, uint8_t *out)
+{
+    size_t codeIndex = 0;
+    size_t write = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if (in[i] == 0)
+        {
+            out[codeIndex] = code;
+            codeIndex = write++;
+            code = 1;
+            continue;
+        }
+
+        out[write++] = in[i];
+        code++;
+        if (code == 0xFF)
+        {
+            out[codeIndex] = code;
+            codeIndex = write++;
+            code = 1;
+        }
+    }
+
+    out[codeIndex] = code;
+    return write;
+}
+
+size_t cobsDecode(const uint8_t *in, size_t length, uint8_t *out)
+{
+    size_t read = 0;
+    size_t write = 0;
+
+    while (read < length)
+    {
+        uint8_t code = in[read++];
+        if (code == 0 || read + code - 1 > length)
+            return 0;
+
+        for (uint8_t i = 1; i < code; i++)
+        {
+            if (in[read] == 0)
+                return 0;
+            out[write++] = in[read++];
+        }
+
+        // A full block (0xFF) carries no implied zero; neither does the end
+        if (code != 0xFF && read < length)
+        {
+            out[write++] = 0;
+        }
+    }
+
+    return write;
+}
+
+size_t cobsDecodeInPlace(uint8_t *buffer, size_t length)
+{
+    // Decoded output never runs ahead of the read position
+    return cobsDecode(buffer, length, buffer);
+}
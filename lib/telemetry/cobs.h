@@ -0,0 +1,19 @@
+#ifndef COBS_H
+#define COBS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Consistent Overhead Byte Stuffing: removes every zero byte so 0x00 can
+// delimit frames on the wire. Encoding adds one byte per 254 input bytes
+// plus one; a receiver that joins mid-stream resyncs at the next zero.
+inline size_t cobsMaxEncodedSize(size_t length)
+{
+    return length + length / 254 + 1;
+}
+
+size_t cobsEncode(const uint8_t *in, size_t length, uint8_t *out);          // No trailing delimiter
+size_t cobsDecode(const uint8_t *in, size_t length, uint8_t *out);          // 0 on malformed input
+size_t cobsDecodeInPlace(uint8_t *buffer, size_t length);
+
+#endif
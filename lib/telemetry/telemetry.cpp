@@ -0,0 +1,138 @@
+#include "telemetry.h"
+#include "cobs.h"
+#include "crc.h"
+
+static void putU16(uint8_t *out, uint16_t value)
+{
+    out[0] = (uint8_t)(value & 0xFF);
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void putU32(uint8_t *out, uint32_t value)
+{
+    putU16(out, (uint16_t)(value & 0xFFFF));
+    putU16(out + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t getU16(const uint8_t *in)
+{
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t getU32(const uint8_t *in)
+{
+    return getU16(in) | ((uint32_t)getU16(in + 2) << 16);
+}
+
+size_t encodeTelemetryFrame(const TelemetryFrame &frame, uint8_t *out)
+{
+    uint8_t payload[TELEMETRY_PAYLOAD_SIZE];
+
+    payload[0] = TELEMETRY_VERSION;
+    payload[1] = frame.flags;
+    putU16(payload + 2, frame.sequence);
+    putU32(payload + 4, frame.timestamp);
+    putU16(payload + 8, frame.rawX);
+    putU16(payload + 10, frame.rawY);
+    putU16(payload + 12, (uint16_t)frame.x);
+    putU16(payload + 14, (uint16_t)frame.y);
+    payload[16] = frame.direction;
+    payload[17] = frame.speedPercent;
+    payload[18] = frame.speedPWM;
+    payload[19] = frame.dropped;
+    putU16(payload + 20, frame.loopLastUs);
+    putU16(payload + 22, frame.loopMaxUs);
+    putU16(payload + 24, frame.overruns);
+    putU16(payload + 26, crc16(payload, 26));
+
+    out[0] = 0;
+    size_t length = 1 + cobsEncode(payload, TELEMETRY_PAYLOAD_SIZE, out + 1);
+    out[length++] = 0;
+    return length;
+}
+
+TelemetryDecodeStatus decodeTelemetryFrame(uint8_t *wire, size_t length, TelemetryFrame &frame)
+{
+    if (length == 0 || length > TELEMETRY_WIRE_SIZE)
+        return TELEMETRY_BAD_LENGTH;
+
+    size_t decoded = cobsDecodeInPlace(wire, length);
+    if (decoded == 0)
+        return TELEMETRY_BAD_FRAMING;
+    if (decoded != TELEMETRY_PAYLOAD_SIZE)
+        return TELEMETRY_BAD_LENGTH;
+    if (getU16(wire + 26) != crc16(wire, 26))
+        return TELEMETRY_BAD_CRC;
+    if (wire[0] != TELEMETRY_VERSION)
+        return TELEMETRY_BAD_VERSION;
+
+    frame.flags = wire[1];
+    frame.sequence = getU16(wire + 2);
+    frame.timestamp = getU32(wire + 4);
+    frame.rawX = getU16(wire + 8);
+    frame.rawY = getU16(wire + 10);
+    frame.x = (int16_t)getU16(wire + 12);
+    frame.y = (int16_t)getU16(wire + 14);
+    frame.direction = wire[16];
+    frame.speedPercent = wire[17];
+    frame.speedPWM = wire[18];
+    frame.dropped = wire[19];
+    frame.loopLastUs = getU16(wire + 20);
+    frame.loopMaxUs = getU16(wire + 22);
+    frame.overruns = getU16(wire + 24);
+    return TELEMETRY_OK;
+}
+
+const char *telemetryStatusName(TelemetryDecodeStatus status)
+{
+    switch (status)
+    {
+    case TELEMETRY_OK:
+        return "ok";
+    case TELEMETRY_BAD_FRAMING:
+        return "bad framing";
+    case TELEMETRY_BAD_LENGTH:
+        return "bad length";
+    case TELEMETRY_BAD_CRC:
+        return "CRC mismatch";
+    case TELEMETRY_BAD_VERSION:
+        return "unknown version";
+    default:
+        return "?";
+    }
+}
+
+TelemetryStreamDecoder::TelemetryStreamDecoder() : length(0), overflow(false), frames(0), rejected(0)
+{
+}
+
+bool TelemetryStreamDecoder::push(uint8_t byte, TelemetryFrame &frame)
+{
+    if (byte != 0)
+    {
+        if (length < sizeof(wire))
+            wire[length++] = byte;
+        else
+            overflow = true;
+        return false;
+    }
+
+    // Delimiter: decode what came before it. Back-to-back delimiters
+    // (a frame's trailing one, the next frame's leading one) are empty.
+    bool decoded = false;
+    if (overflow)
+    {
+        rejected++;
+    }
+    else if (length > 0)
+    {
+        decoded = decodeTelemetryFrame(wire, length, frame) == TELEMETRY_OK;
+        if (decoded)
+            frames++;
+        else
+            rejected++;
+    }
+    length = 0;
+    overflow = false;
+    return decoded;
+}
@@ -0,0 +1,79 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary telemetry frame, little-endian, then CRC-16 and COBS:
+//   0  version          1  flags            2  sequence (uint16)
+//   4  timestamp ms (uint32)
+//   8  rawX rawY (uint16)                   12 x y (int16, filtered)
+//   16 direction   17 speedPercent   18 speedPWM   19 dropped (saturating)
+//   20 loopLastUs loopMaxUs overruns (uint16)
+//   26 CRC-16/CCITT-FALSE of bytes 0-25
+// On the wire: 0x00, COBS(payload + CRC), 0x00. The leading delimiter
+// separates the frame from any text printed since the last one.
+// Bump TELEMETRY_VERSION whenever the layout changes.
+const uint8_t TELEMETRY_VERSION = 1;
+const size_t TELEMETRY_PAYLOAD_SIZE = 28;                      // Including CRC
+const size_t TELEMETRY_WIRE_SIZE = TELEMETRY_PAYLOAD_SIZE + 3; // COBS overhead + delimiters
+
+const uint8_t TELEMETRY_FLAG_COMMAND_CHANGED = 0x01; // Sent for a new motor command
+const uint8_t TELEMETRY_FLAG_CALIBRATING = 0x02;
+
+struct TelemetryFrame
+{
+    uint8_t flags;
+    uint16_t sequence;
+    uint32_t timestamp;
+    uint16_t rawX, rawY;
+    int16_t x, y;
+    uint8_t direction;
+    uint8_t speedPercent;
+    uint8_t speedPWM;
+    uint8_t dropped; // Frames the sender skipped so far (UART busy)
+    uint16_t loopLastUs;
+    uint16_t loopMaxUs;
+    uint16_t overruns;
+};
+
+enum TelemetryDecodeStatus
+{
+    TELEMETRY_OK = 0,
+    TELEMETRY_BAD_FRAMING,
+    TELEMETRY_BAD_LENGTH,
+    TELEMETRY_BAD_CRC,
+    TELEMETRY_BAD_VERSION
+};
+
+// Writes the delimited wire frame; out needs TELEMETRY_WIRE_SIZE bytes
+size_t encodeTelemetryFrame(const TelemetryFrame &frame, uint8_t *out);
+
+// Decodes the bytes between two delimiters (modifies the buffer)
+TelemetryDecodeStatus decodeTelemetryFrame(uint8_t *wire, size_t length, TelemetryFrame &frame);
+
+const char *telemetryStatusName(TelemetryDecodeStatus status);
+
+// Receiving side of a serial stream: collects bytes up to each delimiter
+// and decodes them. Damaged frames and text between frames are counted
+// and dropped, and decoding picks up again at the next delimiter.
+class TelemetryStreamDecoder
+{
+private:
+    uint8_t wire[TELEMETRY_WIRE_SIZE];
+    size_t length;
+    bool overflow;
+    unsigned long frames;
+    unsigned long rejected;
+
+public:
+    TelemetryStreamDecoder();
+
+    // Returns true when byte completes a valid frame, written to frame
+    bool push(uint8_t byte, TelemetryFrame &frame);
+
+    unsigned long getFrames() const { return frames; }
+    unsigned long getRejected() const { return rejected; } // Chunks that were not a valid frame
+};
+
+#endif
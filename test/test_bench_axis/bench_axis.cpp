@@ -0,0 +1,178 @@
+// Host benchmark of the per-tick axis pipeline against the number of axes.
+// Runs glitch rejection, mapping, noise tracking, smoothing and the dead
+// zone over a recorded-looking input (rest, then sweeps) for 1 to 16 axes.
+// Every axis of a wide pipeline must produce exactly what a one-axis
+// pipeline fed the same input does, and the cost per axis must not grow
+// with the number of axes; then it reports the cost per tick and per axis.
+//
+//   pio test -e native_bench
+//
+// BENCH_TICKS sets the length of each timing run (-D... in build_flags).
+// The filter and mapping kernel follow config.h; -DFILTER_TYPE=... or
+// -DMAPPING_KERNEL=... compares them.
+
+#include "axis_pipeline.h"
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+
+#ifndef BENCH_TICKS
+#define BENCH_TICKS 200000L
+#endif
+
+static const int INPUT_TICKS = 4096; // Input pattern length, repeated
+static const int MAX_AXES = 16;
+static const float MAX_SCALING = 2.0f; // ns/axis at MAX_AXES over ns/axis at one
+
+// Rest noise around the center for the first quarter, then triangle
+// sweeps with a phase offset per axis and an occasional spike
+static int inputSample(int tick, int axis)
+{
+    int t = tick % INPUT_TICKS;
+    int noise = (int)((t * 2654435761u + axis * 40503u) >> 28) - 8;
+    if (t < INPUT_TICKS / 4)
+        return 2048 + noise;
+    if (((t * 7 + axis) & 511) == 0)
+        return ADC_MAX_VALUE;
+
+    int phase = (t * 8 + axis * 97) % 4096;
+    int sweep = phase < 2048 ? phase * 2 : (4095 - phase) * 2;
+    return 200 + sweep * 3700 / 4096 + noise;
+}
+
+// A slightly different calibration per axis, so a mixed-up axis shows
+static void calibration(int axis, int &minVal, int &maxVal, int &centerVal)
+{
+    minVal = 200 + axis * 5;
+    maxVal = 3900 - axis * 7;
+    centerVal = 2048 + axis * 3;
+}
+
+template <int Axes>
+static void rebuild(AxisPipeline<Axes> &pipeline, int firstAxis)
+{
+    int minVal[Axes], maxVal[Axes], centerVal[Axes];
+    for (int axis = 0; axis < Axes; axis++)
+    {
+        calibration(firstAxis + axis, minVal[axis], maxVal[axis], centerVal[axis]);
+    }
+    TEST_ASSERT_TRUE(pipeline.rebuild(minVal, maxVal, centerVal));
+    pipeline.reset();
+}
+
+// One tick, raw in place to out
+template <int Axes>
+static inline void tick(AxisPipeline<Axes> &pipeline, int *raw, int *out)
+{
+    int mapped[Axes], velocity[Axes];
+    pipeline.rejectGlitches(raw);
+    pipeline.map(raw, mapped);
+    pipeline.trackNoise(raw, mapped);
+    pipeline.smooth(mapped, out, velocity);
+    pipeline.applyDeadZone(out);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static void test_axes_independent()
+{
+    static AxisPipeline<MAX_AXES> wide; // LUT kernel: 8 KB per axis, kept off the stack
+    static AxisPipeline<1> single[MAX_AXES];
+    rebuild(wide, 0);
+    for (int axis = 0; axis < MAX_AXES; axis++)
+    {
+        rebuild(single[axis], axis);
+    }
+
+    for (int t = 0; t < INPUT_TICKS * 2; t++)
+    {
+        int raw[MAX_AXES], out[MAX_AXES];
+        for (int axis = 0; axis < MAX_AXES; axis++)
+        {
+            raw[axis] = inputSample(t, axis);
+        }
+        tick(wide, raw, out);
+
+        for (int axis = 0; axis < MAX_AXES; axis++)
+        {
+            int singleRaw = inputSample(t, axis);
+            int singleOut;
+            tick(single[axis], &singleRaw, &singleOut);
+            if (out[axis] != singleOut)
+            {
+                printf("tick %d axis %d: %d, alone %d\n", t, axis, out[axis], singleOut);
+                TEST_FAIL_MESSAGE("axis output depends on the other axes");
+            }
+        }
+    }
+
+    unsigned long rejected = 0;
+    for (int axis = 0; axis < MAX_AXES; axis++)
+    {
+        rejected += single[axis].getRejectedSamples();
+    }
+    TEST_ASSERT_GREATER_THAN(0, rejected);
+    TEST_ASSERT_EQUAL(rejected, wide.getRejectedSamples());
+}
+
+// Returns ns per tick
+template <int Axes>
+static double bench()
+{
+    static AxisPipeline<Axes> pipeline;
+    static int input[INPUT_TICKS][Axes];
+    rebuild(pipeline, 0);
+    for (int t = 0; t < INPUT_TICKS; t++)
+    {
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            input[t][axis] = inputSample(t, axis);
+        }
+    }
+
+    long checksum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < BENCH_TICKS; i++)
+    {
+        int raw[Axes], out[Axes];
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            raw[axis] = input[i % INPUT_TICKS][axis];
+        }
+        tick(pipeline, raw, out);
+        for (int axis = 0; axis < Axes; axis++)
+        {
+            checksum += out[axis];
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%5d %12.1f %12.1f   (checksum %ld, %lu glitches)\n", Axes, ns / BENCH_TICKS, ns / BENCH_TICKS / Axes,
+           checksum & 0xFFFF, pipeline.getRejectedSamples());
+    return ns / BENCH_TICKS;
+}
+
+static void test_cost_per_axis()
+{
+    printf("%ld ticks per run\naxes   ns/tick      ns/axis\n", (long)BENCH_TICKS);
+    double one = bench<1>();
+    bench<2>();
+    bench<4>();
+    bench<8>();
+    double wide = bench<MAX_AXES>();
+    TEST_ASSERT_LESS_THAN(one * MAX_SCALING, wide / MAX_AXES);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_axes_independent);
+    RUN_TEST(test_cost_per_axis);
+    return UNITY_END();
+}
@@ -0,0 +1,257 @@
+// Host benchmark of the smoothing filters in filters.h: the cost of one
+// update() and the measured frequency response of each filter type. Sine
+// inputs at FILTER_SAMPLE_RATE_HZ are fitted against sin/cos after the
+// filter settles, giving the gain and the delay at each frequency, and
+// each filter's response must stay within the bounds its design implies.
+// The One-Euro filter is speed-adaptive, so its response depends on the
+// amplitude (BENCH_AMPLITUDE).
+//
+//   pio test -e native_bench
+//
+// BENCH_SAMPLES sets the length of the timing run (-D... in build_flags).
+
+#include "filters.h"
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+#ifndef BENCH_SAMPLES
+#define BENCH_SAMPLES 20000000L
+#endif
+
+#ifndef BENCH_AMPLITUDE
+#define BENCH_AMPLITUDE 100.0f
+#endif
+
+static const int INPUT_SAMPLES = 4096; // Timing input pattern length, repeated
+static const float PI = 3.14159265f;
+static const float FREQUENCIES_HZ[] = {0.5f, 1.0f, 2.0f, 5.0f, 10.0f, 20.0f, 50.0f, 100.0f};
+static const int FREQUENCY_COUNT = sizeof(FREQUENCIES_HZ) / sizeof(FREQUENCIES_HZ[0]);
+static const float NULL_DB = -60.0f; // Below this there is no phase to speak of
+
+static int input[INPUT_SAMPLES];
+
+struct Response
+{
+    double ns; // Per update()
+    float gainDb[FREQUENCY_COUNT];
+    float delayMs[FREQUENCY_COUNT]; // Unwrapped; NAN at a null
+};
+
+static int frequencyIndex(float hz)
+{
+    for (int f = 0; f < FREQUENCY_COUNT; f++)
+    {
+        if (FREQUENCIES_HZ[f] == hz)
+            return f;
+    }
+    TEST_FAIL_MESSAGE("frequency not measured");
+    return 0;
+}
+
+template <class Filter>
+static double nanosPerSample(Filter filter)
+{
+    long checksum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < BENCH_SAMPLES; i++)
+    {
+        checksum += filter.update(input[i % INPUT_SAMPLES]);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    if (checksum == 42)
+        printf(" "); // Keeps the loop from being optimized out
+    return ns / BENCH_SAMPLES;
+}
+
+// Settles for two seconds (and at least five periods), then fits the
+// output over whole periods to a sine of the input frequency. Returns the
+// gain; lag gets the phase lag in radians, wrapped to (-pi, pi].
+template <class Filter>
+static double fitSine(Filter filter, float frequencyHz, double &lag)
+{
+    const float rate = (float)FILTER_SAMPLE_RATE_HZ;
+    int period = (int)lroundf(rate / frequencyHz);
+    int settle = FILTER_SAMPLE_RATE_HZ * 2 > period * 5 ? FILTER_SAMPLE_RATE_HZ * 2 : period * 5;
+    int periods = period >= FILTER_SAMPLE_RATE_HZ ? 2 : 10;
+
+    double inPhase = 0.0, quadrature = 0.0;
+    for (int n = 0; n < settle + periods * period; n++)
+    {
+        float angle = 2.0f * PI * frequencyHz * n / rate;
+        int output = filter.update((int)lroundf(BENCH_AMPLITUDE * sinf(angle)));
+        if (n >= settle)
+        {
+            inPhase += output * sin(angle);
+            quadrature += output * cos(angle);
+        }
+    }
+
+    int count = periods * period;
+    double a = 2.0 * inPhase / count;
+    double b = 2.0 * quadrature / count;
+    lag = -atan2(b, a); // Output = gain * sin(angle - lag)
+    return sqrt(a * a + b * b) / BENCH_AMPLITUDE;
+}
+
+template <class Filter>
+static Response characterize(const char *name, Filter filter)
+{
+    Response response;
+    response.ns = nanosPerSample(filter);
+
+    double previousLag = 0.0;
+    for (int f = 0; f < FREQUENCY_COUNT; f++)
+    {
+        double lag;
+        double gain = fitSine(filter, FREQUENCIES_HZ[f], lag);
+        response.gainDb[f] = gain > 1e-6 ? (float)(20.0 * log10(gain)) : -120.0f;
+        response.delayMs[f] = NAN;
+        if (response.gainDb[f] < NULL_DB)
+            continue;
+
+        // Unwrap against the previous frequency: past a half-turn of lag
+        // the raw fit folds back to a lead
+        while (lag < previousLag - PI)
+        {
+            lag += 2.0 * PI;
+        }
+        while (lag > previousLag + PI)
+        {
+            lag -= 2.0 * PI;
+        }
+        previousLag = lag;
+        response.delayMs[f] = (float)(lag / (2.0 * PI * FREQUENCIES_HZ[f]) * 1000.0);
+    }
+
+    printf("%-18s %7.2f", name, response.ns);
+    for (int f = 0; f < FREQUENCY_COUNT; f++)
+    {
+        if (isnan(response.delayMs[f]))
+            printf("  %6.1f/    -", response.gainDb[f]);
+        else
+            printf("  %6.1f/%5.1f", response.gainDb[f], response.delayMs[f]);
+    }
+    printf("\n");
+    return response;
+}
+
+// Gain (or delay) within tolerance of the target at every measured
+// frequency up to maxHz
+static void assertPassband(const Response &response, float maxHz, float gainToleranceDb)
+{
+    for (int f = 0; f < FREQUENCY_COUNT && FREQUENCIES_HZ[f] <= maxHz; f++)
+    {
+        TEST_ASSERT_FLOAT_WITHIN(gainToleranceDb, 0.0f, response.gainDb[f]);
+    }
+}
+
+static void assertDelay(const Response &response, float maxHz, float delayMs, float toleranceMs)
+{
+    for (int f = 0; f < FREQUENCY_COUNT && FREQUENCIES_HZ[f] <= maxHz; f++)
+    {
+        TEST_ASSERT_FLOAT_WITHIN(toleranceMs, delayMs, response.delayMs[f]);
+    }
+}
+
+static float gainAt(const Response &response, float hz)
+{
+    return response.gainDb[frequencyIndex(hz)];
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// Boxcar of N: flat, (N - 1) / 2 samples of delay, a null at rate / N
+static void test_moving_average_response()
+{
+    Response response = characterize("moving average", MovingAverageFilter<FILTER_SAMPLES>());
+    const float delayMs = (FILTER_SAMPLES - 1) * 500.0f / FILTER_SAMPLE_RATE_HZ;
+    assertPassband(response, 10.0f, 0.3f);
+    assertDelay(response, 50.0f, delayMs, 0.2f);
+    TEST_ASSERT_LESS_THAN(-40.0f, gainAt(response, (float)FILTER_SAMPLE_RATE_HZ / FILTER_SAMPLES));
+}
+
+// First-order IIR with the same mean delay, (1 - alpha) / alpha samples
+static void test_ema_response()
+{
+    const int alphaQ8 = 512 / (FILTER_SAMPLES + 1);
+    Response response = characterize("EMA", EmaFilter<alphaQ8>());
+    const float delayMs = (256.0f - alphaQ8) / alphaQ8 * 1000.0f / FILTER_SAMPLE_RATE_HZ;
+    assertPassband(response, 10.0f, 0.5f);
+    assertDelay(response, 5.0f, delayMs, 0.3f);
+    TEST_ASSERT_LESS_THAN(-6.0f, gainAt(response, 100.0f));
+}
+
+// Butterworth: flat, -3 dB at the cutoff, 24 dB/octave per pair of stages
+static void test_biquad_response()
+{
+    Response response = characterize("biquad", BiquadLowPass<FILTER_BIQUAD_STAGES>());
+    assertPassband(response, FILTER_CUTOFF_HZ / 2.0f, 0.2f);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, -3.0f, gainAt(response, (float)FILTER_CUTOFF_HZ));
+    TEST_ASSERT_LESS_THAN(-12.0f * FILTER_BIQUAD_STAGES, gainAt(response, 50.0f));
+    TEST_ASSERT_LESS_THAN(NULL_DB, gainAt(response, 100.0f));
+    for (int f = 0; f < FREQUENCY_COUNT && FREQUENCIES_HZ[f] <= FILTER_CUTOFF_HZ; f++)
+    {
+        TEST_ASSERT_FLOAT_WITHIN(15.0f, 15.0f, response.delayMs[f]); // Positive, under 30 ms
+    }
+}
+
+// Speed-adaptive: at BENCH_AMPLITUDE a sweep opens the cutoff, so the
+// passband is wide, the delay short, and high frequencies still damped
+static void test_one_euro_response()
+{
+    Response response = characterize("one-euro", OneEuroFilter());
+    assertPassband(response, 10.0f, 1.0f);
+    assertDelay(response, 20.0f, 5.0f, 5.0f);
+    TEST_ASSERT_LESS_THAN(-10.0f, gainAt(response, 100.0f));
+}
+
+// Tracker with lead: the delay at low frequencies is the compensated
+// pipeline delay, as a lead; the peaking above the passband stays bounded
+static void test_alpha_beta_response()
+{
+    Response response = characterize("alpha-beta", AlphaBetaTracker());
+    assertPassband(response, 2.0f, 0.3f);
+    assertDelay(response, 2.0f, -(float)PIPELINE_DELAY_MS, 0.5f);
+    for (int f = 0; f < FREQUENCY_COUNT; f++)
+    {
+        TEST_ASSERT_LESS_THAN(4.0f, response.gainDb[f]);
+    }
+    TEST_ASSERT_LESS_THAN(-6.0f, gainAt(response, 100.0f));
+}
+
+int main()
+{
+    // Rest noise for the first quarter, then sweeps, as the axis sees it
+    for (int i = 0; i < INPUT_SAMPLES; i++)
+    {
+        int noise = (int)((i * 2654435761u) >> 28) - 8;
+        int phase = (i * 8) % 4096;
+        int sweep = phase < 2048 ? phase : 4095 - phase;
+        input[i] = (i < INPUT_SAMPLES / 4 ? 0 : sweep * MAX_OUTPUT / 2048) + noise;
+    }
+
+    printf("%d Hz sampling, amplitude %.0f; each column is gain dB / delay ms at that frequency\n",
+           FILTER_SAMPLE_RATE_HZ, BENCH_AMPLITUDE);
+    printf("%-18s %7s", "filter", "ns/smp");
+    for (int f = 0; f < FREQUENCY_COUNT; f++)
+    {
+        printf("  %8.1f Hz ", FREQUENCIES_HZ[f]);
+    }
+    printf("\n");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_moving_average_response);
+    RUN_TEST(test_ema_response);
+    RUN_TEST(test_biquad_response);
+    RUN_TEST(test_one_euro_response);
+    RUN_TEST(test_alpha_beta_response);
+    return UNITY_END();
+}
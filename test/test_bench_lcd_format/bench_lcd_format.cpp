@@ -0,0 +1,95 @@
+// Host benchmark of the LCD status rendering: both lines formatted and
+// compared against the previous frame, as LCDController does per refresh.
+// Reports ns per frame and fails on any heap allocation.
+//
+//   pio test -e native_bench
+//
+// BENCH_FRAMES sets the run length (-DBENCH_FRAMES=... in build_flags).
+
+#include "lcd_format.h"
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef BENCH_FRAMES
+#define BENCH_FRAMES 5000000L
+#endif
+
+// Every heap allocation in the process goes through here
+static std::atomic<unsigned long> allocations(0);
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void *block = malloc(size > 0 ? size : 1);
+    if (block == nullptr)
+        throw std::bad_alloc();
+    return block;
+}
+
+void operator delete(void *block) noexcept
+{
+    free(block);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static void test_format_benchmark()
+{
+    static const MotorDirection directions[] = {MOTOR_STOP, MOTOR_FORWARD, MOTOR_BACKWARD};
+    LcdLine line1;
+    LcdLine line2;
+    LcdLine lastLine1 = "";
+    LcdLine lastLine2 = "";
+    long changed = 0;
+
+    unsigned long before = allocations.load(std::memory_order_relaxed);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long frame = 0; frame < BENCH_FRAMES; frame++)
+    {
+        // The stick sweeps, so most frames change at least one digit
+        JoystickPosition joy = {};
+        joy.axis[AXIS_X] = (int)(frame % 2001) - 1000;
+        joy.axis[AXIS_Y] = (int)((frame * 7) % 2001) - 1000;
+        SimpleMotorCommand cmd = {};
+        cmd.direction = directions[(frame / 1000) % 3];
+        cmd.speedPercent = (int)(frame % 101);
+
+        formatJoystickLine(line1, joy, cmd);
+        formatDirectionLine(line2, cmd);
+        if (memcmp(line1, lastLine1, sizeof(LcdLine)) != 0)
+        {
+            memcpy(lastLine1, line1, sizeof(LcdLine));
+            changed++;
+        }
+        if (memcmp(line2, lastLine2, sizeof(LcdLine)) != 0)
+        {
+            memcpy(lastLine2, line2, sizeof(LcdLine));
+            changed++;
+        }
+    }
+    double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    unsigned long allocated = allocations.load(std::memory_order_relaxed) - before;
+
+    printf("%ld frames, %ld changed lines, last \"%s\"\n", (long)BENCH_FRAMES, changed, lastLine1);
+    printf("format + compare  %6.1f ns/frame   %9.6f allocs/frame\n", nanos / BENCH_FRAMES,
+           (double)allocated / BENCH_FRAMES);
+    TEST_ASSERT_EQUAL_MESSAGE(0, allocated, "heap allocation while formatting");
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_format_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,304 @@
+// Host check and benchmark of the mapping kernels against the original
+// map()/constrain() code they replace. Both kernels are built side by side
+// in this binary, whatever MAPPING_KERNEL selects for AxisMapper: a
+// 4096-entry table and the multiply-shift LinearMap pair. Every raw input
+// of a set of random calibrations, and every speed percent, must map
+// bit-identically through both and through AxisMapper/SpeedMapper; then
+// it reports ns/sample per path and the cost of rebuilding an axis.
+//
+//   pio test -e native_bench
+//
+// BENCH_SAMPLES sets the run length, BENCH_CALIBRATIONS the number of
+// random calibrations checked (-D... in build_flags).
+
+#include "mapping_kernel.h"
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+
+#ifndef BENCH_SAMPLES
+#define BENCH_SAMPLES 20000000L
+#endif
+
+#ifndef BENCH_CALIBRATIONS
+#define BENCH_CALIBRATIONS 3000
+#endif
+
+static const int INPUT_SAMPLES = 4096; // Input pattern length, repeated
+static const int BENCH_AXES = 4;       // Calibrations cycled through while timing
+
+struct Calibration
+{
+    int minVal;
+    int maxVal;
+    int centerVal;
+};
+
+// The LUT kernel: the reference evaluated once per raw code
+class TableAxisMap
+{
+private:
+    int16_t table[ADC_MAX_VALUE + 1];
+
+public:
+    void build(const Calibration &cal)
+    {
+        for (int raw = ADC_MIN_VALUE; raw <= ADC_MAX_VALUE; raw++)
+        {
+            table[raw] = (int16_t)referenceMapToRange(raw, cal.minVal, cal.maxVal, cal.centerVal);
+        }
+    }
+
+    inline int map(int raw) const
+    {
+        raw = raw < ADC_MIN_VALUE ? ADC_MIN_VALUE : (raw > ADC_MAX_VALUE ? ADC_MAX_VALUE : raw);
+        return table[raw];
+    }
+};
+
+// The fixed kernel: one LinearMap per half, input clamped to the range
+class FixedAxisMap
+{
+private:
+    Calibration cal;
+    bool valid;
+    LinearMap upper;
+    LinearMap lower;
+
+public:
+    void build(Calibration calibration)
+    {
+        cal = calibration;
+        valid = cal.maxVal > cal.minVal;
+        if (!valid)
+            return;
+        if (cal.centerVal < cal.minVal)
+            cal.centerVal = cal.minVal;
+        if (cal.centerVal > cal.maxVal)
+            cal.centerVal = cal.maxVal;
+        upper.configure(cal.centerVal, cal.maxVal, 0, MAX_OUTPUT);
+        lower.configure(cal.minVal, cal.centerVal, MIN_OUTPUT, 0);
+    }
+
+    inline int map(int raw) const
+    {
+        raw = raw < ADC_MIN_VALUE ? ADC_MIN_VALUE : (raw > ADC_MAX_VALUE ? ADC_MAX_VALUE : raw);
+        raw = raw < cal.minVal ? cal.minVal : (raw > cal.maxVal ? cal.maxVal : raw);
+        if (!valid)
+            return 0;
+        if (raw >= cal.centerVal)
+            return cal.maxVal == cal.centerVal ? 0 : upper.apply(raw);
+        return cal.minVal == cal.centerVal ? 0 : lower.apply(raw);
+    }
+};
+
+static uint32_t seed = 1;
+
+static int randomBelow(int limit)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return (int)((seed >> 8) % (uint32_t)limit);
+}
+
+// Plausible ranges plus the edge cases: center on an extreme, outside the
+// range, or an empty range
+static Calibration randomCalibration(int index)
+{
+    Calibration calibration;
+    calibration.minVal = randomBelow(1200);
+    calibration.maxVal = ADC_MAX_VALUE - randomBelow(1200);
+    calibration.centerVal = calibration.minVal + randomBelow(calibration.maxVal - calibration.minVal + 1);
+    switch (index % 16)
+    {
+    case 0:
+        calibration.centerVal = calibration.minVal;
+        break;
+    case 1:
+        calibration.centerVal = calibration.maxVal;
+        break;
+    case 2:
+        calibration.centerVal = calibration.maxVal + 50;
+        break;
+    case 3:
+        calibration.maxVal = calibration.minVal;
+        break;
+    }
+    return calibration;
+}
+
+static double nanosSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// LinearMap against map() for every span length in the ADC range, both signs
+static void test_linear_map_matches_arduino_map()
+{
+    LinearMap map;
+    long checked = 0;
+    for (int run = 1; run <= ADC_MAX_VALUE; run++)
+    {
+        for (int sign = -1; sign <= 1; sign += 2)
+        {
+            int inMin = (ADC_MAX_VALUE - run) / 2;
+            map.configure(inMin, inMin + run, 0, sign * MAX_OUTPUT);
+            for (int x = inMin; x <= inMin + run; x++)
+            {
+                int expected = arduinoMap(x, inMin, inMin + run, 0, sign * MAX_OUTPUT);
+                if (map.apply(x) != expected)
+                {
+                    printf("run %d x %d: %d, map() %d\n", run, x, (int)map.apply(x), expected);
+                    TEST_FAIL_MESSAGE("LinearMap differs from map()");
+                }
+                checked++;
+            }
+        }
+    }
+    printf("LinearMap matches map() at %ld points\n", checked);
+}
+
+static void test_kernels_bit_identical()
+{
+    static TableAxisMap table; // 8 KB each, kept off the stack
+    static FixedAxisMap fixed;
+    static AxisMapper mapper;
+
+    for (int c = 0; c < BENCH_CALIBRATIONS; c++)
+    {
+        Calibration cal = randomCalibration(c);
+        table.build(cal);
+        fixed.build(cal);
+        mapper.build(cal.minVal, cal.maxVal, cal.centerVal);
+
+        // A few counts past both ends of the ADC range exercise the clamp
+        for (int raw = ADC_MIN_VALUE - 8; raw <= ADC_MAX_VALUE + 8; raw++)
+        {
+            int clamped = raw < ADC_MIN_VALUE ? ADC_MIN_VALUE : (raw > ADC_MAX_VALUE ? ADC_MAX_VALUE : raw);
+            int expected = referenceMapToRange(clamped, cal.minVal, cal.maxVal, cal.centerVal);
+            if (table.map(raw) != expected || fixed.map(raw) != expected || mapper.map(raw) != expected)
+            {
+                printf("min %d max %d center %d raw %d: table %d, fixed %d, AxisMapper %d, reference %d\n",
+                       cal.minVal, cal.maxVal, cal.centerVal, raw, table.map(raw), fixed.map(raw), mapper.map(raw),
+                       expected);
+                TEST_FAIL_MESSAGE("mapping kernels differ");
+            }
+        }
+    }
+
+    LinearMap pwmMap;
+    pwmMap.configure(0, 100, MIN_SPEED, MAX_SPEED);
+    SpeedMapper speed;
+    for (int percent = 0; percent <= 100; percent++)
+    {
+        TEST_ASSERT_EQUAL(referencePercentToPWM(percent), pwmMap.apply(percent));
+        TEST_ASSERT_EQUAL(referencePercentToPWM(percent), speed.percentToPWM(percent));
+    }
+    printf("Table and fixed kernels match the reference: %d calibrations x %d raw values, 101 percents\n",
+           BENCH_CALIBRATIONS, ADC_MAX_VALUE + 1 + 16);
+}
+
+template <class Map>
+static double timeMap(const Map *maps, const int *input, long &checksum)
+{
+    checksum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < BENCH_SAMPLES; i++)
+    {
+        checksum += maps[i % BENCH_AXES].map(input[i % INPUT_SAMPLES]);
+    }
+    return nanosSince(start) / BENCH_SAMPLES;
+}
+
+template <class Map>
+static double timeRebuild(Map *maps, const Calibration *calibrations)
+{
+    const int rebuilds = 2000;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rebuilds; i++)
+    {
+        Calibration cal = calibrations[i % BENCH_AXES];
+        cal.centerVal += i & 7;
+        maps[i % BENCH_AXES].build(cal);
+    }
+    return nanosSince(start) / rebuilds / 1000.0;
+}
+
+static void test_mapping_benchmark()
+{
+    static TableAxisMap tables[BENCH_AXES];
+    static FixedAxisMap fixed[BENCH_AXES];
+    static int input[INPUT_SAMPLES];
+    Calibration calibrations[BENCH_AXES];
+    for (int axis = 0; axis < BENCH_AXES; axis++)
+    {
+        calibrations[axis] = randomCalibration(axis + 4); // Skip the edge cases
+        tables[axis].build(calibrations[axis]);
+        fixed[axis].build(calibrations[axis]);
+    }
+    for (int i = 0; i < INPUT_SAMPLES; i++)
+    {
+        input[i] = randomBelow(ADC_MAX_VALUE + 1);
+    }
+
+    long checksum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < BENCH_SAMPLES; i++)
+    {
+        const Calibration &cal = calibrations[i % BENCH_AXES];
+        checksum += referenceMapToRange(input[i % INPUT_SAMPLES], cal.minVal, cal.maxVal, cal.centerVal);
+    }
+    double referenceNs = nanosSince(start) / BENCH_SAMPLES;
+
+    long tableChecksum, fixedChecksum;
+    double tableNs = timeMap(tables, input, tableChecksum);
+    double fixedNs = timeMap(fixed, input, fixedChecksum);
+    TEST_ASSERT_EQUAL(checksum, tableChecksum);
+    TEST_ASSERT_EQUAL(checksum, fixedChecksum);
+
+    long pwmChecksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < BENCH_SAMPLES; i++)
+    {
+        pwmChecksum += referencePercentToPWM(input[i % INPUT_SAMPLES] % 101);
+    }
+    double referencePwmNs = nanosSince(start) / BENCH_SAMPLES;
+
+    SpeedMapper speed;
+    long kernelPwmChecksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < BENCH_SAMPLES; i++)
+    {
+        kernelPwmChecksum += speed.percentToPWM(input[i % INPUT_SAMPLES] % 101);
+    }
+    double kernelPwmNs = nanosSince(start) / BENCH_SAMPLES;
+    TEST_ASSERT_EQUAL(pwmChecksum, kernelPwmChecksum);
+
+    double tableRebuildUs = timeRebuild(tables, calibrations);
+    double fixedRebuildUs = timeRebuild(fixed, calibrations);
+
+    printf("%ld samples over %d calibrations; AxisMapper uses the %s kernel\n", (long)BENCH_SAMPLES, BENCH_AXES,
+           MAPPING_KERNEL == MAPPING_KERNEL_LUT ? "table" : "fixed");
+    printf("path                  ns/sample   rebuild us/axis\n");
+    printf("reference map         %9.2f\n", referenceNs);
+    printf("table map             %9.2f   %9.2f\n", tableNs, tableRebuildUs);
+    printf("fixed map             %9.2f   %9.2f\n", fixedNs, fixedRebuildUs);
+    printf("reference percent     %9.2f\n", referencePwmNs);
+    printf("kernel percent        %9.2f\n", kernelPwmNs);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_linear_map_matches_arduino_map);
+    RUN_TEST(test_kernels_bit_identical);
+    RUN_TEST(test_mapping_benchmark);
+    return UNITY_END();
+}
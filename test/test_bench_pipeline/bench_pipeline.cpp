@@ -0,0 +1,214 @@
+// Host benchmark of the control path: synthetic ADC frames through
+// JoystickController::read(), SimpleControlMapper::processInput(), the
+// LCD status formatting and the framebuffer diff. Reports ns/op and heap
+// allocations per stage; any allocation on the hot path fails the run.
+//
+//   pio test -e native_bench
+//
+// Each stage runs over a batch of the previous stage's output, so the
+// clock is read once per batch, not once per sample. BENCH_SAMPLES sets
+// the run length (-DBENCH_SAMPLES=... in build_flags).
+
+#include "joystick.h"
+#include "control_mapper.h"
+#include "lcd_format.h"
+#include "lcd_framebuffer.h"
+#include "host_adc_source.h"
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef BENCH_SAMPLES
+#define BENCH_SAMPLES 2000000L
+#endif
+
+static const int BATCH = 4096;
+static const int CAL_MIN = 200;
+static const int CAL_MAX = 3900;
+
+// Every heap allocation in the process goes through here
+static std::atomic<unsigned long> allocations(0);
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void *block = malloc(size > 0 ? size : 1);
+    if (block == nullptr)
+        throw std::bad_alloc();
+    return block;
+}
+
+void operator delete(void *block) noexcept
+{
+    free(block);
+}
+
+// Rest noise while calibrating; afterwards triangle sweeps with the stick
+// parked now and then, plus an occasional spike
+struct SignalState
+{
+    bool moving;
+};
+
+static AdcFrame generateFrame(uint32_t index, void *context)
+{
+    const SignalState *state = (const SignalState *)context;
+    AdcFrame frame = {};
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        int noise = (int)(((index * 2654435761u) ^ (axis * 40503u)) >> 27) - 16;
+        int value = ADC_DEFAULT_CENTER + noise;
+
+        uint32_t t = (index / ADC_OVERSAMPLE_FRAMES) % 8192;
+        if (state->moving && t >= 2048)
+        {
+            int phase = (int)((t * 3 + axis * 1300) % 4096);
+            int sweep = phase < 2048 ? phase * 2 : (4095 - phase) * 2;
+            value = CAL_MIN + sweep * (CAL_MAX - CAL_MIN) / 4096 + noise;
+            if ((index + axis) % 7919 == 0)
+                value = ADC_MAX_VALUE;
+        }
+        frame.value[axis] = (uint16_t)(value < 0 ? 0 : (value > ADC_MAX_VALUE ? ADC_MAX_VALUE : value));
+    }
+    return frame;
+}
+
+// Counts what a flush would send to the LCD
+class CountingSink : public LcdSink
+{
+public:
+    unsigned long runs = 0;
+    unsigned long chars = 0;
+
+    void setCursor(uint8_t, uint8_t) override { runs++; }
+    void write(const char *, uint8_t length) override { chars += length; }
+};
+
+struct StageResult
+{
+    const char *name;
+    double nanos;
+    unsigned long allocations;
+};
+
+static SignalState signalState = {false};
+static SyntheticAdcSource adcSource(generateFrame, &signalState, ADC_OVERSAMPLE_FRAMES, JOYSTICK_AXES);
+static MemoryCalibrationStorage storage;
+static JoystickController joystick;
+static SimpleControlMapper mapper;
+static LcdFramebuffer framebuffer;
+static CountingSink sink;
+
+static JoystickPosition positions[BATCH];
+static SimpleMotorCommand commands[BATCH];
+static LcdLine line1[BATCH];
+static LcdLine line2[BATCH];
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// Warm boot from a stored record: a 100 ms center check instead of a
+// full calibration that needs the stick moved
+static void calibrate()
+{
+    StoredCalibration stored;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        stored.data.min[axis] = CAL_MIN;
+        stored.data.max[axis] = CAL_MAX;
+        stored.data.center[axis] = ADC_DEFAULT_CENTER;
+    }
+    stored.data.isCalibrated = true;
+    stored.calibrationMs = 0;
+    saveCalibration(storage, stored);
+
+    joystick.setAdcSource(&adcSource);
+    joystick.setCalibrationStorage(&storage);
+    joystick.begin();
+    mapper.begin();
+
+    joystick.startCalibration();
+    while (joystick.isCalibrating())
+    {
+        joystick.updateCalibration();
+    }
+    signalState.moving = true;
+}
+
+template <class Stage>
+static void runStage(StageResult &result, Stage stage)
+{
+    unsigned long before = allocations.load(std::memory_order_relaxed);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BATCH; i++)
+    {
+        stage(i);
+    }
+    result.nanos += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    result.allocations += allocations.load(std::memory_order_relaxed) - before;
+}
+
+static void test_control_path_benchmark()
+{
+    calibrate();
+    TEST_ASSERT_TRUE_MESSAGE(joystick.isCalibrated(), "warm boot did not verify the stored calibration");
+
+    StageResult stages[] = {
+        {"read()", 0.0, 0},
+        {"processInput()", 0.0, 0},
+        {"LCD format", 0.0, 0},
+        {"LCD diff", 0.0, 0},
+    };
+    const int stageCount = sizeof(stages) / sizeof(stages[0]);
+
+    long batches = (BENCH_SAMPLES + BATCH - 1) / BATCH;
+    long checksum = 0;
+    for (long b = 0; b < batches; b++)
+    {
+        runStage(stages[0], [](int i) { positions[i] = joystick.read(); });
+        runStage(stages[1], [](int i) { commands[i] = mapper.processInput(positions[i]); });
+        runStage(stages[2], [](int i) {
+            formatJoystickLine(line1[i], positions[i], commands[i]);
+            formatDirectionLine(line2[i], commands[i]);
+        });
+        runStage(stages[3], [](int i) {
+            framebuffer.setLine(0, line1[i]);
+            framebuffer.setLine(1, line2[i]);
+            framebuffer.flush(sink);
+        });
+        checksum += positions[BATCH - 1].axis[AXIS_Y] + commands[BATCH - 1].speedPWM;
+    }
+
+    long samples = batches * BATCH;
+    double total = 0.0;
+    printf("%ld samples (checksum %ld, %lu glitches, %lu LCD runs)\n", samples, checksum,
+           joystick.getRejectedSamples(), sink.runs);
+    printf("stage             ns/op   allocs/op\n");
+    for (int s = 0; s < stageCount; s++)
+    {
+        total += stages[s].nanos;
+        printf("%-16s %6.1f   %9.6f\n", stages[s].name, stages[s].nanos / samples,
+               (double)stages[s].allocations / samples);
+    }
+    printf("%-16s %6.1f\n", "total", total / samples);
+
+    for (int s = 0; s < stageCount; s++)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(0, stages[s].allocations, stages[s].name);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_control_path_benchmark);
+    return UNITY_END();
+}
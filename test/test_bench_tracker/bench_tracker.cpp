@@ -0,0 +1,255 @@
+// Host run of the alpha-beta tracker against the moving average it would
+// replace. Feeds noisy step and ramp traces at FILTER_SAMPLE_RATE_HZ and
+// measures, per filter, the group delay (step: time to half height; ramp:
+// mean lag behind the true position), the overshoot past the final value
+// and the output jitter at rest, each averaged over BENCH_SEEDS noise
+// seeds. The tracker must lag less than the moving average on both shapes,
+// follow a ramp with no lag of its own (minus the lead), and still damp
+// the noise at rest.
+//
+//   pio test -e native_bench
+//
+// BENCH_NOISE sets the noise std dev, BENCH_SEEDS the number of seeds
+// (-D... in build_flags).
+
+#include "filters.h"
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+
+#ifndef BENCH_NOISE
+#define BENCH_NOISE 3.0f
+#endif
+
+#ifndef BENCH_SEEDS
+#define BENCH_SEEDS 50
+#endif
+
+static const int REST_TICKS = FILTER_SAMPLE_RATE_HZ / 2; // Before the move
+static const int MOVE_TICKS = FILTER_SAMPLE_RATE_HZ / 2; // After it starts
+static const int STEP_HEIGHT = 400;                      // Output units
+static const int RAMP_TICKS = FILTER_SAMPLE_RATE_HZ / 5; // 200 ms full-scale ramp
+static const float TICK_MS = 1000.0f / FILTER_SAMPLE_RATE_HZ;
+
+// Deterministic Gaussian noise (xorshift32 + Box-Muller)
+class GaussianNoise
+{
+private:
+    uint32_t state;
+
+    float uniform()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return ((state >> 8) + 0.5f) / 16777216.0f;
+    }
+
+public:
+    explicit GaussianNoise(uint32_t seed) : state(seed) {}
+
+    float next(float stdDev)
+    {
+        float u1 = uniform();
+        float u2 = uniform();
+        return stdDev * sqrtf(-2.0f * logf(u1)) * cosf(2.0f * 3.14159265f * u2);
+    }
+};
+
+enum Shape
+{
+    SHAPE_STEP,
+    SHAPE_RAMP
+};
+
+static float truth(Shape shape, int tick)
+{
+    if (tick < REST_TICKS)
+        return 0.0f;
+    if (shape == SHAPE_STEP)
+        return (float)STEP_HEIGHT;
+    int t = tick - REST_TICKS;
+    return t >= RAMP_TICKS ? (float)MAX_OUTPUT : (float)MAX_OUTPUT * t / RAMP_TICKS;
+}
+
+struct Metrics
+{
+    double delayMs;    // Step: to half height; ramp: mean lag while ramping
+    double overshoot;  // Percent of the final value
+    double restJitter; // Output std dev at rest
+};
+
+// Runs one filter over one noisy trace
+template <class Filter>
+static Metrics run(Filter filter, Shape shape, const int *input)
+{
+    const int ticks = REST_TICKS + MOVE_TICKS;
+    static int output[REST_TICKS + MOVE_TICKS];
+    for (int tick = 0; tick < ticks; tick++)
+    {
+        output[tick] = filter.update(input[tick]);
+    }
+
+    Metrics metrics = {0.0, 0.0, 0.0};
+    double sum = 0.0, sumSq = 0.0;
+    for (int tick = REST_TICKS / 2; tick < REST_TICKS; tick++)
+    {
+        sum += output[tick];
+        sumSq += (double)output[tick] * output[tick];
+    }
+    int restCount = REST_TICKS - REST_TICKS / 2;
+    double mean = sum / restCount;
+    metrics.restJitter = sqrt(sumSq / restCount - mean * mean);
+
+    float final = truth(shape, ticks - 1);
+    int peak = 0;
+    for (int tick = REST_TICKS; tick < ticks; tick++)
+    {
+        if (output[tick] > peak)
+            peak = output[tick];
+    }
+    metrics.overshoot = peak > final ? 100.0 * (peak - final) / final : 0.0;
+
+    if (shape == SHAPE_STEP)
+    {
+        // Interpolated between the ticks either side of the crossing
+        int tick = REST_TICKS;
+        while (tick < ticks - 1 && output[tick] < final / 2)
+        {
+            tick++;
+        }
+        float before = (float)output[tick - 1];
+        float rise = output[tick] - before;
+        float fraction = rise > 0.0f ? (final / 2 - before) / rise : 0.0f;
+        metrics.delayMs = (tick - 1 - REST_TICKS + fraction) * TICK_MS;
+    }
+    else
+    {
+        // Skip the first quarter of the ramp while the filters catch up
+        const float slope = (float)MAX_OUTPUT / RAMP_TICKS; // Units per tick
+        double lag = 0.0;
+        int count = 0;
+        for (int tick = REST_TICKS + RAMP_TICKS / 4; tick < REST_TICKS + RAMP_TICKS; tick++)
+        {
+            lag += (truth(shape, tick) - output[tick]) / slope;
+            count++;
+        }
+        metrics.delayMs = lag / count * TICK_MS;
+    }
+    return metrics;
+}
+
+enum FilterIndex
+{
+    MOVING_AVERAGE,
+    ONE_EURO,
+    ALPHA_BETA,
+    ALPHA_BETA_LEAD,
+    FILTERS
+};
+
+static const char *const FILTER_NAMES[FILTERS] = {
+    "moving average",
+    "one-euro",
+    "alpha-beta",
+    "alpha-beta + lead",
+};
+
+static void accumulate(Metrics &total, const Metrics &metrics)
+{
+    total.delayMs += metrics.delayMs / BENCH_SEEDS;
+    total.overshoot += metrics.overshoot / BENCH_SEEDS;
+    total.restJitter += metrics.restJitter / BENCH_SEEDS;
+}
+
+// Every filter over BENCH_SEEDS noisy traces of one shape; averages go to
+// results[] and the summary to stdout
+static void simulate(Shape shape, Metrics *results)
+{
+    const int ticks = REST_TICKS + MOVE_TICKS;
+    static int input[REST_TICKS + MOVE_TICKS];
+    for (int f = 0; f < FILTERS; f++)
+    {
+        Metrics zero = {0.0, 0.0, 0.0};
+        results[f] = zero;
+    }
+
+    for (int seed = 1; seed <= BENCH_SEEDS; seed++)
+    {
+        GaussianNoise noise((uint32_t)seed * 2654435761u);
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            input[tick] = (int)lroundf(truth(shape, tick) + noise.next(BENCH_NOISE));
+        }
+
+        OneEuroFilter oneEuro;
+        oneEuro.setNoise(BENCH_NOISE);
+        accumulate(results[MOVING_AVERAGE], run(MovingAverageFilter<FILTER_SAMPLES>(), shape, input));
+        accumulate(results[ONE_EURO], run(oneEuro, shape, input));
+        accumulate(results[ALPHA_BETA],
+                   run(AlphaBetaTracker(TRACKER_ALPHA, TRACKER_BETA, FILTER_SAMPLE_RATE_HZ, 0.0f), shape, input));
+        accumulate(results[ALPHA_BETA_LEAD], run(AlphaBetaTracker(), shape, input));
+    }
+
+    printf("%s (%s, noise sd %.1f, %d seeds)\n", shape == SHAPE_STEP ? "Step" : "Ramp",
+           shape == SHAPE_STEP ? "delay = time to half height" : "delay = mean lag", BENCH_NOISE, BENCH_SEEDS);
+    printf("  filter               delay ms  overshoot %%  rest jitter\n");
+    for (int f = 0; f < FILTERS; f++)
+    {
+        printf("  %-19s %9.2f  %11.2f  %11.2f\n", FILTER_NAMES[f], results[f].delayMs, results[f].overshoot,
+               results[f].restJitter);
+    }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// Half height of a step: the tracker gets there sooner, at the price of
+// a bounded overshoot; less lag must not mean passing the noise through
+static void test_step_delay_below_moving_average()
+{
+    Metrics results[FILTERS];
+    simulate(SHAPE_STEP, results);
+
+    TEST_ASSERT_LESS_THAN(results[MOVING_AVERAGE].delayMs, results[ALPHA_BETA].delayMs);
+    TEST_ASSERT_LESS_THAN(results[MOVING_AVERAGE].delayMs, results[ALPHA_BETA_LEAD].delayMs);
+    TEST_ASSERT_LESS_THAN(results[ALPHA_BETA].delayMs, results[ALPHA_BETA_LEAD].delayMs);
+    TEST_ASSERT_LESS_THAN(25.0, results[ALPHA_BETA].overshoot);
+    TEST_ASSERT_LESS_THAN(40.0, results[ALPHA_BETA_LEAD].overshoot);
+    for (int f = 0; f < FILTERS; f++)
+    {
+        TEST_ASSERT_LESS_THAN_MESSAGE(0.75 * BENCH_NOISE, results[f].restJitter, FILTER_NAMES[f]);
+    }
+}
+
+// The moving average trails a ramp by (N - 1) / 2 samples; the tracker
+// estimates the velocity and has no lag, or leads by PIPELINE_DELAY_MS
+static void test_ramp_lag_below_moving_average()
+{
+    Metrics results[FILTERS];
+    simulate(SHAPE_RAMP, results);
+
+    const double boxcarMs = (FILTER_SAMPLES - 1) / 2.0 * TICK_MS;
+    TEST_ASSERT_FLOAT_WITHIN(0.5, boxcarMs, results[MOVING_AVERAGE].delayMs);
+    TEST_ASSERT_LESS_THAN(results[MOVING_AVERAGE].delayMs, results[ALPHA_BETA].delayMs);
+    TEST_ASSERT_LESS_THAN(results[MOVING_AVERAGE].delayMs, results[ALPHA_BETA_LEAD].delayMs);
+    TEST_ASSERT_FLOAT_WITHIN(0.5, 0.0, results[ALPHA_BETA].delayMs);
+    TEST_ASSERT_FLOAT_WITHIN(0.5, -(double)PIPELINE_DELAY_MS, results[ALPHA_BETA_LEAD].delayMs);
+    TEST_ASSERT_LESS_THAN(5.0, results[ALPHA_BETA_LEAD].overshoot);
+}
+
+int main()
+{
+    printf("%d Hz, moving average of %d, tracker alpha %.3f beta %.3f, lead %d ms\n", FILTER_SAMPLE_RATE_HZ,
+           FILTER_SAMPLES, TRACKER_ALPHA, TRACKER_BETA, PIPELINE_DELAY_MS);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_step_delay_below_moving_average);
+    RUN_TEST(test_ramp_lag_below_moving_average);
+    return UNITY_END();
+}
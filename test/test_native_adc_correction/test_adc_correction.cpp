@@ -0,0 +1,221 @@
+// Oversample-and-decimate and the ADC linearizer against synthetic
+// captures: decimated readings resolve below one code and average the
+// noise down, and the linearizer undoes a bowed transfer curve
+#include "adc_correction.h"
+#include <unity.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// esp_adc_cal's typical 11 dB line: ~0.81 mV per code from 142 mV
+static AdcLinearModel typicalModel = {53000, 142};
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// Deterministic Gaussian noise (xorshift32 + Box-Muller)
+class GaussianNoise
+{
+private:
+    uint32_t state;
+
+    float uniform()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return ((state >> 8) + 0.5f) / 16777216.0f;
+    }
+
+public:
+    explicit GaussianNoise(uint32_t seed) : state(seed) {}
+
+    float next(float stdDev)
+    {
+        float u1 = uniform();
+        float u2 = uniform();
+        return stdDev * sqrtf(-2.0f * logf(u1)) * cosf(2.0f * 3.14159265f * u2);
+    }
+};
+
+// One ADC conversion of a level (in codes) with noise, quantized and clamped
+static uint32_t convert(float level, float noiseCodes, GaussianNoise &noise)
+{
+    long code = lroundf(level + noise.next(noiseCodes));
+    return (uint32_t)(code < 0 ? 0 : (code > ADC_MAX_VALUE ? ADC_MAX_VALUE : code));
+}
+
+static void test_decimate_exact()
+{
+    TEST_ASSERT_EQUAL_UINT32(0, decimate(12345, 0, 2));
+    TEST_ASSERT_EQUAL_UINT32(1000 * 4, decimate(1000 * 16, 16, 2));
+    TEST_ASSERT_EQUAL_UINT32(1000, decimate(1000 * 16, 16, 0));
+    TEST_ASSERT_EQUAL_UINT32(ADC_MAX_VALUE * 4, decimate(ADC_MAX_VALUE * 64, 64, 2));
+
+    // Mean 1000.25 keeps its quarter code with two extra bits
+    TEST_ASSERT_EQUAL_UINT32(4001, decimate(1000 * 16 + 4, 16, 2));
+    // Rounded, not truncated: 1000.5 -> 1001 without extra bits
+    TEST_ASSERT_EQUAL_UINT32(1001, decimate(1000 * 16 + 8, 16, 0));
+    // Any frame count, e.g. the 20 of one tick
+    TEST_ASSERT_EQUAL_UINT32(2000 * 4 + 1, decimate(2000 * 20 + 5, 20, 2));
+}
+
+// 16 noisy frames per reading: the mean sits on the sub-code level and the
+// reading-to-reading spread shrinks by about sqrt(16)
+static void test_decimate_noisy_capture()
+{
+    GaussianNoise noise(7);
+    const float level = 1834.3f;
+    const int readings = 2000;
+    double sumRaw = 0.0, sumRawSq = 0.0, sumDec = 0.0, sumDecSq = 0.0;
+
+    for (int r = 0; r < readings; r++)
+    {
+        uint32_t sum = 0;
+        for (int f = 0; f < 16; f++)
+        {
+            uint32_t code = convert(level, 2.0f, noise);
+            sum += code;
+            if (f == 0)
+            {
+                sumRaw += code;
+                sumRawSq += (double)code * code;
+            }
+        }
+        double value = decimate(sum, 16, 2) / 4.0;
+        sumDec += value;
+        sumDecSq += value * value;
+    }
+
+    double meanRaw = sumRaw / readings;
+    double sdRaw = sqrt(sumRawSq / readings - meanRaw * meanRaw);
+    double meanDec = sumDec / readings;
+    double sdDec = sqrt(sumDecSq / readings - meanDec * meanDec);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, level, (float)meanDec);
+    TEST_ASSERT_FLOAT_WITHIN(0.2f, 2.0f, (float)sdRaw);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, (float)sdRaw / 4.0f, (float)sdDec);
+}
+
+// A straight transfer: millivolts follow the model, codes map back onto
+// themselves, and fractional input interpolates between codes
+static void test_linear_model_round_trip()
+{
+    static AdcLinearizer linearizer; // 8 KB table
+    TEST_ASSERT_TRUE(linearizer.build(linearModelTransfer, &typicalModel));
+    TEST_ASSERT_EQUAL_UINT16(0, linearizer.getRepairs());
+
+    for (uint32_t code = 0; code <= (uint32_t)ADC_MAX_VALUE; code += 13)
+    {
+        uint32_t expected = linearModelTransfer(code, &typicalModel);
+        TEST_ASSERT_UINT32_WITHIN(1, expected, linearizer.toMillivolts(code));
+        TEST_ASSERT_INT_WITHIN(1, (int)code, linearizer.toCode(code));
+    }
+    TEST_ASSERT_EQUAL(0, linearizer.toCode(0));
+    TEST_ASSERT_EQUAL(ADC_MAX_VALUE, linearizer.toCode(ADC_MAX_VALUE));
+    TEST_ASSERT_EQUAL(ADC_MAX_VALUE, linearizer.toCode(ADC_MAX_VALUE << 2, 2));
+
+    // 2000.5 in Q2 lands halfway between its neighbours
+    int low = linearizer.toCode(2000);
+    int high = linearizer.toCode(2001);
+    int half = linearizer.toCode(2000 * 4 + 2, 2);
+    TEST_ASSERT_TRUE(half >= low && half <= high);
+}
+
+// Bowed converter: the code sags below the line mid-scale (as the ESP32
+// ADC does near the top), plus a dip that breaks monotonicity
+static uint32_t bowedTransfer(uint32_t raw, void *)
+{
+    float t = raw / (float)ADC_MAX_VALUE;
+    float mv = 150.0f + 2300.0f * t + 120.0f * t * t;
+    if (raw == 3000)
+        mv -= 6.0f;
+    return (uint32_t)lroundf(mv);
+}
+
+// Inverse of bowedTransfer (without the dip): the code a voltage reads as
+static float codeForMillivolts(float mv)
+{
+    // 120 t^2 + 2300 t + 150 - mv = 0
+    float t = (-2300.0f + sqrtf(2300.0f * 2300.0f - 4.0f * 120.0f * (150.0f - mv))) / 240.0f;
+    return t * ADC_MAX_VALUE;
+}
+
+// Captured sweep through the bowed converter, decimated: corrected codes
+// are linear in the input voltage, raw codes are not
+static void test_linearizer_corrects_bowed_capture()
+{
+    static AdcLinearizer linearizer;
+    TEST_ASSERT_TRUE(linearizer.build(bowedTransfer, nullptr));
+    TEST_ASSERT_GREATER_THAN(0, linearizer.getRepairs());
+
+    GaussianNoise noise(3);
+    const float lowMv = 150.0f, highMv = 2570.0f;
+    int worstRaw = 0, worstCorrected = 0, previous = -1;
+    for (float mv = 200.0f; mv < 2550.0f; mv += 7.3f)
+    {
+        float level = codeForMillivolts(mv);
+        uint32_t sum = 0;
+        for (int f = 0; f < 16; f++)
+        {
+            sum += convert(level, 1.5f, noise);
+        }
+        uint32_t value = decimate(sum, 16, 2);
+        int corrected = linearizer.toCode(value, 2);
+        int ideal = (int)lroundf((mv - lowMv) / (highMv - lowMv) * ADC_MAX_VALUE);
+
+        int rawError = abs((int)((value + 2) >> 2) - ideal);
+        int correctedError = abs(corrected - ideal);
+        worstRaw = rawError > worstRaw ? rawError : worstRaw;
+        worstCorrected = correctedError > worstCorrected ? correctedError : worstCorrected;
+
+        TEST_ASSERT_GREATER_OR_EQUAL(previous - 2, corrected); // Noise aside, never backwards
+        previous = corrected;
+    }
+
+    TEST_ASSERT_GREATER_THAN(40, worstRaw);
+    TEST_ASSERT_LESS_OR_EQUAL(4, worstCorrected);
+}
+
+// The repaired table never decreases, so neither does toCode()
+static void test_linearizer_monotonic()
+{
+    static AdcLinearizer linearizer;
+    linearizer.build(bowedTransfer, nullptr);
+    int previous = linearizer.toCode(0, 2);
+    for (uint32_t value = 1; value <= (uint32_t)ADC_MAX_VALUE << 2; value++)
+    {
+        int code = linearizer.toCode(value, 2);
+        TEST_ASSERT_GREATER_OR_EQUAL(previous, code);
+        previous = code;
+    }
+}
+
+static uint32_t flatTransfer(uint32_t, void *)
+{
+    return 1000;
+}
+
+static void test_flat_transfer_rejected()
+{
+    static AdcLinearizer linearizer;
+    TEST_ASSERT_FALSE(linearizer.build(flatTransfer, nullptr));
+    TEST_ASSERT_FALSE(linearizer.isReady());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_decimate_exact);
+    RUN_TEST(test_decimate_noisy_capture);
+    RUN_TEST(test_linear_model_round_trip);
+    RUN_TEST(test_linearizer_corrects_bowed_capture);
+    RUN_TEST(test_linearizer_monotonic);
+    RUN_TEST(test_flat_transfer_rejected);
+    return UNITY_END();
+}
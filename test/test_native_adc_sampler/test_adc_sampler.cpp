@@ -0,0 +1,204 @@
+// Consumer side of the continuous ADC path: AdcSampler draining synthetic
+// and recorded sources, per-axis demux, ring wraparound, the new-frame
+// cursor, and overruns when the source has run ahead
+#include "adc_sampler.h"
+#include "host_adc_source.h"
+#include <unity.h>
+#include <stdio.h>
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// Frame i carries i * 10 + axis on each axis, so any mix-up shows
+static AdcFrame countingFrame(uint32_t index, void *)
+{
+    AdcFrame frame = {};
+    for (int axis = 0; axis < ADC_MAX_CHANNELS; axis++)
+    {
+        frame.value[axis] = (uint16_t)((index * 10 + axis) & 0xFFFF);
+    }
+    return frame;
+}
+
+static void test_begin_checks_source()
+{
+    AdcSampler sampler;
+    TEST_ASSERT_FALSE(sampler.begin(nullptr));
+
+    SyntheticAdcSource narrow(countingFrame, nullptr, 1, JOYSTICK_AXES - 1);
+    TEST_ASSERT_FALSE(sampler.begin(&narrow));
+
+    SyntheticAdcSource noGenerator(nullptr);
+    TEST_ASSERT_FALSE(sampler.begin(&noGenerator));
+    TEST_ASSERT_FALSE(sampler.isRunning());
+    TEST_ASSERT_EQUAL(0, sampler.poll());
+
+    AdcFrame frame;
+    TEST_ASSERT_FALSE(sampler.latest(frame));
+}
+
+static void test_demux_per_axis()
+{
+    SyntheticAdcSource source(countingFrame, nullptr, 5, JOYSTICK_AXES);
+    AdcSampler sampler;
+    TEST_ASSERT_TRUE(sampler.begin(&source));
+    TEST_ASSERT_EQUAL(5, sampler.poll());
+
+    AdcFrame frames[8];
+    TEST_ASSERT_EQUAL(5, sampler.recent(frames, 8));
+    for (int i = 0; i < 5; i++)
+    {
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            TEST_ASSERT_EQUAL_UINT16(i * 10 + axis, frames[i].value[axis]);
+        }
+    }
+
+    AdcFrame newest;
+    TEST_ASSERT_TRUE(sampler.latest(newest));
+    TEST_ASSERT_EQUAL_UINT16(41, newest.value[1]);
+
+    uint32_t sums[JOYSTICK_AXES];
+    TEST_ASSERT_EQUAL(3, sampler.sumNew(3, sums));
+    TEST_ASSERT_EQUAL_UINT32(20 + 30 + 40, sums[0]);
+    TEST_ASSERT_EQUAL_UINT32(21 + 31 + 41, sums[1]);
+}
+
+// Polls of 7 frames past the end of the ring: recent() and sumNew() see
+// the newest frames, oldest first, across the wrap
+static void test_ring_wraparound()
+{
+    SyntheticAdcSource source(countingFrame, nullptr, 7, JOYSTICK_AXES);
+    AdcSampler sampler;
+    sampler.begin(&source);
+
+    for (int i = 0; i < 13; i++) // 91 frames into a 64-frame ring
+    {
+        TEST_ASSERT_EQUAL(7, sampler.poll());
+    }
+    TEST_ASSERT_EQUAL_UINT32(91, sampler.framesReceived());
+
+    static AdcFrame frames[ADC_RING_FRAMES + 8];
+    TEST_ASSERT_EQUAL(ADC_RING_FRAMES, sampler.recent(frames, ADC_RING_FRAMES + 8));
+    uint32_t first = 91 - ADC_RING_FRAMES;
+    for (int i = 0; i < ADC_RING_FRAMES; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT16((first + i) * 10, frames[i].value[0]);
+        TEST_ASSERT_EQUAL_UINT16((first + i) * 10 + 1, frames[i].value[1]);
+    }
+
+    // A window straddling the end of the row
+    uint32_t sums[JOYSTICK_AXES];
+    TEST_ASSERT_EQUAL(40, sampler.sumNew(40, sums));
+    uint32_t expected = 0;
+    for (uint32_t i = 91 - 40; i < 91; i++)
+    {
+        expected += i * 10;
+    }
+    TEST_ASSERT_EQUAL_UINT32(expected, sums[0]);
+    TEST_ASSERT_EQUAL_UINT32(expected + 40, sums[1]);
+    TEST_ASSERT_EQUAL_UINT32(91 - ADC_RING_FRAMES, sampler.framesOverrun());
+}
+
+// Each frame is handed out by sumNew() at most once; a tick with nothing
+// new returns 0 instead of re-averaging old frames
+static void test_sum_new_consumes_frames()
+{
+    SyntheticAdcSource source(countingFrame, nullptr, 5, JOYSTICK_AXES);
+    AdcSampler sampler;
+    sampler.begin(&source);
+    uint32_t sums[JOYSTICK_AXES];
+
+    sampler.poll(); // Frames 0-4
+    TEST_ASSERT_EQUAL(5, sampler.sumNew(16, sums));
+    TEST_ASSERT_EQUAL_UINT32(0 + 10 + 20 + 30 + 40, sums[0]);
+    TEST_ASSERT_EQUAL(0, sampler.sumNew(16, sums));
+
+    sampler.poll(); // Frames 5-9: only these
+    TEST_ASSERT_EQUAL(5, sampler.sumNew(16, sums));
+    TEST_ASSERT_EQUAL_UINT32(50 + 60 + 70 + 80 + 90, sums[0]);
+
+    // More new frames than wanted: the newest ones, and the rest are gone
+    sampler.poll();
+    sampler.poll(); // Frames 10-19
+    TEST_ASSERT_EQUAL(4, sampler.sumNew(4, sums));
+    TEST_ASSERT_EQUAL_UINT32(160 + 170 + 180 + 190, sums[0]);
+    TEST_ASSERT_EQUAL(0, sampler.sumNew(4, sums));
+    TEST_ASSERT_EQUAL_UINT32(0, sampler.framesOverrun());
+}
+
+// A source that has run far ahead (a stalled consumer): one poll drains
+// at most a ring's worth and keeps the newest frames
+static void test_overrun_bounded_drain()
+{
+    SyntheticAdcSource source(countingFrame, nullptr, 1000, JOYSTICK_AXES);
+    AdcSampler sampler;
+    sampler.begin(&source);
+
+    TEST_ASSERT_EQUAL(ADC_RING_FRAMES, sampler.poll());
+    TEST_ASSERT_EQUAL_UINT32(ADC_RING_FRAMES, source.framesGenerated());
+
+    AdcFrame newest;
+    sampler.latest(newest);
+    TEST_ASSERT_EQUAL_UINT16((ADC_RING_FRAMES - 1) * 10, newest.value[0]);
+
+    TEST_ASSERT_EQUAL_UINT32(0, sampler.framesOverrun());
+
+    // Nobody took the first ring's worth: all of it is overrun
+    TEST_ASSERT_EQUAL(ADC_RING_FRAMES, sampler.poll());
+    sampler.latest(newest);
+    TEST_ASSERT_EQUAL_UINT16((2 * ADC_RING_FRAMES - 1) * 10, newest.value[0]);
+    TEST_ASSERT_EQUAL_UINT32(2 * ADC_RING_FRAMES, sampler.framesReceived());
+    TEST_ASSERT_EQUAL_UINT32(ADC_RING_FRAMES, sampler.framesOverrun());
+}
+
+// Recorded capture: comma or space separated, wraps when looping
+static void test_stream_source()
+{
+    FILE *capture = tmpfile();
+    TEST_ASSERT_NOT_NULL(capture);
+    fputs("100,200\n101 201\n102,\t202\n", capture);
+    rewind(capture);
+
+    StreamAdcSource source(capture, true, 4, JOYSTICK_AXES);
+    AdcSampler sampler;
+    TEST_ASSERT_TRUE(sampler.begin(&source));
+    TEST_ASSERT_EQUAL(4, sampler.poll());
+
+    AdcFrame frames[4];
+    TEST_ASSERT_EQUAL(4, sampler.recent(frames, 4));
+    const uint16_t x[4] = {100, 101, 102, 100};
+    for (int i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT16(x[i], frames[i].value[0]);
+        TEST_ASSERT_EQUAL_UINT16(x[i] + 100, frames[i].value[1]);
+    }
+
+    // Not looping: stops at the end, and at a malformed line
+    fclose(capture);
+    capture = tmpfile();
+    fputs("5,6\nbad\n7,8\n", capture);
+    rewind(capture);
+    StreamAdcSource once(capture, false, 8, JOYSTICK_AXES);
+    AdcFrame out[8];
+    TEST_ASSERT_EQUAL(1, once.readFrames(out, 8));
+    TEST_ASSERT_EQUAL_UINT16(6, out[0].value[1]);
+    fclose(capture);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_checks_source);
+    RUN_TEST(test_demux_per_axis);
+    RUN_TEST(test_ring_wraparound);
+    RUN_TEST(test_sum_new_consumes_frames);
+    RUN_TEST(test_overrun_bounded_drain);
+    RUN_TEST(test_stream_source);
+    return UNITY_END();
+}
@@ -0,0 +1,355 @@
+// Full calibration through JoystickController::updateCalibration() on a
+// simulated clock, one call per millisecond, with the stick scripted per
+// phase: early center exit on convergence, the range phase ending on
+// stable extremes or on its timeout, and which results get stored
+#include "joystick.h"
+#include "host_adc_source.h"
+#include "scheduler_clock.h"
+#include <unity.h>
+
+static const int REST_CENTER = 2010;
+static const int SWEEP_LOW = 300;
+static const int SWEEP_HIGH = 3800;
+static const int SWEEP_PERIOD = 400; // ms, triangle wave low -> high -> low
+static const int FRAMES_PER_POLL = 4;
+static const int MAX_TRANSITIONS = 16;
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// Stick position the ADC reports, set by the script before every tick
+struct Stick
+{
+    int level[JOYSTICK_AXES];
+};
+
+static AdcFrame stickFrame(uint32_t, void *context)
+{
+    const Stick *stick = (const Stick *)context;
+    AdcFrame frame = {};
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        frame.value[axis] = (uint16_t)stick->level[axis];
+    }
+    return frame;
+}
+
+struct Transition
+{
+    CalibrationState state;
+    uint32_t atMs; // Since startCalibration()
+};
+
+// Controller wired to a scripted ADC, in-memory storage and a simulated
+// clock; run() records every state change
+class CalibrationRig
+{
+private:
+    SimulatedClock clock;
+    Stick stick;
+    SyntheticAdcSource source;
+
+public:
+    MemoryCalibrationStorage storage;
+    JoystickController joystick;
+    Transition transitions[MAX_TRANSITIONS];
+    int transitionCount;
+    uint32_t elapsedMs;
+
+    CalibrationRig() : clock(1000000), source(stickFrame, &stick, FRAMES_PER_POLL, JOYSTICK_AXES)
+    {
+        transitionCount = 0;
+        elapsedMs = 0;
+        setStick(REST_CENTER);
+        joystick.setAdcSource(&source);
+        joystick.setCalibrationStorage(&storage);
+        joystick.setClock(&clock);
+        joystick.begin();
+    }
+
+    void setStick(int level)
+    {
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            stick.level[axis] = level;
+        }
+    }
+
+    void setAxis(int axis, int level) { stick.level[axis] = level; }
+
+    // script(rig, state, ms in that state) positions the stick; stops on
+    // CAL_DONE or after maxMs
+    template <class Script>
+    CalibrationState run(Script script, uint32_t maxMs, bool forceFull = true)
+    {
+        joystick.startCalibration(forceFull);
+        CalibrationState state = joystick.getCalibrationState();
+        transitionCount = 0;
+        record(state, 0);
+
+        uint32_t stateStart = 0;
+        for (elapsedMs = 1; elapsedMs <= maxMs && state != CAL_DONE; elapsedMs++)
+        {
+            script(*this, state, elapsedMs - stateStart);
+            clock.advance(1000);
+            CalibrationState next = joystick.updateCalibration();
+            if (next != state)
+            {
+                record(next, elapsedMs);
+                stateStart = elapsedMs;
+                state = next;
+            }
+        }
+        return state;
+    }
+
+    void record(CalibrationState state, uint32_t atMs)
+    {
+        if (transitionCount < MAX_TRANSITIONS)
+        {
+            transitions[transitionCount].state = state;
+            transitions[transitionCount].atMs = atMs;
+            transitionCount++;
+        }
+    }
+
+    uint32_t enteredAt(CalibrationState state) const
+    {
+        for (int i = 0; i < transitionCount; i++)
+        {
+            if (transitions[i].state == state)
+                return transitions[i].atMs;
+        }
+        TEST_FAIL_MESSAGE("state never entered");
+        return 0;
+    }
+};
+
+// Triangle from SWEEP_LOW (t = 0) to SWEEP_HIGH (t = SWEEP_PERIOD / 2)
+static int sweep(uint32_t ms)
+{
+    int phase = (int)(ms % SWEEP_PERIOD);
+    int half = SWEEP_PERIOD / 2;
+    int rise = phase < half ? phase : SWEEP_PERIOD - phase;
+    return SWEEP_LOW + (SWEEP_HIGH - SWEEP_LOW) * rise / half;
+}
+
+// At rest with +-1 count of jitter until the range phase, then circles
+// for two seconds (Y a quarter turn behind X) and returns to rest
+static void restThenCircle(CalibrationRig &rig, CalibrationState state, uint32_t ms)
+{
+    if (state == CAL_RANGE && ms < 2000)
+    {
+        rig.setAxis(AXIS_X, sweep(ms));
+        rig.setAxis(AXIS_Y, sweep(ms + SWEEP_PERIOD / 4));
+        return;
+    }
+    rig.setStick(REST_CENTER + (int)(ms % 3) - 1);
+}
+
+static void assertSequence(const CalibrationRig &rig)
+{
+    const CalibrationState expected[] = {CAL_CENTER_SETTLE, CAL_CENTER, CAL_RANGE_SETTLE, CAL_RANGE, CAL_DONE};
+    TEST_ASSERT_EQUAL(5, rig.transitionCount);
+    for (int i = 0; i < 5; i++)
+    {
+        TEST_ASSERT_EQUAL(expected[i], rig.transitions[i].state);
+    }
+    TEST_ASSERT_EQUAL_UINT32(CENTER_SETTLE_TIME, rig.enteredAt(CAL_CENTER));
+    TEST_ASSERT_EQUAL_UINT32(rig.enteredAt(CAL_RANGE_SETTLE) + RANGE_SETTLE_TIME, rig.enteredAt(CAL_RANGE));
+}
+
+// The first center sample is taken on the tick after entering CAL_CENTER,
+// then one every CALIBRATION_DELAY
+static uint32_t centerSampleTime(const CalibrationRig &rig, int sample)
+{
+    return rig.enteredAt(CAL_CENTER) + 1 + (sample - 1) * CALIBRATION_DELAY;
+}
+
+// A quiet stick pins the mean down after CENTER_MIN_SAMPLES, well before
+// CALIBRATION_SAMPLES
+static void test_center_exits_early_on_convergence()
+{
+    CalibrationRig rig;
+    TEST_ASSERT_EQUAL(CAL_DONE, rig.run(restThenCircle, 20000));
+    assertSequence(rig);
+
+    CalibrationReport report;
+    rig.joystick.getCalibrationReport(report);
+    TEST_ASSERT_EQUAL(CENTER_MIN_SAMPLES, report.centerSamples);
+    TEST_ASSERT_EQUAL_UINT32(centerSampleTime(rig, CENTER_MIN_SAMPLES), rig.enteredAt(CAL_RANGE_SETTLE));
+    TEST_ASSERT_FALSE(report.defaultCenter);
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        TEST_ASSERT_INT_WITHIN(1, REST_CENTER, report.data.center[axis]);
+        TEST_ASSERT_LESS_OR_EQUAL(2, report.centerNoise[axis]);
+    }
+}
+
+// +-40 counts of alternating noise never converges: the phase runs to
+// CALIBRATION_SAMPLES and the center is still the mean
+static void test_noisy_center_runs_all_samples()
+{
+    CalibrationRig rig;
+    int sample = 0;
+    CalibrationState state = rig.run(
+        [&sample](CalibrationRig &r, CalibrationState s, uint32_t ms) {
+            if (s == CAL_CENTER && ms % CALIBRATION_DELAY == 0)
+            {
+                sample++;
+            }
+            restThenCircle(r, s, ms);
+            if (s == CAL_CENTER)
+            {
+                r.setStick(REST_CENTER + (sample % 2 == 0 ? 40 : -40));
+            }
+        },
+        20000);
+
+    TEST_ASSERT_EQUAL(CAL_DONE, state);
+    assertSequence(rig);
+    CalibrationReport report;
+    rig.joystick.getCalibrationReport(report);
+    TEST_ASSERT_EQUAL(CALIBRATION_SAMPLES, report.centerSamples);
+    TEST_ASSERT_EQUAL_UINT32(centerSampleTime(rig, CALIBRATION_SAMPLES), rig.enteredAt(CAL_RANGE_SETTLE));
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        TEST_ASSERT_EQUAL(REST_CENTER, report.data.center[axis]);
+        TEST_ASSERT_EQUAL(80, report.centerNoise[axis]);
+    }
+}
+
+// The last extreme (X back at its low, one period in: the first range
+// sample comes a tick after entering CAL_RANGE) is followed by
+// RANGE_STABLE_TIME without growth: done, and the record is stored
+static void test_range_exits_on_stable_extremes()
+{
+    CalibrationRig rig;
+    TEST_ASSERT_EQUAL(CAL_DONE, rig.run(restThenCircle, 20000));
+    assertSequence(rig);
+
+    uint32_t lastGrowth = SWEEP_PERIOD;
+    TEST_ASSERT_EQUAL_UINT32(rig.enteredAt(CAL_RANGE) + lastGrowth + RANGE_STABLE_TIME, rig.enteredAt(CAL_DONE));
+
+    CalibrationReport report;
+    rig.joystick.getCalibrationReport(report);
+    TEST_ASSERT_FALSE(report.timedOut);
+    TEST_ASSERT_TRUE(report.data.isCalibrated);
+    TEST_ASSERT_TRUE(rig.joystick.isCalibrated());
+    TEST_ASSERT_EQUAL_UINT32(rig.enteredAt(CAL_DONE), report.elapsedMs);
+    TEST_ASSERT_EQUAL(rig.enteredAt(CAL_DONE) - rig.enteredAt(CAL_RANGE), report.rangeSamples);
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        TEST_ASSERT_EQUAL(SWEEP_LOW, report.data.min[axis]);
+        TEST_ASSERT_EQUAL(SWEEP_HIGH, report.data.max[axis]);
+    }
+
+    TEST_ASSERT_TRUE(rig.joystick.saveCalibration(report));
+    StoredCalibration loaded;
+    TEST_ASSERT_EQUAL(RECORD_OK, loadCalibration(rig.storage, loaded));
+    TEST_ASSERT_EQUAL_UINT32(report.elapsedMs, loaded.calibrationMs);
+    TEST_ASSERT_EQUAL_INT_ARRAY(report.data.min, loaded.data.min, JOYSTICK_AXES);
+    TEST_ASSERT_EQUAL_INT_ARRAY(report.data.max, loaded.data.max, JOYSTICK_AXES);
+    TEST_ASSERT_EQUAL_INT_ARRAY(report.data.center, loaded.data.center, JOYSTICK_AXES);
+}
+
+// Stable extremes are not enough without 25% of full scale on every axis:
+// Y only wobbles, so the phase runs into RANGE_CALIBRATION_TIME and the
+// result is not stored
+static void test_range_times_out_without_coverage()
+{
+    CalibrationRig rig;
+    CalibrationState state = rig.run(
+        [](CalibrationRig &r, CalibrationState s, uint32_t ms) {
+            restThenCircle(r, s, ms);
+            if (s == CAL_RANGE)
+            {
+                r.setAxis(AXIS_Y, REST_CENTER + (ms < 2000 ? (int)(ms % 200) - 100 : 0));
+            }
+        },
+        20000);
+
+    TEST_ASSERT_EQUAL(CAL_DONE, state);
+    assertSequence(rig);
+    TEST_ASSERT_EQUAL_UINT32(rig.enteredAt(CAL_RANGE) + RANGE_CALIBRATION_TIME, rig.enteredAt(CAL_DONE));
+
+    CalibrationReport report;
+    rig.joystick.getCalibrationReport(report);
+    TEST_ASSERT_TRUE(report.timedOut);
+    TEST_ASSERT_EQUAL(SWEEP_LOW, report.data.min[AXIS_X]);
+    TEST_ASSERT_EQUAL(SWEEP_HIGH, report.data.max[AXIS_X]);
+    TEST_ASSERT_LESS_THAN(ADC_MAX_VALUE / 4, report.data.max[AXIS_Y] - report.data.min[AXIS_Y]);
+
+    TEST_ASSERT_FALSE(rig.joystick.saveCalibration(report));
+    StoredCalibration loaded;
+    TEST_ASSERT_EQUAL(RECORD_MISSING, loadCalibration(rig.storage, loaded));
+}
+
+// Extremes that keep creeping outwards by more than the growth threshold
+// never count as stable, so full coverage still ends on the timeout
+static void test_creeping_extremes_time_out()
+{
+    CalibrationRig rig;
+    CalibrationState state = rig.run(
+        [](CalibrationRig &r, CalibrationState s, uint32_t ms) {
+            restThenCircle(r, s, ms);
+            if (s == CAL_RANGE)
+            {
+                int creep = (int)(ms / 1000) * (RANGE_GROWTH_THRESHOLD + 2);
+                r.setAxis(AXIS_X, ms % 1000 < 500 ? SWEEP_LOW - creep : SWEEP_HIGH);
+                r.setAxis(AXIS_Y, ms % 1000 < 500 ? SWEEP_LOW : SWEEP_HIGH);
+            }
+        },
+        20000);
+
+    TEST_ASSERT_EQUAL(CAL_DONE, state);
+    TEST_ASSERT_EQUAL_UINT32(rig.enteredAt(CAL_RANGE) + RANGE_CALIBRATION_TIME, rig.enteredAt(CAL_DONE));
+
+    CalibrationReport report;
+    rig.joystick.getCalibrationReport(report);
+    TEST_ASSERT_TRUE(report.timedOut);
+    int lastCreep = RANGE_CALIBRATION_TIME / 1000 * (RANGE_GROWTH_THRESHOLD + 2);
+    TEST_ASSERT_EQUAL(SWEEP_LOW - lastCreep, report.data.min[AXIS_X]);
+    TEST_ASSERT_FALSE(rig.joystick.saveCalibration(report));
+}
+
+// A stored record is checked at rest and accepted: VERIFY -> DONE after
+// CENTER_CHECK_TIME, with the stored ranges
+static void test_warm_boot_uses_stored_record()
+{
+    CalibrationRig rig;
+    TEST_ASSERT_EQUAL(CAL_DONE, rig.run(restThenCircle, 20000));
+    CalibrationReport first;
+    rig.joystick.getCalibrationReport(first);
+    TEST_ASSERT_TRUE(rig.joystick.saveCalibration(first));
+
+    TEST_ASSERT_EQUAL(CAL_DONE, rig.run(restThenCircle, 20000, false));
+    TEST_ASSERT_EQUAL(2, rig.transitionCount);
+    TEST_ASSERT_EQUAL(CAL_VERIFY, rig.transitions[0].state);
+    TEST_ASSERT_EQUAL_UINT32(CENTER_CHECK_TIME, rig.enteredAt(CAL_DONE));
+
+    CalibrationReport report;
+    rig.joystick.getCalibrationReport(report);
+    TEST_ASSERT_TRUE(report.verified);
+    TEST_ASSERT_EQUAL(RECORD_OK, report.storedStatus);
+    TEST_ASSERT_EQUAL_UINT32(first.elapsedMs - CENTER_CHECK_TIME, report.bootTimeSavedMs);
+    TEST_ASSERT_EQUAL_INT_ARRAY(first.data.min, report.data.min, JOYSTICK_AXES);
+    TEST_ASSERT_EQUAL_INT_ARRAY(first.data.max, report.data.max, JOYSTICK_AXES);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_center_exits_early_on_convergence);
+    RUN_TEST(test_noisy_center_runs_all_samples);
+    RUN_TEST(test_range_exits_on_stable_extremes);
+    RUN_TEST(test_range_times_out_without_coverage);
+    RUN_TEST(test_creeping_extremes_time_out);
+    RUN_TEST(test_warm_boot_uses_stored_record);
+    return UNITY_END();
+}
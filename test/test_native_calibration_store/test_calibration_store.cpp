@@ -0,0 +1,289 @@
+// Calibration record encode/decode, rejection of damaged or foreign
+// records, refusing to store bad calibrations, and the warm-boot center
+// check on a simulated millisecond clock
+#include "calibration_store.h"
+#include "joystick.h"
+#include "crc.h"
+#include <unity.h>
+#include <string.h>
+
+static const int CAL_MIN = 200;
+static const int CAL_MAX = 3900;
+static const int REST_CENTER = 2010;
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static StoredCalibration makeStored()
+{
+    StoredCalibration stored;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        stored.data.min[axis] = CAL_MIN + axis;
+        stored.data.max[axis] = CAL_MAX - axis;
+        stored.data.center[axis] = REST_CENTER + 10 * axis;
+    }
+    stored.data.isCalibrated = true;
+    stored.calibrationMs = 4321;
+    return stored;
+}
+
+// Patches the CRC after editing a record, so a later check is reached
+static void resealRecord(uint8_t *record)
+{
+    uint32_t crc = crc32(record, CALIBRATION_RECORD_SIZE - 4);
+    for (int i = 0; i < 4; i++)
+    {
+        record[CALIBRATION_RECORD_SIZE - 4 + i] = (uint8_t)(crc >> (8 * i));
+    }
+}
+
+static void test_encode_decode_round_trip()
+{
+    StoredCalibration stored = makeStored();
+    uint8_t record[CALIBRATION_RECORD_SIZE];
+    TEST_ASSERT_EQUAL(CALIBRATION_RECORD_SIZE, encodeCalibrationRecord(stored, record));
+    TEST_ASSERT_EQUAL_UINT8(0x4A, record[0]); // "JC", little-endian
+    TEST_ASSERT_EQUAL_UINT8(0x43, record[1]);
+    TEST_ASSERT_EQUAL_UINT8(CALIBRATION_RECORD_VERSION, record[2]);
+    TEST_ASSERT_EQUAL_UINT8(JOYSTICK_AXES, record[3]);
+
+    StoredCalibration decoded;
+    memset(&decoded, 0, sizeof(decoded));
+    TEST_ASSERT_EQUAL(RECORD_OK, decodeCalibrationRecord(record, sizeof(record), decoded));
+    TEST_ASSERT_TRUE(decoded.data.isCalibrated);
+    TEST_ASSERT_EQUAL_UINT32(4321, decoded.calibrationMs);
+    TEST_ASSERT_EQUAL_INT_ARRAY(stored.data.min, decoded.data.min, JOYSTICK_AXES);
+    TEST_ASSERT_EQUAL_INT_ARRAY(stored.data.max, decoded.data.max, JOYSTICK_AXES);
+    TEST_ASSERT_EQUAL_INT_ARRAY(stored.data.center, decoded.data.center, JOYSTICK_AXES);
+}
+
+// Any single flipped bit, in the payload or in the CRC itself, is caught
+static void test_crc_detects_corruption()
+{
+    uint8_t record[CALIBRATION_RECORD_SIZE];
+    encodeCalibrationRecord(makeStored(), record);
+
+    StoredCalibration decoded;
+    for (size_t byte = CALIBRATION_RECORD_HEADER; byte < CALIBRATION_RECORD_SIZE; byte++)
+    {
+        for (int bit = 0; bit < 8; bit++)
+        {
+            record[byte] ^= (uint8_t)(1 << bit);
+            TEST_ASSERT_EQUAL(RECORD_BAD_CRC, decodeCalibrationRecord(record, sizeof(record), decoded));
+            record[byte] ^= (uint8_t)(1 << bit);
+        }
+    }
+    TEST_ASSERT_EQUAL(RECORD_OK, decodeCalibrationRecord(record, sizeof(record), decoded));
+}
+
+// Header problems are named as such, even with a valid CRC
+static void test_header_rejection()
+{
+    uint8_t record[CALIBRATION_RECORD_SIZE];
+    StoredCalibration decoded;
+
+    encodeCalibrationRecord(makeStored(), record);
+    record[2] = CALIBRATION_RECORD_VERSION - 1;
+    resealRecord(record);
+    TEST_ASSERT_EQUAL(RECORD_BAD_VERSION, decodeCalibrationRecord(record, sizeof(record), decoded));
+
+    encodeCalibrationRecord(makeStored(), record);
+    record[3] = JOYSTICK_AXES + 1;
+    resealRecord(record);
+    TEST_ASSERT_EQUAL(RECORD_BAD_AXES, decodeCalibrationRecord(record, sizeof(record), decoded));
+
+    encodeCalibrationRecord(makeStored(), record);
+    record[0] ^= 0xFF;
+    TEST_ASSERT_EQUAL(RECORD_BAD_MAGIC, decodeCalibrationRecord(record, sizeof(record), decoded));
+}
+
+// A record from a build with fewer axes is reported by its axis count,
+// not by its (also wrong) size
+static void test_other_axis_count_rejected_before_size()
+{
+    uint8_t record[CALIBRATION_RECORD_SIZE];
+    StoredCalibration decoded;
+
+    encodeCalibrationRecord(makeStored(), record);
+    record[3] = JOYSTICK_AXES - 1;
+    TEST_ASSERT_EQUAL(RECORD_BAD_AXES, decodeCalibrationRecord(record, CALIBRATION_RECORD_SIZE - 6, decoded));
+    TEST_ASSERT_EQUAL_STRING("axis count mismatch", calibrationRecordStatusName(RECORD_BAD_AXES));
+}
+
+static void test_size_rejection()
+{
+    uint8_t record[CALIBRATION_RECORD_SIZE + 1];
+    StoredCalibration decoded;
+    encodeCalibrationRecord(makeStored(), record);
+
+    TEST_ASSERT_EQUAL(RECORD_MISSING, decodeCalibrationRecord(record, 0, decoded));
+    TEST_ASSERT_EQUAL(RECORD_BAD_SIZE, decodeCalibrationRecord(record, 3, decoded));
+    TEST_ASSERT_EQUAL(RECORD_BAD_SIZE, decodeCalibrationRecord(record, CALIBRATION_RECORD_SIZE - 1, decoded));
+    TEST_ASSERT_EQUAL(RECORD_BAD_SIZE, decodeCalibrationRecord(record, CALIBRATION_RECORD_SIZE + 1, decoded));
+}
+
+static void test_bad_values_rejected()
+{
+    uint8_t record[CALIBRATION_RECORD_SIZE];
+    StoredCalibration stored = makeStored();
+    StoredCalibration decoded;
+
+    // Zero range on one axis: min == center == max
+    stored.data.min[AXIS_Y] = REST_CENTER;
+    stored.data.max[AXIS_Y] = REST_CENTER;
+    stored.data.center[AXIS_Y] = REST_CENTER;
+    TEST_ASSERT_FALSE(calibrationDataValid(stored.data));
+    encodeCalibrationRecord(stored, record);
+    TEST_ASSERT_EQUAL(RECORD_BAD_VALUES, decodeCalibrationRecord(record, sizeof(record), decoded));
+
+    stored = makeStored();
+    stored.data.max[AXIS_X] = ADC_MAX_VALUE + 1;
+    TEST_ASSERT_FALSE(calibrationDataValid(stored.data));
+
+    stored = makeStored();
+    stored.data.center[AXIS_X] = CAL_MIN - 1;
+    TEST_ASSERT_FALSE(calibrationDataValid(stored.data));
+
+    TEST_ASSERT_TRUE(calibrationDataValid(makeStored().data));
+}
+
+// Storing a record that can never load would fail every boot
+static void test_save_refuses_invalid_data()
+{
+    MemoryCalibrationStorage storage;
+    StoredCalibration stored = makeStored();
+    stored.data.max[AXIS_X] = stored.data.center[AXIS_X];
+
+    TEST_ASSERT_FALSE(saveCalibration(storage, stored));
+    StoredCalibration loaded;
+    TEST_ASSERT_EQUAL(RECORD_MISSING, loadCalibration(storage, loaded));
+
+    TEST_ASSERT_TRUE(saveCalibration(storage, makeStored()));
+    TEST_ASSERT_EQUAL(RECORD_OK, loadCalibration(storage, loaded));
+    TEST_ASSERT_EQUAL_UINT32(4321, loaded.calibrationMs);
+}
+
+static void test_controller_refuses_timed_out_calibration()
+{
+    MemoryCalibrationStorage storage;
+    JoystickController joystick;
+    joystick.setCalibrationStorage(&storage);
+
+    CalibrationReport report = {};
+    report.data = makeStored().data;
+    report.elapsedMs = 3000;
+    report.timedOut = true;
+    TEST_ASSERT_FALSE(joystick.saveCalibration(report));
+
+    report.timedOut = false;
+    report.data.isCalibrated = false;
+    TEST_ASSERT_FALSE(joystick.saveCalibration(report));
+
+    StoredCalibration loaded;
+    TEST_ASSERT_EQUAL(RECORD_MISSING, loadCalibration(storage, loaded));
+
+    report.data.isCalibrated = true;
+    TEST_ASSERT_TRUE(joystick.saveCalibration(report));
+    TEST_ASSERT_EQUAL(RECORD_OK, loadCalibration(storage, loaded));
+    TEST_ASSERT_EQUAL_UINT32(3000, loaded.calibrationMs);
+}
+
+// Runs the center check at one sample per ms; raw(axis, ms) gives samples
+template <class Sampler>
+static CalibrationState runVerify(CalibrationStateMachine &calibrator, const CalibrationData &stored, Sampler raw)
+{
+    const uint32_t start = 50000;
+    calibrator.startVerify(start, stored);
+    CalibrationState state = calibrator.getState();
+    for (uint32_t ms = 0; ms <= (uint32_t)CENTER_CHECK_TIME && state == CAL_VERIFY; ms++)
+    {
+        int sample[JOYSTICK_AXES];
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            sample[axis] = raw(axis, ms);
+        }
+        state = calibrator.tick(start + ms, sample);
+    }
+    return state;
+}
+
+// Stored record -> load -> center check accepts it after CENTER_CHECK_TIME
+static void test_verify_accepts_stored_center()
+{
+    MemoryCalibrationStorage storage;
+    saveCalibration(storage, makeStored());
+    StoredCalibration loaded;
+    TEST_ASSERT_EQUAL(RECORD_OK, loadCalibration(storage, loaded));
+
+    CalibrationStateMachine calibrator;
+    CalibrationState state = runVerify(calibrator, loaded.data, [](int axis, uint32_t ms) {
+        return REST_CENTER + 10 * axis + (int)(ms % 7) - 3 + CENTER_CHECK_TOLERANCE / 2;
+    });
+
+    TEST_ASSERT_EQUAL(CAL_DONE, state);
+    TEST_ASSERT_TRUE(calibrator.wasVerified());
+    TEST_ASSERT_FALSE(calibrator.verificationFailed());
+    TEST_ASSERT_EQUAL_UINT32(CENTER_CHECK_TIME, calibrator.getElapsed());
+    TEST_ASSERT_TRUE(calibrator.getResult().isCalibrated);
+    TEST_ASSERT_EQUAL_INT_ARRAY(loaded.data.center, calibrator.getResult().center, JOYSTICK_AXES);
+}
+
+static void test_verify_rejects_moved_center()
+{
+    CalibrationStateMachine calibrator;
+    CalibrationState state = runVerify(calibrator, makeStored().data, [](int axis, uint32_t) {
+        return REST_CENTER + 10 * axis + (axis == AXIS_Y ? CENTER_CHECK_TOLERANCE + 5 : 0);
+    });
+
+    TEST_ASSERT_EQUAL(CAL_CENTER_SETTLE, state);
+    TEST_ASSERT_TRUE(calibrator.verificationFailed());
+    TEST_ASSERT_FALSE(calibrator.wasVerified());
+    TEST_ASSERT_FALSE(calibrator.getResult().isCalibrated);
+}
+
+// A stick being moved during the check averages near center but is noisy
+static void test_verify_rejects_moving_stick()
+{
+    CalibrationStateMachine calibrator;
+    CalibrationState state = runVerify(calibrator, makeStored().data, [](int axis, uint32_t ms) {
+        int swing = (ms % 2 == 0) ? CENTER_CHECK_MAX_NOISE : -CENTER_CHECK_MAX_NOISE;
+        return REST_CENTER + 10 * axis + (axis == AXIS_X ? swing : 0);
+    });
+
+    TEST_ASSERT_EQUAL(CAL_CENTER_SETTLE, state);
+    TEST_ASSERT_TRUE(calibrator.verificationFailed());
+}
+
+static void test_verify_rejects_missing_frames()
+{
+    CalibrationStateMachine calibrator;
+    CalibrationState state = runVerify(calibrator, makeStored().data, [](int, uint32_t) { return -1; });
+
+    TEST_ASSERT_EQUAL(CAL_CENTER_SETTLE, state);
+    TEST_ASSERT_TRUE(calibrator.verificationFailed());
+    TEST_ASSERT_EQUAL(0, calibrator.getCenterSamples());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_encode_decode_round_trip);
+    RUN_TEST(test_crc_detects_corruption);
+    RUN_TEST(test_header_rejection);
+    RUN_TEST(test_other_axis_count_rejected_before_size);
+    RUN_TEST(test_size_rejection);
+    RUN_TEST(test_bad_values_rejected);
+    RUN_TEST(test_save_refuses_invalid_data);
+    RUN_TEST(test_controller_refuses_timed_out_calibration);
+    RUN_TEST(test_verify_accepts_stored_center);
+    RUN_TEST(test_verify_rejects_moved_center);
+    RUN_TEST(test_verify_rejects_moving_stick);
+    RUN_TEST(test_verify_rejects_missing_frames);
+    return UNITY_END();
+}
@@ -0,0 +1,297 @@
+// DriftCompensator on a simulated millisecond clock: range widening needs
+// a persistent reading, centers follow only after a rest period and stay
+// bounded, and a two-hour drifting-stick run keeps the rest output at zero
+#include "drift_compensator.h"
+#include <unity.h>
+#include <stdint.h>
+#include <stdio.h>
+
+static const int CAL_MIN = 300;
+static const int CAL_MAX = 3800;
+static const int REST_CENTER = 2050;
+static const unsigned long TICK_MS = 2; // 500 Hz
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static CalibrationData makeCalibration()
+{
+    CalibrationData data;
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        data.min[axis] = CAL_MIN;
+        data.max[axis] = CAL_MAX;
+        data.center[axis] = REST_CENTER;
+    }
+    data.isCalibrated = true;
+    return data;
+}
+
+// Same reading on every axis
+static bool step(DriftCompensator &drift, unsigned long &now, int value, bool atRest, CalibrationData &calibration)
+{
+    int raw[JOYSTICK_AXES];
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        raw[axis] = value;
+    }
+    now += TICK_MS;
+    return drift.update(now, raw, atRest, calibration);
+}
+
+static void test_inactive_until_calibrated()
+{
+    DriftCompensator drift;
+    CalibrationData calibration = makeCalibration();
+    unsigned long now = 0;
+    for (int i = 0; i < 100; i++)
+    {
+        TEST_ASSERT_FALSE(step(drift, now, 4000, false, calibration));
+    }
+
+    CalibrationData uncalibrated = makeCalibration();
+    uncalibrated.isCalibrated = false;
+    drift.begin(uncalibrated);
+    for (int i = 0; i < 100; i++)
+    {
+        TEST_ASSERT_FALSE(step(drift, now, 4000, false, calibration));
+    }
+    TEST_ASSERT_EQUAL(CAL_MAX, calibration.max[AXIS_X]);
+    TEST_ASSERT_EQUAL(0, drift.getWidenings());
+}
+
+// Spikes and short excursions never move the extremes
+static void test_single_reading_does_not_widen()
+{
+    DriftCompensator drift;
+    CalibrationData calibration = makeCalibration();
+    drift.begin(calibration);
+    unsigned long now = 1000;
+
+    step(drift, now, 4095, false, calibration);
+    step(drift, now, 0, false, calibration);
+    for (int i = 0; i < DRIFT_WIDEN_SAMPLES - 1; i++)
+    {
+        step(drift, now, CAL_MAX + 50, false, calibration);
+    }
+    step(drift, now, CAL_MAX, false, calibration); // Back inside: streak over
+    for (int i = 0; i < DRIFT_WIDEN_SAMPLES - 1; i++)
+    {
+        step(drift, now, CAL_MAX + 50, false, calibration);
+    }
+
+    TEST_ASSERT_EQUAL(CAL_MAX, calibration.max[AXIS_X]);
+    TEST_ASSERT_EQUAL(CAL_MIN, calibration.min[AXIS_X]);
+    TEST_ASSERT_EQUAL(0, drift.getWidenings());
+}
+
+// A reading held past the extreme widens the range to the mildest value
+// of the streak, so a spike inside the streak does not over-widen it
+static void test_persistent_reading_widens()
+{
+    DriftCompensator drift;
+    CalibrationData calibration = makeCalibration();
+    drift.begin(calibration);
+    unsigned long now = 1000;
+
+    bool rebuild = false;
+    for (int i = 0; i < DRIFT_WIDEN_SAMPLES; i++)
+    {
+        int value = (i == 3) ? ADC_MAX_VALUE : CAL_MAX + 40 + (i % 5);
+        TEST_ASSERT_EQUAL(CAL_MAX, calibration.max[AXIS_X]);
+        rebuild = step(drift, now, value, false, calibration);
+    }
+    TEST_ASSERT_TRUE(rebuild);
+    TEST_ASSERT_EQUAL(CAL_MAX + 40, calibration.max[AXIS_X]);
+    TEST_ASSERT_EQUAL(CAL_MAX + 40, calibration.max[AXIS_Y]);
+    TEST_ASSERT_EQUAL(JOYSTICK_AXES, drift.getWidenings());
+
+    for (int i = 0; i < DRIFT_WIDEN_SAMPLES; i++)
+    {
+        step(drift, now, CAL_MIN - 20, false, calibration);
+    }
+    TEST_ASSERT_EQUAL(CAL_MIN - 20, calibration.min[AXIS_Y]);
+    TEST_ASSERT_EQUAL(2 * JOYSTICK_AXES, drift.getWidenings());
+}
+
+// Alternating sides never builds a streak
+static void test_switching_sides_restarts()
+{
+    DriftCompensator drift;
+    CalibrationData calibration = makeCalibration();
+    drift.begin(calibration);
+    unsigned long now = 1000;
+
+    for (int i = 0; i < 10 * DRIFT_WIDEN_SAMPLES; i++)
+    {
+        step(drift, now, (i & 1) ? CAL_MAX + 100 : CAL_MIN - 100, false, calibration);
+    }
+    TEST_ASSERT_EQUAL(0, drift.getWidenings());
+}
+
+// Centers wait for DRIFT_REST_TIME of continuous rest, then follow slowly
+// and stop at DRIFT_MAX_CORRECTION
+static void test_center_follows_after_rest()
+{
+    DriftCompensator drift;
+    CalibrationData calibration = makeCalibration();
+    drift.begin(calibration);
+    unsigned long now = 1000;
+    const int shifted = REST_CENTER + 60;
+
+    for (unsigned long t = 0; t < (unsigned long)DRIFT_REST_TIME; t += TICK_MS)
+    {
+        step(drift, now, shifted, true, calibration);
+    }
+    TEST_ASSERT_EQUAL(0, drift.getDrift(AXIS_X));
+
+    // A touch restarts the rest timer
+    step(drift, now, REST_CENTER + 500, false, calibration);
+    for (unsigned long t = 0; t < (unsigned long)DRIFT_REST_TIME - 10; t += TICK_MS)
+    {
+        step(drift, now, shifted, true, calibration);
+    }
+    TEST_ASSERT_EQUAL(0, drift.getDrift(AXIS_X));
+
+    // ~16 s time constant: after a minute the center sits at the reading
+    for (int i = 0; i < 60 * 500; i++)
+    {
+        step(drift, now, shifted, true, calibration);
+    }
+    TEST_ASSERT_INT_WITHIN(2, 60, drift.getDrift(AXIS_X));
+    TEST_ASSERT_INT_WITHIN(2, shifted, calibration.center[AXIS_Y]);
+
+    for (int i = 0; i < 300 * 500; i++)
+    {
+        step(drift, now, REST_CENTER + 400, true, calibration);
+    }
+    TEST_ASSERT_EQUAL(DRIFT_MAX_CORRECTION, drift.getDrift(AXIS_X));
+    TEST_ASSERT_EQUAL(REST_CENTER + DRIFT_MAX_CORRECTION, calibration.center[AXIS_X]);
+}
+
+// Rebuild requests are spaced by DRIFT_REBUILD_INTERVAL
+static void test_rebuild_rate_limited()
+{
+    DriftCompensator drift;
+    CalibrationData calibration = makeCalibration();
+    drift.begin(calibration);
+    unsigned long now = 1000;
+
+    unsigned long lastRebuild = 0;
+    int rebuilds = 0;
+    for (int i = 0; i < 5000; i++)
+    {
+        // Steady outward creep: a new widening every DRIFT_WIDEN_SAMPLES
+        if (step(drift, now, CAL_MAX + 1 + i / DRIFT_WIDEN_SAMPLES, false, calibration))
+        {
+            if (rebuilds > 0)
+                TEST_ASSERT_GREATER_OR_EQUAL(DRIFT_REBUILD_INTERVAL, (long)(now - lastRebuild));
+            lastRebuild = now;
+            rebuilds++;
+        }
+    }
+    TEST_ASSERT_GREATER_THAN(10, rebuilds);
+}
+
+// Output the mapping would give: signed distance from center, scaled to
+// +/-MAX_OUTPUT by the half range on that side
+static int mapped(int raw, const CalibrationData &calibration, int axis)
+{
+    int center = calibration.center[axis];
+    int span = raw >= center ? calibration.max[axis] - center : center - calibration.min[axis];
+    return (raw - center) * MAX_OUTPUT / span;
+}
+
+// Two hours at 500 Hz: both rest positions drift 145 counts in opposite
+// directions under 8-count noise, with switching spikes that get past the
+// glitch filter as 3-sample bursts, and a full push every ten minutes.
+// A fixed center leaks the drift into the output; the tracked one does not.
+static void test_two_hour_drift_simulation()
+{
+    DriftCompensator drift;
+    CalibrationData tracked = makeCalibration();
+    const CalibrationData fixed = makeCalibration();
+    drift.begin(tracked);
+
+    const long ticks = 2L * 3600 * 500;
+    const int driftCounts = 145;
+    const int deadZone = DEAD_ZONE_PERCENT;
+    long leakedFixed = 0;
+    long leakedTracked = 0;
+    long rebuilds = 0;
+    uint32_t seed = 1;
+    unsigned long now = 0;
+
+    for (long tick = 0; tick < ticks; tick++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        int noise = (int)(seed >> 28) - 8;
+        int offset = (int)(driftCounts * tick / ticks);
+        int rest[JOYSTICK_AXES] = {REST_CENTER + offset + noise, REST_CENTER - offset - noise};
+
+        int raw[JOYSTICK_AXES];
+        bool pushing = tick % (600 * 500) >= 300 * 500 && tick % (600 * 500) < 300 * 500 + 500;
+        bool spike = tick % 1709 < 3;
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            raw[axis] = pushing ? CAL_MAX + 30 + noise : (spike ? ADC_MAX_VALUE : rest[axis]);
+        }
+
+        // At rest as the pipeline decides it, from the current calibration
+        bool atRest = true;
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            int value = mapped(raw[axis], tracked, axis);
+            atRest = atRest && value > -deadZone && value < deadZone;
+        }
+
+        now += TICK_MS;
+        if (drift.update(now, raw, atRest, tracked))
+            rebuilds++;
+
+        if (pushing || spike)
+            continue;
+        for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+        {
+            int fixedValue = mapped(raw[axis], fixed, axis);
+            int trackedValue = mapped(raw[axis], tracked, axis);
+            leakedFixed += (fixedValue <= -deadZone || fixedValue >= deadZone) ? 1 : 0;
+            leakedTracked += (trackedValue <= -deadZone || trackedValue >= deadZone) ? 1 : 0;
+        }
+    }
+
+    printf("2 h drift: %ld rest outputs past the dead zone with a fixed center, %ld tracked "
+           "(%ld rebuilds, %lu widenings, drift %d/%d)\n",
+           leakedFixed, leakedTracked, rebuilds, drift.getWidenings(), drift.getDrift(AXIS_X), drift.getDrift(AXIS_Y));
+
+    TEST_ASSERT_GREATER_THAN(0, leakedFixed);
+    TEST_ASSERT_EQUAL(0, leakedTracked);
+    TEST_ASSERT_INT_WITHIN(10, driftCounts, drift.getDrift(AXIS_X));
+    TEST_ASSERT_INT_WITHIN(10, -driftCounts, drift.getDrift(AXIS_Y));
+
+    // The pushes widened max to their level; spikes to the rail never did
+    for (int axis = 0; axis < JOYSTICK_AXES; axis++)
+    {
+        TEST_ASSERT_GREATER_OR_EQUAL(CAL_MAX + 30 - 8, tracked.max[axis]);
+        TEST_ASSERT_LESS_OR_EQUAL(CAL_MAX + 30 + 8, tracked.max[axis]);
+        TEST_ASSERT_EQUAL(CAL_MIN, tracked.min[axis]);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_inactive_until_calibrated);
+    RUN_TEST(test_single_reading_does_not_widen);
+    RUN_TEST(test_persistent_reading_widens);
+    RUN_TEST(test_switching_sides_restarts);
+    RUN_TEST(test_center_follows_after_rest);
+    RUN_TEST(test_rebuild_rate_limited);
+    RUN_TEST(test_two_hour_drift_simulation);
+    return UNITY_END();
+}
@@ -0,0 +1,148 @@
+// GlitchFilter: the running median matches a sorted reference, single
+// spikes vanish, and median outliers and step-limited samples are counted
+// apart
+#include "glitch_filter.h"
+#include <unity.h>
+#include <algorithm>
+#include <stdint.h>
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// Median of the last Taps inputs by sorting, primed like the filter
+template <int Taps>
+static void checkMedianAgainstSort(uint32_t seed)
+{
+    GlitchFilter<Taps> filter(1 << 30, 1 << 30); // No step limit
+    int history[Taps];
+    uint32_t state = seed;
+    for (int i = 0; i < 5000; i++)
+    {
+        state = state * 1664525u + 1013904223u;
+        int sample = (int)(state >> 20); // 0..4095, with repeats
+        int output = filter.update(sample);
+
+        if (i == 0)
+        {
+            std::fill(history, history + Taps, sample);
+        }
+        else
+        {
+            std::copy(history + 1, history + Taps, history);
+            history[Taps - 1] = sample;
+        }
+        int sorted[Taps];
+        std::copy(history, history + Taps, sorted);
+        std::sort(sorted, sorted + Taps);
+        TEST_ASSERT_EQUAL(sorted[Taps / 2], output);
+    }
+    TEST_ASSERT_EQUAL(0, filter.getClipped());
+}
+
+static void test_median_matches_sort()
+{
+    checkMedianAgainstSort<3>(1);
+    checkMedianAgainstSort<5>(2);
+    checkMedianAgainstSort<7>(3);
+}
+
+// One bad sample never reaches the output
+static void test_single_spike_removed()
+{
+    GlitchFilter<3> filter;
+    filter.update(2000);
+    filter.update(2000);
+    TEST_ASSERT_EQUAL(2000, filter.update(4095));
+    TEST_ASSERT_EQUAL(2000, filter.update(2000));
+    TEST_ASSERT_EQUAL(2000, filter.update(0));
+    TEST_ASSERT_EQUAL(2000, filter.update(2000));
+
+    TEST_ASSERT_EQUAL(2, filter.getRejected());
+    TEST_ASSERT_EQUAL(0, filter.getClipped());
+}
+
+// A two-sample spike beats a 3-tap median; the step limit keeps its
+// excursion to maxStep per sample, and those samples count as clipped
+static void test_long_spike_clipped()
+{
+    GlitchFilter<3> filter(400, 150);
+    filter.update(2000);
+    filter.update(2000);
+    TEST_ASSERT_EQUAL(2000, filter.update(4000)); // Median hides it: rejected
+    TEST_ASSERT_EQUAL(2400, filter.update(4000)); // Median follows: clipped
+    TEST_ASSERT_EQUAL(2800, filter.update(2000)); // Back, but the median is still high: rejected, clipped
+    TEST_ASSERT_EQUAL(2400, filter.update(2000)); // Clipped on the way down
+    TEST_ASSERT_EQUAL(2000, filter.update(2000));
+
+    TEST_ASSERT_EQUAL(2, filter.getRejected());
+    TEST_ASSERT_EQUAL(3, filter.getClipped());
+}
+
+// A genuine full-throw move is slowed to maxStep per sample. Each held-back
+// sample is clipped; only the first, which the median still hid, is rejected
+static void test_fast_move_is_clipped_not_rejected()
+{
+    GlitchFilter<3> filter(400, 150);
+    filter.update(0);
+    filter.update(0);
+
+    int output = filter.update(4000);
+    TEST_ASSERT_EQUAL(0, output);
+    int steps = 0;
+    while (output < 4000)
+    {
+        int next = filter.update(4000);
+        TEST_ASSERT_LESS_OR_EQUAL(400, next - output);
+        output = next;
+        steps++;
+    }
+    TEST_ASSERT_EQUAL(10, steps);
+    TEST_ASSERT_EQUAL(1, filter.getRejected());
+    TEST_ASSERT_EQUAL(9, filter.getClipped()); // The tenth step is exactly maxStep
+}
+
+// Noise within the threshold and slow ramps pass without counts
+static void test_clean_signal_not_counted()
+{
+    GlitchFilter<5> filter;
+    for (int i = 0; i < 2000; i++)
+    {
+        int noise = ((i * 37) % 61) - 30;
+        filter.update(1000 + i + noise);
+    }
+    TEST_ASSERT_EQUAL(0, filter.getRejected());
+    TEST_ASSERT_EQUAL(0, filter.getClipped());
+}
+
+// reset() re-primes on the next sample but keeps the counters
+static void test_reset_keeps_counters()
+{
+    GlitchFilter<3> filter;
+    filter.update(100);
+    filter.update(100);
+    filter.update(3000);
+    TEST_ASSERT_EQUAL(1, filter.getRejected());
+
+    filter.reset();
+    TEST_ASSERT_EQUAL(3500, filter.update(3500)); // No step limit from the old value
+    TEST_ASSERT_EQUAL(3500, filter.update(3500));
+    TEST_ASSERT_EQUAL(1, filter.getRejected());
+    TEST_ASSERT_EQUAL(0, filter.getClipped());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_median_matches_sort);
+    RUN_TEST(test_single_spike_removed);
+    RUN_TEST(test_long_spike_clipped);
+    RUN_TEST(test_fast_move_is_clipped_not_rejected);
+    RUN_TEST(test_clean_signal_not_counted);
+    RUN_TEST(test_reset_keeps_counters);
+    return UNITY_END();
+}
@@ -0,0 +1,144 @@
+// HD44780 over PCF8574: the encoded byte stream against hand-worked golden
+// bytes (P0=RS P2=EN P3=backlight P4-P7=D4-D7), and bursts split at
+// HD44780_MAX_BURST as seen by the Wire stand-in
+#include "hd44780.h"
+#include <unity.h>
+#include <string.h>
+
+// One 'A' (0x41) as data with the backlight on: RS|BL = 0x09
+static const uint8_t GOLDEN_A[4] = {0x4D, 0x49, 0x1D, 0x19};
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static void test_encode_command()
+{
+    // Set DDRAM address 0x40 (row 1), backlight on
+    const uint8_t command = 0xC0;
+    const uint8_t golden[] = {0xCC, 0xC8, 0x0C, 0x08};
+    uint8_t out[8];
+    memset(out, 0xEE, sizeof(out));
+
+    TEST_ASSERT_EQUAL(4, hd44780Encode(&command, 1, false, PCF8574_BACKLIGHT, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(golden, out, sizeof(golden));
+    TEST_ASSERT_EQUAL_UINT8(0xEE, out[4]); // Nothing past the reported length
+}
+
+static void test_encode_data_run()
+{
+    const uint8_t text[] = {'H', 'i', 'A'};
+    const uint8_t lit[] = {0x4D, 0x49, 0x8D, 0x89, 0x6D, 0x69, 0x9D, 0x99, 0x4D, 0x49, 0x1D, 0x19};
+    const uint8_t dark[] = {0x45, 0x41, 0x85, 0x81, 0x65, 0x61, 0x95, 0x91, 0x45, 0x41, 0x15, 0x11};
+    uint8_t out[12];
+
+    TEST_ASSERT_EQUAL(12, hd44780Encode(text, 3, true, PCF8574_BACKLIGHT, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(lit, out, sizeof(lit));
+
+    TEST_ASSERT_EQUAL(12, hd44780Encode(text, 3, true, 0, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(dark, out, sizeof(dark));
+}
+
+// The encoder never writes a partial sequence into a short buffer
+static void test_encode_refuses_short_buffer()
+{
+    uint8_t text[HD44780_MAX_BURST / HD44780_WIRE_BYTES_PER_BYTE + 1];
+    memset(text, 'A', sizeof(text));
+    uint8_t out[HD44780_MAX_BURST];
+
+    TEST_ASSERT_EQUAL(0, hd44780Encode(text, sizeof(text), true, PCF8574_BACKLIGHT, out, sizeof(out)));
+    TEST_ASSERT_EQUAL(HD44780_MAX_BURST,
+                      hd44780Encode(text, sizeof(text) - 1, true, PCF8574_BACKLIGHT, out, sizeof(out)));
+    TEST_ASSERT_EQUAL(0, hd44780Encode(text, 1, true, PCF8574_BACKLIGHT, out, 3));
+}
+
+// Cursor move and characters leave as one transaction
+static void test_write_at_single_burst()
+{
+    TwoWire wire;
+    HD44780Driver lcd(0x27, 16, 2, wire);
+    const uint8_t golden[] = {0xCC, 0xC8, 0x0C, 0x08, 0x4D, 0x49, 0x8D, 0x89, 0x6D, 0x69, 0x9D, 0x99};
+
+    lcd.writeAt(0, 1, "Hi", 2);
+    TEST_ASSERT_EQUAL(1, wire.getTransactions());
+    TEST_ASSERT_EQUAL(sizeof(golden), wire.getLastLength());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(golden, wire.getLastTransmission(), sizeof(golden));
+    TEST_ASSERT_EQUAL(1, lcd.getTransactions());
+    TEST_ASSERT_EQUAL(sizeof(golden), lcd.getWireBytes());
+}
+
+// Exactly HD44780_MAX_BURST bytes fit one transaction; one more byte
+// spills into a second
+static void test_burst_split_at_max()
+{
+    const size_t perBurst = HD44780_MAX_BURST / HD44780_WIRE_BYTES_PER_BYTE;
+    uint8_t text[perBurst + 1];
+    memset(text, 'A', sizeof(text));
+
+    TwoWire wire;
+    HD44780Driver lcd(0x27, 40, 2, wire);
+
+    lcd.write(text, perBurst);
+    TEST_ASSERT_EQUAL(1, wire.getTransactions());
+    TEST_ASSERT_EQUAL(HD44780_MAX_BURST, wire.getLastLength());
+    for (size_t i = 0; i < perBurst; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(GOLDEN_A, wire.getLastTransmission() + 4 * i, 4);
+    }
+
+    lcd.write(text, perBurst + 1);
+    TEST_ASSERT_EQUAL(3, wire.getTransactions());
+    TEST_ASSERT_EQUAL(4, wire.getLastLength());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(GOLDEN_A, wire.getLastTransmission(), 4);
+    TEST_ASSERT_EQUAL((2 * perBurst + 1) * 4, wire.getBytes());
+}
+
+// The cursor command takes one slot of the first burst
+static void test_write_at_split_with_command()
+{
+    const size_t perBurst = HD44780_MAX_BURST / HD44780_WIRE_BYTES_PER_BYTE;
+    char text[perBurst];
+    memset(text, 'A', sizeof(text));
+
+    TwoWire wire;
+    HD44780Driver lcd(0x27, 40, 2, wire);
+
+    lcd.writeAt(0, 0, text, perBurst - 1);
+    TEST_ASSERT_EQUAL(1, wire.getTransactions());
+    TEST_ASSERT_EQUAL(HD44780_MAX_BURST, wire.getLastLength());
+
+    lcd.writeAt(0, 0, text, perBurst);
+    TEST_ASSERT_EQUAL(3, wire.getTransactions());
+    TEST_ASSERT_EQUAL(4, wire.getLastLength());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(GOLDEN_A, wire.getLastTransmission(), 4);
+}
+
+// Text past the last column is dropped, not wrapped
+static void test_write_at_clips_to_row()
+{
+    TwoWire wire;
+    HD44780Driver lcd(0x27, 16, 2, wire);
+
+    lcd.writeAt(14, 0, "ABCD", 4);
+    TEST_ASSERT_EQUAL((1 + 2) * 4, wire.getLastLength());
+
+    lcd.writeAt(16, 0, "A", 1);
+    TEST_ASSERT_EQUAL(1, wire.getTransactions());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_encode_command);
+    RUN_TEST(test_encode_data_run);
+    RUN_TEST(test_encode_refuses_short_buffer);
+    RUN_TEST(test_write_at_single_burst);
+    RUN_TEST(test_burst_split_at_max);
+    RUN_TEST(test_write_at_split_with_command);
+    RUN_TEST(test_write_at_clips_to_row);
+    return UNITY_END();
+}
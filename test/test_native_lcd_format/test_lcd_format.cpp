@@ -0,0 +1,127 @@
+// Heap-free LCD line formatting: padding, truncation at LCD_COLS, and
+// negative numbers down to INT_MIN
+#include "lcd_format.h"
+#include <unity.h>
+#include <limits.h>
+#include <string.h>
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static JoystickPosition position(int x, int y)
+{
+    JoystickPosition joy = {};
+    joy.axis[AXIS_X] = x;
+    joy.axis[AXIS_Y] = y;
+    return joy;
+}
+
+static SimpleMotorCommand command(MotorDirection direction, int percent)
+{
+    SimpleMotorCommand cmd = {};
+    cmd.direction = direction;
+    cmd.speedPercent = percent;
+    return cmd;
+}
+
+// Pre-filled with junk, so any unwritten cell or missing terminator shows
+static void fillJunk(LcdLine line)
+{
+    memset(line, '#', sizeof(LcdLine));
+}
+
+static void test_joystick_line_padded()
+{
+    LcdLine line;
+    fillJunk(line);
+    formatJoystickLine(line, position(12, -340), command(MOTOR_BACKWARD, 67));
+    TEST_ASSERT_EQUAL_STRING("12,-340 67%     ", line);
+    TEST_ASSERT_EQUAL(LCD_COLS, (int)strlen(line));
+}
+
+static void test_zero_values()
+{
+    LcdLine line;
+    fillJunk(line);
+    formatJoystickLine(line, position(0, 0), command(MOTOR_STOP, 0));
+    TEST_ASSERT_EQUAL_STRING("0,0 0%          ", line);
+}
+
+// Content longer than the display is cut at LCD_COLS, not wrapped
+static void test_joystick_line_truncated()
+{
+    LcdLine line;
+    fillJunk(line);
+    formatJoystickLine(line, position(-1000000, 2000000), command(MOTOR_FORWARD, 100));
+    TEST_ASSERT_EQUAL_STRING("-1000000,2000000", line);
+
+    fillJunk(line);
+    formatJoystickLine(line, position(-1000000, -200000), command(MOTOR_FORWARD, 100));
+    TEST_ASSERT_EQUAL_STRING("-1000000,-200000", line);
+}
+
+// INT_MIN has no positive counterpart; it must not overflow
+static void test_int_limits()
+{
+    LcdLine line;
+    fillJunk(line);
+    formatJoystickLine(line, position(INT_MIN, 0), command(MOTOR_STOP, 0));
+    TEST_ASSERT_EQUAL_STRING("-2147483648,0 0%", line);
+
+    fillJunk(line);
+    formatJoystickLine(line, position(INT_MAX, 0), command(MOTOR_STOP, 0));
+    TEST_ASSERT_EQUAL_STRING("2147483647,0 0% ", line);
+
+    // Cut in the middle of the second number
+    fillJunk(line);
+    formatJoystickLine(line, position(-5, INT_MIN), command(MOTOR_STOP, 0));
+    TEST_ASSERT_EQUAL_STRING("-5,-2147483648 0", line);
+}
+
+static void test_direction_line()
+{
+    LcdLine line;
+    fillJunk(line);
+    formatDirectionLine(line, command(MOTOR_FORWARD, 50));
+    TEST_ASSERT_EQUAL_STRING("FORWARD         ", line);
+
+    formatDirectionLine(line, command(MOTOR_BACKWARD, 50));
+    TEST_ASSERT_EQUAL_STRING("BACKWARD        ", line);
+
+    formatDirectionLine(line, command(MOTOR_STOP, 0));
+    TEST_ASSERT_EQUAL_STRING("STOPPED         ", line);
+    TEST_ASSERT_EQUAL_STRING("STOPPED", directionName((MotorDirection)99));
+}
+
+static void test_text_line()
+{
+    LcdLine line;
+    fillJunk(line);
+    formatTextLine(line, "");
+    TEST_ASSERT_EQUAL_STRING("                ", line);
+
+    fillJunk(line);
+    formatTextLine(line, "Calibration");
+    TEST_ASSERT_EQUAL_STRING("Calibration     ", line);
+
+    fillJunk(line);
+    formatTextLine(line, "0123456789ABCDEFGHIJ");
+    TEST_ASSERT_EQUAL_STRING("0123456789ABCDEF", line);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_joystick_line_padded);
+    RUN_TEST(test_zero_values);
+    RUN_TEST(test_joystick_line_truncated);
+    RUN_TEST(test_int_limits);
+    RUN_TEST(test_direction_line);
+    RUN_TEST(test_text_line);
+    return UNITY_END();
+}
@@ -0,0 +1,324 @@
+// LcdFramebuffer against a recording sink: only changed cells are sent,
+// nearby changes merge into one run, a newer frame replaces cells still
+// pending, and flushFor() keeps to its time budget on a fake clock
+#include "lcd_framebuffer.h"
+#include "hd44780.h"
+#include <unity.h>
+#include <string>
+#include <string.h>
+
+// Fake microsecond clock; the sink advances it as the bus would
+static uint32_t fakeMicros = 0;
+static const uint32_t MICROS_PER_RUN = 100;
+
+static uint32_t readFakeMicros()
+{
+    return fakeMicros;
+}
+
+// Logs each run as "col,row:text;"
+class RecordingSink : public LcdSink
+{
+public:
+    std::string log;
+    int runs = 0;
+    uint8_t col = 0;
+    uint8_t row = 0;
+
+    void setCursor(uint8_t newCol, uint8_t newRow) override
+    {
+        col = newCol;
+        row = newRow;
+    }
+
+    void write(const char *chars, uint8_t length) override
+    {
+        log += std::to_string(col) + "," + std::to_string(row) + ":" + std::string(chars, length) + ";";
+        runs++;
+        fakeMicros += MICROS_PER_RUN;
+    }
+
+    void clear()
+    {
+        log.clear();
+        runs = 0;
+    }
+};
+
+void setUp()
+{
+    fakeMicros = 0;
+}
+
+void tearDown()
+{
+}
+
+// A framebuffer whose display is known to hold the two lines
+static void showLines(LcdFramebuffer &framebuffer, const char *top, const char *bottom)
+{
+    LcdLine line;
+    formatTextLine(line, top);
+    framebuffer.markShown(0, line);
+    formatTextLine(line, bottom);
+    framebuffer.markShown(1, line);
+}
+
+static void setText(LcdFramebuffer &framebuffer, uint8_t row, const char *text)
+{
+    LcdLine line;
+    formatTextLine(line, text);
+    framebuffer.setLine(row, line);
+}
+
+static void test_first_flush_redraws_everything()
+{
+    LcdFramebuffer framebuffer;
+    RecordingSink sink;
+    TEST_ASSERT_TRUE(framebuffer.isDirty());
+
+    LcdFlushStats stats = framebuffer.flush(sink);
+    TEST_ASSERT_EQUAL_STRING("0,0:                ;0,1:                ;", sink.log.c_str());
+    TEST_ASSERT_EQUAL(2, stats.runs);
+    TEST_ASSERT_EQUAL(2 * (1 + LCD_COLS), stats.bytes);
+    TEST_ASSERT_FALSE(framebuffer.isDirty());
+}
+
+static void test_unchanged_frame_sends_nothing()
+{
+    LcdFramebuffer framebuffer;
+    RecordingSink sink;
+    showLines(framebuffer, "12,-340 67%", "FORWARD");
+
+    setText(framebuffer, 0, "12,-340 67%");
+    setText(framebuffer, 1, "FORWARD");
+    TEST_ASSERT_FALSE(framebuffer.isDirty());
+    TEST_ASSERT_FALSE(framebuffer.flushRun(sink));
+    TEST_ASSERT_EQUAL(0, sink.runs);
+    TEST_ASSERT_EQUAL(0, framebuffer.getFrameCount());
+}
+
+// One changed digit is one cursor move and one character
+static void test_single_cell_change()
+{
+    LcdFramebuffer framebuffer;
+    RecordingSink sink;
+    showLines(framebuffer, "12,-340 67%", "FORWARD");
+
+    setText(framebuffer, 0, "12,-341 67%");
+    LcdFlushStats stats = framebuffer.flush(sink);
+    TEST_ASSERT_EQUAL_STRING("6,0:1;", sink.log.c_str());
+    TEST_ASSERT_EQUAL(1, stats.runs);
+    TEST_ASSERT_EQUAL(2, stats.bytes);
+    TEST_ASSERT_EQUAL(1, stats.transactions);
+    TEST_ASSERT_EQUAL(2 * HD44780_WIRE_BYTES_PER_BYTE, stats.wireBytes);
+    TEST_ASSERT_EQUAL(1, framebuffer.getFrameCount());
+}
+
+// A gap of LCD_RUN_MERGE_GAP unchanged cells is sent along; a wider gap
+// splits the run
+static void test_run_merging()
+{
+    LcdFramebuffer framebuffer;
+    RecordingSink sink;
+    showLines(framebuffer, "ABCDEFGH", "");
+
+    setText(framebuffer, 0, "xBxDEFGH"); // Gap of one
+    framebuffer.flush(sink);
+    TEST_ASSERT_EQUAL_STRING("0,0:xBx;", sink.log.c_str());
+
+    sink.clear();
+    setText(framebuffer, 0, "ABADyFGH"); // Changes at 0, 2 and 4 merge
+    framebuffer.flush(sink);
+    TEST_ASSERT_EQUAL_STRING("0,0:ABADy;", sink.log.c_str());
+
+    sink.clear();
+    setText(framebuffer, 0, "zBADyFGz"); // Far apart: two runs
+    LcdFlushStats stats = framebuffer.flush(sink);
+    TEST_ASSERT_EQUAL_STRING("0,0:z;7,0:z;", sink.log.c_str());
+    TEST_ASSERT_EQUAL(2, stats.runs);
+    TEST_ASSERT_EQUAL(4, stats.bytes);
+}
+
+// Runs never cross rows, and each row is sent in order
+static void test_both_rows_and_cells()
+{
+    LcdFramebuffer framebuffer;
+    RecordingSink sink;
+    showLines(framebuffer, "0,0 0%", "STOPPED");
+
+    setText(framebuffer, 0, "0,5 3%");
+    setText(framebuffer, 1, "FORWARD");
+    framebuffer.setCell(15, 1, '*');
+    framebuffer.flush(sink);
+    // The shared final 'D' of STOPPED/FORWARD is not resent
+    TEST_ASSERT_EQUAL_STRING("2,0:5 3;0,1:FORWAR;15,1:*;", sink.log.c_str());
+    TEST_ASSERT_EQUAL(0, memcmp(framebuffer.shownRow(1), "FORWARD        *", LCD_COLS));
+
+    // Out-of-range cells and rows are ignored
+    framebuffer.setCell(LCD_COLS, 0, 'x');
+    framebuffer.setCell(0, LCD_ROWS, 'x');
+    TEST_ASSERT_FALSE(framebuffer.isDirty());
+}
+
+static void test_invalidate_and_clear()
+{
+    LcdFramebuffer framebuffer;
+    RecordingSink sink;
+    showLines(framebuffer, "Hello", "World");
+
+    framebuffer.invalidate();
+    framebuffer.flush(sink);
+    TEST_ASSERT_EQUAL_STRING("0,0:Hello           ;0,1:World           ;", sink.log.c_str());
+
+    // After a hardware clear only non-space cells need drawing
+    sink.clear();
+    framebuffer.markCleared();
+    setText(framebuffer, 1, "   Ready");
+    framebuffer.flush(sink);
+    TEST_ASSERT_EQUAL_STRING("3,1:Ready;", sink.log.c_str());
+    TEST_ASSERT_EQUAL((1 + LCD_COLS) * 2 + (1 + 5), framebuffer.getTotalBytes());
+    TEST_ASSERT_EQUAL(2, framebuffer.getFrameCount());
+}
+
+// A frame drawn while the previous one is half sent replaces its pending
+// cells: the stale text never reaches the display
+static void test_newer_frame_coalesces()
+{
+    LcdFramebuffer framebuffer;
+    RecordingSink sink;
+    showLines(framebuffer, "0,0 0%", "STOPPED");
+
+    setText(framebuffer, 0, "5,0 1%");
+    setText(framebuffer, 1, "FORWARD");
+    TEST_ASSERT_TRUE(framebuffer.flushRun(sink));
+    TEST_ASSERT_EQUAL_STRING("0,0:5;", sink.log.c_str());
+
+    // Row 1 changes again before it was sent, row 0 moves on
+    setText(framebuffer, 0, "9,0 2%");
+    setText(framebuffer, 1, "BACKWARD");
+    framebuffer.flush(sink);
+    // Frame A's "1%" and "FORWARD" never go out
+    TEST_ASSERT_EQUAL_STRING("0,0:5;0,0:9;4,0:2;0,1:BACKWARD;", sink.log.c_str());
+    TEST_ASSERT_EQUAL(1, framebuffer.getFrameCount());
+}
+
+// A pending change that reverts before it is sent costs nothing
+static void test_reverted_change_not_sent()
+{
+    LcdFramebuffer framebuffer;
+    RecordingSink sink;
+    showLines(framebuffer, "0,0 0%", "STOPPED");
+
+    setText(framebuffer, 1, "FORWARD");
+    setText(framebuffer, 1, "STOPPED");
+    TEST_ASSERT_FALSE(framebuffer.flushRun(sink));
+    TEST_ASSERT_EQUAL(0, sink.runs);
+}
+
+// Draws four far-apart changes on each row: eight runs
+static void drawEightRuns(LcdFramebuffer &framebuffer)
+{
+    showLines(framebuffer, "", "");
+    setText(framebuffer, 0, "a   b   c   d");
+    setText(framebuffer, 1, "e   f   g   h");
+}
+
+// Runs go out until the budget is spent, then the rest waits for the
+// next call
+static void test_flush_for_keeps_budget()
+{
+    LcdFramebuffer framebuffer;
+    RecordingSink sink;
+    drawEightRuns(framebuffer);
+
+    // 100 us per run: the check after the third run sees 300 >= 250
+    TEST_ASSERT_TRUE(framebuffer.flushFor(sink, 250, readFakeMicros));
+    TEST_ASSERT_EQUAL(3, sink.runs);
+    TEST_ASSERT_TRUE(framebuffer.isDirty());
+
+    TEST_ASSERT_TRUE(framebuffer.flushFor(sink, 400, readFakeMicros));
+    TEST_ASSERT_EQUAL(7, sink.runs);
+    TEST_ASSERT_EQUAL(0, framebuffer.getFrameCount());
+
+    // Last run fits: the frame completes and its statistics close
+    TEST_ASSERT_FALSE(framebuffer.flushFor(sink, 1000, readFakeMicros));
+    TEST_ASSERT_EQUAL(8, sink.runs);
+    TEST_ASSERT_FALSE(framebuffer.isDirty());
+    TEST_ASSERT_EQUAL(1, framebuffer.getFrameCount());
+    TEST_ASSERT_EQUAL(8, framebuffer.getLastFlush().runs);
+    TEST_ASSERT_EQUAL(16, framebuffer.getLastFlush().bytes);
+}
+
+// A budget shorter than one burst still sends one run per call
+static void test_flush_for_zero_budget_progresses()
+{
+    LcdFramebuffer framebuffer;
+    RecordingSink sink;
+    drawEightRuns(framebuffer);
+
+    int calls = 0;
+    while (framebuffer.flushFor(sink, 0, readFakeMicros))
+    {
+        calls++;
+        TEST_ASSERT_EQUAL(calls, sink.runs);
+    }
+    TEST_ASSERT_EQUAL(8, sink.runs);
+    TEST_ASSERT_EQUAL(1, framebuffer.getFrameCount());
+}
+
+// micros() wrapping inside a slice does not end or extend it wrongly
+static void test_flush_for_clock_wraparound()
+{
+    LcdFramebuffer framebuffer;
+    RecordingSink sink;
+    drawEightRuns(framebuffer);
+
+    fakeMicros = 0xFFFFFFFFu - 150;
+    TEST_ASSERT_TRUE(framebuffer.flushFor(sink, 250, readFakeMicros));
+    TEST_ASSERT_EQUAL(3, sink.runs);
+}
+
+// Coalescing between budgeted slices: the queue never holds more than
+// one frame, however far the producer runs ahead
+static void test_flush_for_coalesces_between_slices()
+{
+    LcdFramebuffer framebuffer;
+    RecordingSink sink;
+    showLines(framebuffer, "", "");
+
+    for (int frame = 0; frame < 50; frame++)
+    {
+        LcdLine line;
+        formatTextLine(line, frame % 2 == 0 ? "even" : "odd");
+        framebuffer.setLine(0, line);
+        framebuffer.setLine(1, line);
+        framebuffer.flushFor(sink, 0, readFakeMicros);
+    }
+    while (framebuffer.flushFor(sink, 0, readFakeMicros))
+    {
+    }
+
+    // One run per slice plus the drain; never more than the cells allow
+    TEST_ASSERT_LESS_OR_EQUAL(52, sink.runs);
+    TEST_ASSERT_EQUAL(0, memcmp(framebuffer.shownRow(0), "odd             ", LCD_COLS));
+    TEST_ASSERT_EQUAL(0, memcmp(framebuffer.shownRow(1), "odd             ", LCD_COLS));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_flush_redraws_everything);
+    RUN_TEST(test_unchanged_frame_sends_nothing);
+    RUN_TEST(test_single_cell_change);
+    RUN_TEST(test_run_merging);
+    RUN_TEST(test_both_rows_and_cells);
+    RUN_TEST(test_invalidate_and_clear);
+    RUN_TEST(test_newer_frame_coalesces);
+    RUN_TEST(test_reverted_change_not_sent);
+    RUN_TEST(test_flush_for_keeps_budget);
+    RUN_TEST(test_flush_for_zero_budget_progresses);
+    RUN_TEST(test_flush_for_clock_wraparound);
+    RUN_TEST(test_flush_for_coalesces_between_slices);
+    return UNITY_END();
+}
@@ -0,0 +1,198 @@
+// Seqlock and SpscQueue between two std::threads, the way the control
+// and UI tasks use them
+#include "seqlock.h"
+#include "spsc_queue.h"
+#include <unity.h>
+#include <atomic>
+#include <thread>
+
+// Both sides yield when they have to wait, so this also runs on one core
+static const uint32_t ITEMS = 200000;
+
+// Every field holds the same value, so a torn read shows up as a mismatch
+struct Snapshot
+{
+    uint32_t fields[16];
+};
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static void test_spsc_fifo_and_full()
+{
+    SpscQueue<int, 4> queue;
+    int value;
+
+    TEST_ASSERT_FALSE(queue.pop(value));
+    for (int i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_TRUE(queue.push(i));
+    }
+    TEST_ASSERT_FALSE(queue.push(99));
+    TEST_ASSERT_EQUAL(1, queue.droppedCount());
+    TEST_ASSERT_EQUAL(4, queue.size());
+
+    for (int i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_TRUE(queue.pop(value));
+        TEST_ASSERT_EQUAL(i, value);
+    }
+    TEST_ASSERT_TRUE(queue.empty());
+}
+
+// Producer retries when full: every item arrives once, in order
+static void test_spsc_threads_no_loss()
+{
+    static SpscQueue<uint32_t, 16> queue;
+    std::thread producer([]() {
+        for (uint32_t i = 1; i <= ITEMS; i++)
+        {
+            while (!queue.push(i))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 1;
+    uint32_t value;
+    while (expected <= ITEMS)
+    {
+        if (!queue.pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        if (value != expected)
+            break;
+        expected++;
+    }
+    producer.join();
+
+    TEST_ASSERT_EQUAL_UINT32(ITEMS + 1, expected);
+    TEST_ASSERT_TRUE(queue.empty());
+}
+
+// Producer never waits (as on the control task): every item is either
+// received, in order, or counted as dropped
+static void test_spsc_threads_drops_counted()
+{
+    static SpscQueue<uint32_t, 8> queue;
+    std::atomic<bool> done(false);
+    std::thread producer([&done]() {
+        for (uint32_t i = 1; i <= ITEMS; i++)
+        {
+            if (!queue.push(i))
+                std::this_thread::yield();
+        }
+        done = true;
+    });
+
+    uint32_t received = 0;
+    uint32_t last = 0;
+    bool ordered = true;
+    uint32_t value;
+    bool finished = false;
+    for (;;)
+    {
+        if (queue.pop(value))
+        {
+            ordered = ordered && value > last;
+            last = value;
+            received++;
+        }
+        else if (finished)
+        {
+            break; // Empty after the producer finished: fully drained
+        }
+        else
+        {
+            finished = done;
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL_UINT32(ITEMS, received + queue.droppedCount());
+}
+
+static void test_seqlock_single_thread()
+{
+    Seqlock<Snapshot> latest;
+    TEST_ASSERT_EQUAL_UINT32(0, latest.version());
+
+    Snapshot snapshot;
+    for (int f = 0; f < 16; f++)
+    {
+        snapshot.fields[f] = 7;
+    }
+    latest.write(snapshot);
+    TEST_ASSERT_EQUAL_UINT32(1, latest.version());
+    TEST_ASSERT_EQUAL_UINT32(7, latest.read().fields[15]);
+}
+
+// Reader never sees a half-written snapshot, and values never go back
+static void test_seqlock_threads_no_torn_reads()
+{
+    static Seqlock<Snapshot> latest;
+    std::atomic<bool> done(false);
+    std::thread writer([&done]() {
+        Snapshot snapshot;
+        for (uint32_t i = 1; i <= ITEMS; i++)
+        {
+            for (int f = 0; f < 16; f++)
+            {
+                snapshot.fields[f] = i;
+            }
+            latest.write(snapshot);
+        }
+        done = true;
+    });
+
+    uint32_t reads = 0;
+    uint32_t torn = 0;
+    uint32_t backwards = 0;
+    uint32_t last = 0;
+    while (!done)
+    {
+        Snapshot snapshot = latest.read();
+        for (int f = 1; f < 16; f++)
+        {
+            if (snapshot.fields[f] != snapshot.fields[0])
+            {
+                torn++;
+                break;
+            }
+        }
+        if (snapshot.fields[0] < last)
+            backwards++;
+        last = snapshot.fields[0];
+        reads++;
+        if (reads % 64 == 0)
+            std::this_thread::yield();
+    }
+    writer.join();
+
+    TEST_ASSERT_GREATER_THAN_UINT32(0, reads);
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+    TEST_ASSERT_EQUAL_UINT32(0, backwards);
+    TEST_ASSERT_EQUAL_UINT32(ITEMS, latest.version());
+    TEST_ASSERT_EQUAL_UINT32(ITEMS, latest.read().fields[0]);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_spsc_fifo_and_full);
+    RUN_TEST(test_spsc_threads_no_loss);
+    RUN_TEST(test_spsc_threads_drops_counted);
+    RUN_TEST(test_seqlock_single_thread);
+    RUN_TEST(test_seqlock_threads_no_torn_reads);
+    return UNITY_END();
+}
@@ -0,0 +1,275 @@
+// MpscQueue and Logger with several std::thread producers: no loss when
+// producers retry, per-producer order, counted drops when full, and the
+// rate limit's suppressed counts
+#include "logger.h"
+#include "mpsc_queue.h"
+#include <unity.h>
+#include <atomic>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const int PRODUCERS = 4;
+static const uint32_t PER_PRODUCER = 50000;
+
+struct Item
+{
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+// Checks each producer's items arrive in order; counts them
+struct OrderCheck
+{
+    uint32_t next[PRODUCERS];
+    uint32_t received;
+    uint32_t gaps; // Items skipped within a producer's stream
+    bool ordered;
+
+    OrderCheck() : received(0), gaps(0), ordered(true)
+    {
+        for (int p = 0; p < PRODUCERS; p++)
+        {
+            next[p] = 0;
+        }
+    }
+
+    void accept(uint32_t producer, uint32_t sequence)
+    {
+        if (producer >= (uint32_t)PRODUCERS || sequence < next[producer])
+        {
+            ordered = false;
+            return;
+        }
+        gaps += sequence - next[producer];
+        next[producer] = sequence + 1;
+        received++;
+    }
+};
+
+// Parses drained log lines back into (producer, sequence) pairs
+class CheckingPrint : public Print
+{
+public:
+    OrderCheck check;
+    std::string lastLine;
+    unsigned long reportedDrops = 0;
+
+    size_t write(uint8_t value) override { return write(&value, 1); }
+
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        lastLine.assign((const char *)buffer, size);
+        unsigned long drops;
+        unsigned producer;
+        unsigned sequence;
+        if (sscanf(lastLine.c_str(), "LOG: %lu records dropped", &drops) == 1)
+            reportedDrops += drops;
+        else if (sscanf(lastLine.c_str(), "Command - Direction: %u | Speed: %u%%", &producer, &sequence) == 2)
+            check.accept(producer, sequence);
+        return size;
+    }
+};
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// Producers retry when full: every item arrives, each stream in order
+static void test_mpsc_threads_no_loss()
+{
+    static MpscQueue<Item, 64> queue;
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < PRODUCERS; p++)
+    {
+        producers.push_back(std::thread([p]() {
+            for (uint32_t i = 0; i < PER_PRODUCER; i++)
+            {
+                Item item = {p, i};
+                while (!queue.push(item))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    OrderCheck check;
+    Item item;
+    while (check.received < PRODUCERS * PER_PRODUCER && check.ordered)
+    {
+        if (queue.pop(item))
+            check.accept(item.producer, item.sequence);
+        else
+            std::this_thread::yield();
+    }
+    for (std::thread &producer : producers)
+    {
+        producer.join();
+    }
+
+    TEST_ASSERT_TRUE(check.ordered);
+    TEST_ASSERT_EQUAL_UINT32(PRODUCERS * PER_PRODUCER, check.received);
+    TEST_ASSERT_EQUAL_UINT32(0, check.gaps);
+    TEST_ASSERT_FALSE(queue.pop(item));
+}
+
+static void test_mpsc_full_counts_drops()
+{
+    MpscQueue<int, 8> queue;
+    for (int i = 0; i < 8; i++)
+    {
+        TEST_ASSERT_TRUE(queue.push(i));
+    }
+    TEST_ASSERT_FALSE(queue.push(8));
+    TEST_ASSERT_FALSE(queue.push(9));
+    TEST_ASSERT_EQUAL(2, queue.droppedCount());
+
+    int value;
+    TEST_ASSERT_TRUE(queue.pop(value));
+    TEST_ASSERT_EQUAL(0, value);
+    TEST_ASSERT_TRUE(queue.push(10)); // A freed slot is reusable
+}
+
+// Producers never wait: what is not drained is counted, nothing else lost
+static void test_logger_threads_drops_counted()
+{
+    static Logger log;
+    std::atomic<int> running(PRODUCERS);
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < PRODUCERS; p++)
+    {
+        producers.push_back(std::thread([p, &running]() {
+            for (uint32_t i = 0; i < PER_PRODUCER; i++)
+            {
+                LogArg args[] = {LogArg((int)p), LogArg((int)i), LogArg(0)};
+                log.post(i, LOG_COMMAND, args, 3);
+                if (i % 16 == 0)
+                    std::this_thread::yield();
+            }
+            running--;
+        }));
+    }
+
+    CheckingPrint out;
+    while (running > 0)
+    {
+        if (log.drain(out, 8) == 0)
+            std::this_thread::yield();
+    }
+    for (std::thread &producer : producers)
+    {
+        producer.join();
+    }
+    while (log.drain(out) > 0)
+    {
+    }
+    log.drain(out); // Reports drops that happened after the last report
+
+    TEST_ASSERT_TRUE(out.check.ordered);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, out.check.received);
+    TEST_ASSERT_EQUAL_UINT32(PRODUCERS * PER_PRODUCER, out.check.received + log.getDropped());
+    // Every dropped record is a hole in some producer's sequence
+    uint32_t missing = out.check.gaps;
+    for (int p = 0; p < PRODUCERS; p++)
+    {
+        missing += PER_PRODUCER - out.check.next[p];
+    }
+    TEST_ASSERT_EQUAL_UINT32(log.getDropped(), missing);
+    TEST_ASSERT_EQUAL_UINT32(log.getDropped(), out.reportedDrops);
+}
+
+static void test_logger_full_queue_reports_drops()
+{
+    static Logger log;
+    for (int i = 0; i < LOG_QUEUE_DEPTH; i++)
+    {
+        TEST_ASSERT_TRUE(log.post(0, LOG_MOTOR_STOPPED, nullptr, 0));
+    }
+    TEST_ASSERT_FALSE(log.post(0, LOG_MOTOR_STOPPED, nullptr, 0));
+    TEST_ASSERT_FALSE(log.post(0, LOG_MOTOR_STOPPED, nullptr, 0));
+    TEST_ASSERT_EQUAL(2, log.getDropped());
+
+    CheckingPrint out;
+    TEST_ASSERT_EQUAL(LOG_QUEUE_DEPTH, log.drain(out));
+    TEST_ASSERT_EQUAL(2, out.reportedDrops);
+    TEST_ASSERT_EQUAL_STRING("Motor stopped\r\n", out.lastLine.c_str());
+
+    // Reported once only
+    TEST_ASSERT_EQUAL(0, log.drain(out));
+    TEST_ASSERT_EQUAL(2, out.reportedDrops);
+}
+
+// One record per window; the next one carries the count of the skipped
+static void test_rate_limit_suppressed_count()
+{
+    static Logger log;
+    CheckingPrint out;
+    LogArg args[] = {LogArg("X"), LogArg(5000)};
+
+    TEST_ASSERT_TRUE(log.post(100, LOG_INVALID_ADC, args, 2));
+    for (uint32_t t = 101; t < 1100; t++)
+    {
+        TEST_ASSERT_FALSE(log.post(t, LOG_INVALID_ADC, args, 2));
+    }
+    TEST_ASSERT_TRUE(log.post(1100, LOG_INVALID_ADC, args, 2));
+    TEST_ASSERT_EQUAL(0, log.getDropped());
+
+    TEST_ASSERT_EQUAL(1, log.drain(out, 1));
+    TEST_ASSERT_EQUAL_STRING("ERROR: Invalid ADC reading - X: 5000\r\n", out.lastLine.c_str());
+    TEST_ASSERT_EQUAL(1, log.drain(out, 1));
+    TEST_ASSERT_EQUAL_STRING("ERROR: Invalid ADC reading - X: 5000 (999 suppressed)\r\n", out.lastLine.c_str());
+
+    // Messages without a limit are never suppressed
+    TEST_ASSERT_TRUE(log.post(1100, LOG_MOTOR_STOPPED, nullptr, 0));
+    TEST_ASSERT_TRUE(log.post(1100, LOG_MOTOR_STOPPED, nullptr, 0));
+}
+
+// Racing posters in one window: exactly one wins, the rest are counted
+static void test_rate_limit_threads()
+{
+    static Logger log;
+    static const uint32_t POSTS = 5000; // Total stays below the 16-bit count
+    std::atomic<uint32_t> accepted(0);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++)
+    {
+        producers.push_back(std::thread([&accepted]() {
+            for (uint32_t i = 0; i < POSTS; i++)
+            {
+                if (log.post(5000, LOG_NOT_CALIBRATED, nullptr, 0))
+                    accepted++;
+            }
+        }));
+    }
+    for (std::thread &producer : producers)
+    {
+        producer.join();
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, accepted.load());
+
+    TEST_ASSERT_TRUE(log.post(6000, LOG_NOT_CALIBRATED, nullptr, 0));
+    CheckingPrint out;
+    TEST_ASSERT_EQUAL(2, log.drain(out));
+    char expected[LOG_LINE_LENGTH];
+    snprintf(expected, sizeof(expected), "WARNING: Joystick not calibrated! (%u suppressed)\r\n",
+             (unsigned)(PRODUCERS * POSTS - 1));
+    TEST_ASSERT_EQUAL_STRING(expected, out.lastLine.c_str());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_mpsc_threads_no_loss);
+    RUN_TEST(test_mpsc_full_counts_drops);
+    RUN_TEST(test_logger_threads_drops_counted);
+    RUN_TEST(test_logger_full_queue_reports_drops);
+    RUN_TEST(test_rate_limit_suppressed_count);
+    RUN_TEST(test_rate_limit_threads);
+    return UNITY_END();
+}
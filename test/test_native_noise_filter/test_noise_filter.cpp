@@ -0,0 +1,254 @@
+// NoiseEstimator and OneEuroFilter::setNoise on synthetic noise profiles:
+// the estimate converges and follows changing noise, and the noise-tuned
+// rest cutoff keeps rest jitter low where the fixed average does not; the
+// fixed-point EMA settles exactly on a step
+#include "filters.h"
+#include "noise_estimator.h"
+#include <unity.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Deterministic Gaussian noise (xorshift32 + Box-Muller)
+class GaussianNoise
+{
+private:
+    uint32_t state;
+
+    float uniform()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return ((state >> 8) + 0.5f) / 16777216.0f;
+    }
+
+public:
+    explicit GaussianNoise(uint32_t seed) : state(seed) {}
+
+    float next(float stdDev)
+    {
+        float u1 = uniform();
+        float u2 = uniform();
+        return stdDev * sqrtf(-2.0f * logf(u1)) * cosf(2.0f * 3.14159265f * u2);
+    }
+};
+
+typedef NoiseEstimator<NOISE_WINDOW_SAMPLES> Estimator;
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static void feed(Estimator &estimator, GaussianNoise &noise, float center, float stdDev, int samples)
+{
+    for (int i = 0; i < samples; i++)
+    {
+        estimator.update(center + noise.next(stdDev));
+    }
+}
+
+static void test_constant_input_has_no_noise()
+{
+    Estimator estimator;
+    TEST_ASSERT_FALSE(estimator.isValid());
+    for (int i = 0; i < NOISE_WINDOW_SAMPLES; i++)
+    {
+        estimator.update(2048.0f);
+    }
+    TEST_ASSERT_TRUE(estimator.isValid());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 2048.0f, estimator.getMean());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.0f, estimator.getStdDev());
+    TEST_ASSERT_EQUAL(NOISE_WINDOW_SAMPLES, estimator.getCount());
+}
+
+// Valid after a quarter window; converges on the profile's std dev
+static void test_converges_on_noise_profiles()
+{
+    const float profiles[] = {1.0f, 3.0f, 6.0f, 12.0f, 40.0f};
+    GaussianNoise noise(12345);
+    for (float stdDev : profiles)
+    {
+        Estimator estimator;
+        feed(estimator, noise, 2048.0f, stdDev, NOISE_WINDOW_SAMPLES / 4 - 1);
+        TEST_ASSERT_FALSE(estimator.isValid());
+        feed(estimator, noise, 2048.0f, stdDev, 4 * NOISE_WINDOW_SAMPLES);
+        TEST_ASSERT_TRUE(estimator.isValid());
+
+        TEST_ASSERT_FLOAT_WITHIN(0.2f * stdDev, stdDev, estimator.getStdDev());
+        TEST_ASSERT_FLOAT_WITHIN(0.5f * stdDev, 2048.0f, estimator.getMean());
+    }
+}
+
+// Motor load raises the supply noise: the capped window follows it up and
+// back down within a few windows instead of averaging over all history
+static void test_follows_changing_noise()
+{
+    GaussianNoise noise(777);
+    Estimator estimator;
+    feed(estimator, noise, 0.0f, 3.0f, 20 * NOISE_WINDOW_SAMPLES);
+    TEST_ASSERT_FLOAT_WITHIN(0.6f, 3.0f, estimator.getStdDev());
+
+    feed(estimator, noise, 0.0f, 12.0f, 3 * NOISE_WINDOW_SAMPLES);
+    TEST_ASSERT_FLOAT_WITHIN(2.4f, 12.0f, estimator.getStdDev());
+
+    feed(estimator, noise, 0.0f, 3.0f, 4 * NOISE_WINDOW_SAMPLES);
+    TEST_ASSERT_FLOAT_WITHIN(0.6f, 3.0f, estimator.getStdDev());
+}
+
+// Thermal drift of the rest position (0.5 counts/s) is not mistaken for noise
+static void test_drift_is_not_noise()
+{
+    GaussianNoise noise(99);
+    Estimator estimator;
+    for (int i = 0; i < 20 * NOISE_WINDOW_SAMPLES; i++)
+    {
+        estimator.update(2048.0f + i * 0.001f + noise.next(3.0f));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.6f, 3.0f, estimator.getStdDev());
+}
+
+// Rest cutoff scales with (reference / noise)^2, clamped both ways
+static void test_set_noise_cutoff()
+{
+    OneEuroFilter filter;
+    filter.update(0);
+    filter.update(0);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, ONE_EURO_MIN_CUTOFF_HZ, filter.cutoffHz());
+
+    filter.setNoise(ONE_EURO_NOISE_REFERENCE * 2.0f);
+    filter.update(0);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, ONE_EURO_MIN_CUTOFF_HZ / 4.0f < ONE_EURO_CUTOFF_FLOOR_HZ
+                                         ? ONE_EURO_CUTOFF_FLOOR_HZ
+                                         : ONE_EURO_MIN_CUTOFF_HZ / 4.0f,
+                             filter.cutoffHz());
+
+    filter.setNoise(ONE_EURO_NOISE_REFERENCE * 0.5f);
+    filter.update(0);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, ONE_EURO_MIN_CUTOFF_HZ * 4.0f, filter.cutoffHz());
+
+    filter.setNoise(1000.0f);
+    filter.update(0);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, ONE_EURO_CUTOFF_FLOOR_HZ, filter.cutoffHz());
+
+    filter.setNoise(0.0f);
+    filter.update(0);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, (float)FILTER_CUTOFF_HZ, filter.cutoffHz());
+}
+
+// Std dev of the filter output around rest with the given input noise,
+// the One-Euro tuned by the running estimate as the joystick does
+template <class Filter>
+static float restJitter(Filter &filter, float stdDev, bool tune)
+{
+    GaussianNoise noise(4242);
+    Estimator estimator;
+    Estimator output;
+    for (int i = 0; i < 10 * NOISE_WINDOW_SAMPLES; i++)
+    {
+        float sample = noise.next(stdDev);
+        estimator.update(sample);
+        if (tune && estimator.isValid())
+            filter.setNoise(estimator.getStdDev());
+
+        int value = filter.update((int)lroundf(sample));
+        if (i >= 4 * NOISE_WINDOW_SAMPLES)
+            output.update((float)value);
+    }
+    return output.getStdDev();
+}
+
+static void test_rest_jitter_against_moving_average()
+{
+    const float profiles[] = {3.0f, 6.0f, 12.0f};
+    for (float stdDev : profiles)
+    {
+        OneEuroFilter oneEuro;
+        MovingAverageFilter<FILTER_SAMPLES> average;
+        float tuned = restJitter(oneEuro, stdDev, true);
+        float fixed = restJitter(average, stdDev, false);
+        printf("noise %.0f: one-euro jitter %.2f, %d-tap average %.2f\n", stdDev, tuned, FILTER_SAMPLES, fixed);
+
+        TEST_ASSERT_TRUE(tuned < fixed);
+        TEST_ASSERT_TRUE(tuned < 0.25f * stdDev);
+    }
+}
+
+// Moving the stick opens the cutoff; stopping closes it again
+static void test_cutoff_follows_speed()
+{
+    OneEuroFilter filter;
+    filter.setNoise(ONE_EURO_NOISE_REFERENCE);
+    for (int i = 0; i < 100; i++)
+    {
+        filter.update(0);
+    }
+    float rest = filter.cutoffHz();
+
+    // Full throw in 100 ms
+    int value = 0;
+    for (int i = 0; i < FILTER_SAMPLE_RATE_HZ / 10; i++)
+    {
+        value = filter.update(i * 1000 * 10 / FILTER_SAMPLE_RATE_HZ);
+    }
+    TEST_ASSERT_TRUE(filter.cutoffHz() > 10.0f * rest);
+    TEST_ASSERT_TRUE(value > 500);
+
+    for (int i = 0; i < 5 * FILTER_SAMPLE_RATE_HZ; i++)
+    {
+        value = filter.update(1000);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, rest, filter.cutoffHz());
+    TEST_ASSERT_EQUAL(1000, value);
+}
+
+// Follows the exact exponential to within the output rounding, settles on
+// the input even when AlphaQ8 is small, and rounds both signs alike
+template <int AlphaQ8>
+static void checkEmaStepResponse()
+{
+    EmaFilter<AlphaQ8> filter;
+    EmaFilter<AlphaQ8> negated;
+    const int steps[] = {0, 1000, -1000, 3, 0};
+    const int samplesPerStep = 40 * 256 / AlphaQ8;
+    double exact = 0.0;
+    for (int target : steps)
+    {
+        int value = 0;
+        for (int i = 0; i < samplesPerStep; i++)
+        {
+            value = filter.update(target);
+            exact += (target - exact) * AlphaQ8 / 256.0;
+            TEST_ASSERT_FLOAT_WITHIN(0.51, exact, value);
+            TEST_ASSERT_EQUAL(-value, negated.update(-target));
+        }
+        TEST_ASSERT_EQUAL(target, value);
+    }
+}
+
+static void test_ema_step_response()
+{
+    checkEmaStepResponse<1>();
+    checkEmaStepResponse<2>();
+    checkEmaStepResponse<7>();
+    checkEmaStepResponse<512 / (FILTER_SAMPLES + 1)>();
+    checkEmaStepResponse<256>();
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_constant_input_has_no_noise);
+    RUN_TEST(test_converges_on_noise_profiles);
+    RUN_TEST(test_follows_changing_noise);
+    RUN_TEST(test_drift_is_not_noise);
+    RUN_TEST(test_set_noise_cutoff);
+    RUN_TEST(test_rest_jitter_against_moving_average);
+    RUN_TEST(test_cutoff_follows_speed);
+    RUN_TEST(test_ema_step_response);
+    return UNITY_END();
+}
@@ -0,0 +1,81 @@
+// The default AxisPipeline composition and DefaultCommandMapping against
+// the original read()/processInput() code, tick by tick from raw ADC codes
+// to motor command (tools/pipeline_reference.h, shared with
+// tools/pipeline_bench.cpp)
+#include "../../tools/pipeline_reference.h"
+#include <unity.h>
+#include <stdio.h>
+
+#ifndef PIPELINE_TEST_TICKS
+#define PIPELINE_TEST_TICKS (32L * INPUT_TICKS)
+#endif
+
+static int input[INPUT_TICKS][2];
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static void assertEquivalent(long ticks)
+{
+    static OriginalPath original; // LUT kernel tables kept off the stack
+    static ComposedPath composed;
+    TickResult expected, actual;
+    long mismatch = firstMismatch(input, ticks, original, composed, expected, actual);
+    if (mismatch >= 0)
+    {
+        char message[160];
+        snprintf(message, sizeof(message), "tick %ld: original %d,%d -> %d/%d%%, composed %d,%d -> %d/%d%%",
+                 mismatch, expected.axis[0], expected.axis[1], (int)expected.command.direction,
+                 expected.command.speedPercent, actual.axis[0], actual.axis[1], (int)actual.command.direction,
+                 actual.command.speedPercent);
+        TEST_FAIL_MESSAGE(message);
+    }
+}
+
+// The pattern covers rest, sweeps and spikes on both axes
+static void test_input_pattern_coverage()
+{
+    int rest = 0, spikes = 0, full = 0;
+    for (int t = 0; t < INPUT_TICKS; t++)
+    {
+        for (int axis = 0; axis < 2; axis++)
+        {
+            int value = input[t][axis];
+            rest += (value > CAL_CENTER[axis] - 20 && value < CAL_CENTER[axis] + 20) ? 1 : 0;
+            spikes += (value == 0 || value == ADC_MAX_VALUE) ? 1 : 0;
+            full += (value < CAL_MIN[axis] || value > CAL_MAX[axis]) ? 1 : 0;
+        }
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(2 * INPUT_TICKS / 4, rest);
+    TEST_ASSERT_GREATER_THAN(10, spikes);
+    TEST_ASSERT_GREATER_THAN(100, full);
+}
+
+static void test_single_pass_equivalent()
+{
+    assertEquivalent(INPUT_TICKS);
+}
+
+// Many repetitions: filter, noise estimator and glitch state carried
+// across the pattern boundary
+static void test_long_run_equivalent()
+{
+    assertEquivalent(PIPELINE_TEST_TICKS);
+    printf("Equivalent over %ld ticks\n", (long)PIPELINE_TEST_TICKS);
+}
+
+int main()
+{
+    buildInput(input);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_input_pattern_coverage);
+    RUN_TEST(test_single_pass_equivalent);
+    RUN_TEST(test_long_run_equivalent);
+    return UNITY_END();
+}
@@ -0,0 +1,203 @@
+// Profiler probes and latency histograms driven by a fake cycle counter:
+// exact min/max, p50/p99 within the histogram's factor-of-two bound, and
+// counter wraparound
+#include "profiler.h"
+#include <unity.h>
+#include <string>
+
+static uint32_t fakeCycles = 0;
+
+static uint32_t fakeCycleCount()
+{
+    return fakeCycles;
+}
+
+// Collects what profileDump() prints
+class StringPrint : public Print
+{
+public:
+    std::string text;
+
+    size_t write(uint8_t value) override
+    {
+        text += (char)value;
+        return 1;
+    }
+};
+
+void setUp()
+{
+    fakeCycles = 0;
+    setCycleCounter(fakeCycleCount);
+}
+
+void tearDown()
+{
+    setCycleCounter(nullptr);
+}
+
+// One probe around work that takes the given number of cycles
+static void probe(LatencyHistogram &histogram, uint32_t cycles)
+{
+    ScopedProbe scope(histogram);
+    fakeCycles += cycles;
+}
+
+static void test_probe_records_elapsed_cycles()
+{
+    LatencyHistogram histogram;
+    fakeCycles = 5000;
+    probe(histogram, 1234);
+
+    TEST_ASSERT_EQUAL_UINT32(1, histogram.getCount());
+    TEST_ASSERT_EQUAL_UINT32(1234, histogram.getMin());
+    TEST_ASSERT_EQUAL_UINT32(1234, histogram.getMax());
+    TEST_ASSERT_EQUAL_UINT32(1, histogram.getBucket(LatencyHistogram::bucketFor(1234)));
+}
+
+// CCOUNT wraps every ~18 s at 240 MHz; a probe across it is still right
+static void test_probe_across_counter_wraparound()
+{
+    LatencyHistogram histogram;
+    fakeCycles = 0xFFFFFF00u;
+    probe(histogram, 0x200);
+
+    TEST_ASSERT_EQUAL_UINT32(0x200, histogram.getMax());
+    TEST_ASSERT_EQUAL_UINT32(0x100, fakeCycles);
+}
+
+static void test_bucket_boundaries()
+{
+    TEST_ASSERT_EQUAL(0, LatencyHistogram::bucketFor(0));
+    TEST_ASSERT_EQUAL(0, LatencyHistogram::bucketFor(1));
+    TEST_ASSERT_EQUAL(1, LatencyHistogram::bucketFor(2));
+    TEST_ASSERT_EQUAL(1, LatencyHistogram::bucketFor(3));
+    TEST_ASSERT_EQUAL(10, LatencyHistogram::bucketFor(1024));
+    TEST_ASSERT_EQUAL(9, LatencyHistogram::bucketFor(1023));
+    TEST_ASSERT_EQUAL(31, LatencyHistogram::bucketFor(UINT32_MAX));
+}
+
+static void test_empty_histogram()
+{
+    LatencyHistogram histogram;
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.getCount());
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.getMin());
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.getMax());
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.getMean());
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.percentile(50));
+}
+
+// Constant latency: every percentile is exact, clamped to min and max
+static void test_constant_latency()
+{
+    LatencyHistogram histogram;
+    for (int i = 0; i < 500; i++)
+    {
+        probe(histogram, 3000);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3000, histogram.getMin());
+    TEST_ASSERT_EQUAL_UINT32(3000, histogram.getMax());
+    TEST_ASSERT_EQUAL_UINT32(3000, histogram.getMean());
+    TEST_ASSERT_EQUAL_UINT32(3000, histogram.percentile(50));
+    TEST_ASSERT_EQUAL_UINT32(3000, histogram.percentile(99));
+}
+
+// Uniform 1..1000: percentiles within a factor of two of the true value
+static void test_uniform_percentiles()
+{
+    LatencyHistogram histogram;
+    for (uint32_t cycles = 1; cycles <= 1000; cycles++)
+    {
+        probe(histogram, cycles);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(1000, histogram.getCount());
+    TEST_ASSERT_EQUAL_UINT32(1, histogram.getMin());
+    TEST_ASSERT_EQUAL_UINT32(1000, histogram.getMax());
+    TEST_ASSERT_EQUAL_UINT32(500, histogram.getMean()); // 500.5, truncated
+
+    uint32_t p50 = histogram.percentile(50);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(250, p50);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1000, p50);
+
+    uint32_t p99 = histogram.percentile(99);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(495, p99);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1000, p99);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(p50, p99);
+    TEST_ASSERT_EQUAL_UINT32(1000, histogram.percentile(100));
+}
+
+// A rare stall shows in max, not in p50/p99
+static void test_rare_spikes()
+{
+    LatencyHistogram histogram;
+    for (int i = 0; i < 1000; i++)
+    {
+        probe(histogram, (i % 100 == 99) ? 50000 : 100);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(100, histogram.getMin());
+    TEST_ASSERT_EQUAL_UINT32(50000, histogram.getMax());
+    TEST_ASSERT_EQUAL_UINT32(599, histogram.getMean());
+    TEST_ASSERT_EQUAL(990, histogram.getBucket(LatencyHistogram::bucketFor(100)));
+    TEST_ASSERT_EQUAL(10, histogram.getBucket(LatencyHistogram::bucketFor(50000)));
+
+    TEST_ASSERT_LESS_THAN_UINT32(128, histogram.percentile(50));
+    TEST_ASSERT_LESS_THAN_UINT32(128, histogram.percentile(99));
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(32768, histogram.percentile(100));
+}
+
+static void test_reset_clears()
+{
+    LatencyHistogram histogram;
+    probe(histogram, 77);
+    histogram.reset();
+
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.getCount());
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.getMax());
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.getBucket(LatencyHistogram::bucketFor(77)));
+
+    probe(histogram, 5);
+    TEST_ASSERT_EQUAL_UINT32(5, histogram.getMin());
+}
+
+static void test_stage_histograms_and_dump()
+{
+    StringPrint out;
+    profileReset();
+    profileDump(out);
+#if PROFILING_ENABLED
+    LatencyHistogram *loop = profileHistogram(PROFILE_LOOP);
+    TEST_ASSERT_NOT_NULL(loop);
+    {
+        PROFILE_SCOPE(PROFILE_LOOP);
+        fakeCycles += PROFILE_CPU_MHZ * 15; // 15 us
+    }
+    TEST_ASSERT_EQUAL_UINT32(PROFILE_CPU_MHZ * 15, loop->getMax());
+
+    out.text.clear();
+    profileDump(out);
+    TEST_ASSERT_TRUE(out.text.find("loop   n=1 min 15.0") != std::string::npos);
+    profileReset();
+    TEST_ASSERT_EQUAL_UINT32(0, loop->getCount());
+#else
+    TEST_ASSERT_NULL(profileHistogram(PROFILE_LOOP));
+    TEST_ASSERT_TRUE(out.text.find("Profiling disabled") != std::string::npos);
+#endif
+    TEST_ASSERT_EQUAL_STRING("serial", profileStageName(PROFILE_SERIAL));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_probe_records_elapsed_cycles);
+    RUN_TEST(test_probe_across_counter_wraparound);
+    RUN_TEST(test_bucket_boundaries);
+    RUN_TEST(test_empty_histogram);
+    RUN_TEST(test_constant_latency);
+    RUN_TEST(test_uniform_percentiles);
+    RUN_TEST(test_rare_spikes);
+    RUN_TEST(test_reset_clears);
+    RUN_TEST(test_stage_histograms_and_dump);
+    return UNITY_END();
+}
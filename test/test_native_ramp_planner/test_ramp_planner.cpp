@@ -0,0 +1,242 @@
+// RampPlanner on a simulated micros() clock: the slew limit holds per call
+// interval, ramps take the same time whatever the call rate, reversals
+// wait out the dead time at zero, and nothing changes across the 32-bit
+// micros() wraparound
+#include "ramp_planner.h"
+#include <unity.h>
+#include <stdint.h>
+
+static const uint32_t MICROS_PER_SECOND = 1000000UL;
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// Duty counts the slew rate allows in elapsedUs, rounded down
+static int allowed(uint32_t elapsedUs)
+{
+    return (int)((uint64_t)elapsedUs * MOTOR_SLEW_RATE / MICROS_PER_SECOND);
+}
+
+// Runs update() every stepUs until the duty settles; returns the time taken
+static uint32_t runUntilSettled(RampPlanner &planner, uint32_t &nowUs, uint32_t stepUs)
+{
+    uint32_t start = nowUs;
+    while (!planner.isSettled())
+    {
+        nowUs += stepUs;
+        planner.update(nowUs);
+    }
+    return nowUs - start;
+}
+
+// At the loop's 20 ms the duty moves by exactly RAMP_STEP per call
+static void test_max_step_per_interval()
+{
+    RampPlanner planner;
+    uint32_t now = 1000;
+    planner.update(now);
+    planner.setTarget(MOTOR_FORWARD, MAX_SPEED);
+
+    int previous = 0;
+    while (!planner.isSettled())
+    {
+        now += RAMP_DELAY * 1000;
+        int duty = planner.update(now).duty;
+        TEST_ASSERT_LESS_OR_EQUAL(RAMP_STEP, duty - previous);
+        TEST_ASSERT_TRUE(duty == MAX_SPEED || duty - previous == RAMP_STEP);
+        previous = duty;
+    }
+
+    // Any interval: never more than the slew rate allows
+    for (uint32_t step = 1; step < 100000; step = step * 3 + 7)
+    {
+        RampPlanner fresh;
+        fresh.update(0);
+        fresh.setTarget(MOTOR_BACKWARD, MAX_SPEED);
+        TEST_ASSERT_EQUAL(allowed(step), fresh.update(step).duty);
+    }
+}
+
+// 200 -> 0 at 250 counts/s takes 800 ms
+static void test_ramp_down_timing()
+{
+    RampPlanner planner;
+    uint32_t now = 0;
+    planner.update(now);
+    planner.setTarget(MOTOR_FORWARD, 200);
+    runUntilSettled(planner, now, 2000);
+    TEST_ASSERT_EQUAL(200, planner.getDuty());
+
+    planner.setTarget(MOTOR_STOP, 0);
+    uint32_t expected = 200 * MICROS_PER_SECOND / MOTOR_SLEW_RATE;
+    uint32_t taken = runUntilSettled(planner, now, 2000);
+    TEST_ASSERT_EQUAL_UINT32(expected, taken);
+    TEST_ASSERT_EQUAL(MOTOR_STOP, planner.update(now).direction);
+}
+
+// Forward 100 -> backward 100: down to zero, held for the dead time, then up
+static void test_reverse_dead_time()
+{
+    RampPlanner planner;
+    uint32_t now = 0;
+    planner.update(now);
+    planner.setTarget(MOTOR_FORWARD, 100);
+    runUntilSettled(planner, now, 1000);
+
+    planner.setTarget(MOTOR_BACKWARD, 100);
+    uint32_t start = now;
+    uint32_t reachedZero = 0;
+    uint32_t leftZero = 0;
+    while (!planner.isSettled())
+    {
+        now += 1000;
+        MotorOutput output = planner.update(now);
+        if (output.duty == 0 && reachedZero == 0)
+            reachedZero = now;
+        if (output.direction == MOTOR_BACKWARD && leftZero == 0)
+            leftZero = now;
+        if (leftZero == 0)
+            TEST_ASSERT_NOT_EQUAL(MOTOR_BACKWARD, output.direction);
+    }
+
+    uint32_t down = 100 * MICROS_PER_SECOND / MOTOR_SLEW_RATE;
+    TEST_ASSERT_EQUAL_UINT32(start + down, reachedZero);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(reachedZero + MOTOR_REVERSE_DEAD_TIME_US, leftZero);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(reachedZero + MOTOR_REVERSE_DEAD_TIME_US + 1000 + 4000, leftZero);
+    TEST_ASSERT_EQUAL(-100, planner.getDuty());
+    // The call that ends the hold spends its whole interval ramping
+    TEST_ASSERT_INT_WITHIN(1000, start + 2 * down + MOTOR_REVERSE_DEAD_TIME_US, now);
+
+    // Stopped long enough already: the next reversal starts at once
+    planner.setTarget(MOTOR_STOP, 0);
+    runUntilSettled(planner, now, 1000);
+    now += MOTOR_REVERSE_DEAD_TIME_US;
+    planner.update(now);
+    planner.setTarget(MOTOR_FORWARD, 50);
+    now += 20000;
+    TEST_ASSERT_EQUAL(allowed(20000), planner.update(now).duty);
+}
+
+// Irregular call intervals: the duty is a function of elapsed time alone,
+// the sub-count remainder carries over
+static void test_irregular_intervals()
+{
+    RampPlanner planner;
+    uint32_t now = 0;
+    planner.update(now);
+    planner.setTarget(MOTOR_FORWARD, MAX_SPEED);
+
+    uint32_t seed = 12345;
+    while (!planner.isSettled())
+    {
+        seed = seed * 1664525u + 1013904223u;
+        now += 1 + (seed >> 17) % 30000; // 1 us .. 30 ms
+        int expected = allowed(now);
+        if (expected > MAX_SPEED)
+            expected = MAX_SPEED;
+        TEST_ASSERT_EQUAL(expected, planner.update(now).duty);
+    }
+
+    // Many 1 us calls add up like one long one
+    RampPlanner fine;
+    fine.update(0);
+    fine.setTarget(MOTOR_FORWARD, MAX_SPEED);
+    for (uint32_t t = 1; t <= 100000; t++)
+    {
+        fine.update(t);
+    }
+    TEST_ASSERT_EQUAL(allowed(100000), fine.getDuty());
+}
+
+// Same reversal starting 300 ms before micros() wraps and starting at 0
+static void test_micros_wraparound()
+{
+    RampPlanner wrapped;
+    RampPlanner plain;
+    uint32_t origin = 0xFFFFFFFFu - 300000;
+    wrapped.update(origin);
+    plain.update(0);
+    wrapped.setTarget(MOTOR_FORWARD, 80);
+    plain.setTarget(MOTOR_FORWARD, 80);
+
+    for (uint32_t t = 1000; t <= 2000000; t += 1000)
+    {
+        if (t == 400000)
+        {
+            wrapped.setTarget(MOTOR_BACKWARD, 120);
+            plain.setTarget(MOTOR_BACKWARD, 120);
+        }
+        int expected = plain.update(t).duty;
+        TEST_ASSERT_EQUAL(expected, wrapped.update(origin + t).duty);
+        TEST_ASSERT_EQUAL(plain.getDuty(), wrapped.getDuty());
+    }
+    TEST_ASSERT_EQUAL(-120, wrapped.getDuty());
+
+    // Dead time straddling the wrap
+    RampPlanner reverse;
+    uint32_t now = 0xFFFFFFFFu - 10000;
+    reverse.update(now - 1000000);
+    reverse.setTarget(MOTOR_FORWARD, 5);
+    reverse.update(now - 500000);
+    reverse.setTarget(MOTOR_STOP, 0);
+    reverse.update(now); // Reaches zero here
+    TEST_ASSERT_EQUAL(0, reverse.getDuty());
+    reverse.setTarget(MOTOR_BACKWARD, 5);
+    TEST_ASSERT_EQUAL(0, reverse.update(now + MOTOR_REVERSE_DEAD_TIME_US - 1000).duty);
+    TEST_ASSERT_EQUAL(MOTOR_BACKWARD, reverse.update(now + MOTOR_REVERSE_DEAD_TIME_US + 8000).direction);
+}
+
+// dutyAfter() predicts what update() will return
+static void test_duty_after_matches_update()
+{
+    RampPlanner planner;
+    uint32_t now = 0;
+    planner.update(now);
+    planner.setTarget(MOTOR_FORWARD, 60);
+    now += 100000;
+    planner.update(now);
+    planner.setTarget(MOTOR_BACKWARD, 60);
+
+    for (int i = 0; i < 100; i++)
+    {
+        int predicted = planner.dutyAfter(7000);
+        now += 7000;
+        planner.update(now);
+        TEST_ASSERT_EQUAL(predicted, planner.getDuty());
+    }
+}
+
+static void test_stop_now_and_clamp()
+{
+    RampPlanner planner;
+    planner.update(0);
+    planner.setTarget(MOTOR_FORWARD, 1000);
+    TEST_ASSERT_EQUAL(MAX_SPEED, planner.getTarget());
+    planner.setTarget(MOTOR_BACKWARD, -5);
+    TEST_ASSERT_EQUAL(0, planner.getTarget());
+
+    planner.setTarget(MOTOR_FORWARD, 100);
+    planner.update(200000);
+    TEST_ASSERT_EQUAL(50, planner.getDuty());
+    planner.stopNow();
+    TEST_ASSERT_EQUAL(0, planner.getDuty());
+    TEST_ASSERT_TRUE(planner.isSettled());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_max_step_per_interval);
+    RUN_TEST(test_ramp_down_timing);
+    RUN_TEST(test_reverse_dead_time);
+    RUN_TEST(test_irregular_intervals);
+    RUN_TEST(test_micros_wraparound);
+    RUN_TEST(test_duty_after_matches_update);
+    RUN_TEST(test_stop_now_and_clamp);
+    return UNITY_END();
+}
@@ -0,0 +1,261 @@
+// Speed response curves: every built-in profile is monotonic over the
+// whole stick range, hits its end points exactly (at zero and at full
+// scale), and its table stays within a percent of the exact curve;
+// malformed specs are rejected, and switching profiles, also from another
+// thread, only ever yields values of one complete profile
+#include "response_curve.h"
+#include "command_mapping.h"
+#include <unity.h>
+#include <atomic>
+#include <math.h>
+#include <thread>
+
+static const int SPAN = MAX_OUTPUT - SPEED_DEAD_ZONE;
+static const float MAX_TABLE_ERROR = 1.0f; // Percent, rounding included
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static float shapeAt(const CurveSpec &spec, float t)
+{
+    if (spec.kind == CURVE_EXPO)
+    {
+        float expo = spec.expoPercent / 100.0f;
+        return (1.0f - expo) * t + expo * t * t * t;
+    }
+
+    int i = 0;
+    while (i < spec.pointCount - 2 && t * 100.0f > spec.points[i + 1].x)
+    {
+        i++;
+    }
+    float s = (t * 100.0f - spec.points[i].x) / (spec.points[i + 1].x - spec.points[i].x);
+    return (spec.points[i].y + s * (spec.points[i + 1].y - spec.points[i].y)) / 100.0f;
+}
+
+// Exact curve in percent at stick position y (expo and piecewise; a
+// spline is checked through its control points)
+static float exactPercent(const CurveSpec &spec, int y)
+{
+    float t = (float)(y - SPEED_DEAD_ZONE) / SPAN;
+    return MIN_MOTOR_PERCENT + (100 - MIN_MOTOR_PERCENT) * shapeAt(spec, t);
+}
+
+static void test_profiles_monotonic_and_in_range()
+{
+    for (int p = 0; p < SPEED_CURVE_COUNT; p++)
+    {
+        const CurveSpec &spec = SPEED_CURVE_PROFILES[p];
+        CurveTable table;
+        TEST_ASSERT_TRUE_MESSAGE(table.compile(spec, SPEED_DEAD_ZONE, MAX_OUTPUT, MIN_MOTOR_PERCENT, 100), spec.name);
+
+        int previous = -1;
+        for (int y = MIN_OUTPUT - 100; y <= MAX_OUTPUT + 100; y++)
+        {
+            int value = table.evaluate(y);
+            TEST_ASSERT_GREATER_OR_EQUAL_MESSAGE(previous, value, spec.name);
+            TEST_ASSERT_GREATER_OR_EQUAL_MESSAGE(MIN_MOTOR_PERCENT, value, spec.name);
+            TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(100, value, spec.name);
+            previous = value;
+        }
+    }
+}
+
+// Below the dead zone the table clamps to its start, past full travel to
+// its end; the raw 0..255 range lands exactly on both ends too
+static void test_profile_end_points()
+{
+    for (int p = 0; p < SPEED_CURVE_COUNT; p++)
+    {
+        const CurveSpec &spec = SPEED_CURVE_PROFILES[p];
+        CurveTable table;
+        table.compile(spec, SPEED_DEAD_ZONE, MAX_OUTPUT, MIN_MOTOR_PERCENT, 100);
+        TEST_ASSERT_EQUAL_MESSAGE(MIN_MOTOR_PERCENT, table.evaluate(0), spec.name);
+        TEST_ASSERT_EQUAL_MESSAGE(MIN_MOTOR_PERCENT, table.evaluate(SPEED_DEAD_ZONE), spec.name);
+        TEST_ASSERT_EQUAL_MESSAGE(100, table.evaluate(MAX_OUTPUT), spec.name);
+        TEST_ASSERT_EQUAL_MESSAGE(100, table.evaluate(MAX_OUTPUT + 1000), spec.name);
+
+        CurveTable full;
+        TEST_ASSERT_TRUE(full.compile(spec, 0, MAX_OUTPUT, 0, 255));
+        TEST_ASSERT_EQUAL_MESSAGE(0, full.evaluate(0), spec.name);
+        TEST_ASSERT_EQUAL_MESSAGE(255, full.evaluate(MAX_OUTPUT), spec.name);
+    }
+}
+
+static void test_table_matches_exact_curve()
+{
+    for (int p = 0; p < SPEED_CURVE_COUNT; p++)
+    {
+        const CurveSpec &spec = SPEED_CURVE_PROFILES[p];
+        CurveTable table;
+        table.compile(spec, SPEED_DEAD_ZONE, MAX_OUTPUT, MIN_MOTOR_PERCENT, 100);
+
+        if (spec.kind == CURVE_SPLINE)
+        {
+            // Splines pass through their control points
+            for (int i = 0; i < spec.pointCount; i++)
+            {
+                int y = SPEED_DEAD_ZONE + spec.points[i].x * SPAN / 100;
+                float expected = MIN_MOTOR_PERCENT + (100 - MIN_MOTOR_PERCENT) * spec.points[i].y / 100.0f;
+                TEST_ASSERT_FLOAT_WITHIN_MESSAGE(MAX_TABLE_ERROR, expected, (float)table.evaluate(y), spec.name);
+            }
+            continue;
+        }
+
+        for (int y = SPEED_DEAD_ZONE; y <= MAX_OUTPUT; y++)
+        {
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(MAX_TABLE_ERROR, exactPercent(spec, y), (float)table.evaluate(y),
+                                             spec.name);
+        }
+    }
+}
+
+static void test_malformed_specs_rejected()
+{
+    static const CurvePoint unsorted[] = {{0, 0}, {60, 50}, {40, 60}, {100, 100}};
+    static const CurvePoint falling[] = {{0, 0}, {50, 60}, {70, 40}, {100, 100}};
+    static const CurvePoint open[] = {{0, 10}, {100, 100}};
+    const CurveSpec bad[] = {
+        {"unsorted", CURVE_SPLINE, 0, unsorted, 4},
+        {"falling", CURVE_PIECEWISE, 0, falling, 4},
+        {"open end", CURVE_SPLINE, 0, open, 2},
+        {"expo 150", CURVE_EXPO, 150, nullptr, 0},
+    };
+
+    CurveTable table;
+    for (int i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_FALSE_MESSAGE(table.compile(bad[i], SPEED_DEAD_ZONE, MAX_OUTPUT, MIN_MOTOR_PERCENT, 100),
+                                  bad[i].name);
+    }
+    TEST_ASSERT_FALSE(table.compile(SPEED_CURVE_PROFILES[0], MAX_OUTPUT, SPEED_DEAD_ZONE, 0, 100));
+    TEST_ASSERT_FALSE(table.compile(SPEED_CURVE_PROFILES[0], SPEED_DEAD_ZONE, MAX_OUTPUT, 0, 256));
+
+    // Nothing compiles: a single linear profile stands in
+    ResponseCurveSet fallback;
+    TEST_ASSERT_EQUAL(1, fallback.begin(bad, 4, SPEED_DEAD_ZONE, MAX_OUTPUT, MIN_MOTOR_PERCENT, 100));
+    TEST_ASSERT_EQUAL_STRING("linear", fallback.getName(0));
+    TEST_ASSERT_EQUAL(MIN_MOTOR_PERCENT, fallback.evaluate(SPEED_DEAD_ZONE));
+    TEST_ASSERT_EQUAL(100, fallback.evaluate(MAX_OUTPUT));
+}
+
+static void test_profile_switch()
+{
+    static ResponseCurveSet curves;
+    TEST_ASSERT_EQUAL(SPEED_CURVE_COUNT,
+                      curves.begin(SPEED_CURVE_PROFILES, SPEED_CURVE_COUNT, SPEED_DEAD_ZONE, MAX_OUTPUT,
+                                   MIN_MOTOR_PERCENT, 100));
+    TEST_ASSERT_EQUAL(0, curves.getActive());
+
+    const int mid = SPEED_DEAD_ZONE + SPAN / 2;
+    for (int p = 0; p < SPEED_CURVE_COUNT; p++)
+    {
+        TEST_ASSERT_TRUE(curves.select(p));
+        TEST_ASSERT_EQUAL(p, curves.getActive());
+        TEST_ASSERT_EQUAL_STRING(SPEED_CURVE_PROFILES[p].name, curves.getName(p));
+
+        CurveTable table;
+        table.compile(SPEED_CURVE_PROFILES[p], SPEED_DEAD_ZONE, MAX_OUTPUT, MIN_MOTOR_PERCENT, 100);
+        TEST_ASSERT_EQUAL(table.evaluate(mid), curves.evaluate(mid));
+    }
+
+    // Halfway, expo is well below linear: the switch changes the output
+    curves.select(0);
+    int linear = curves.evaluate(mid);
+    curves.select(1);
+    TEST_ASSERT_LESS_THAN(linear - 5, curves.evaluate(mid));
+
+    TEST_ASSERT_FALSE(curves.select(SPEED_CURVE_COUNT));
+    TEST_ASSERT_FALSE(curves.select(-1));
+    TEST_ASSERT_EQUAL(1, curves.getActive());
+    TEST_ASSERT_EQUAL_STRING("none", curves.getName(SPEED_CURVE_COUNT));
+
+    curves.select(SPEED_CURVE_COUNT - 1);
+    TEST_ASSERT_EQUAL(0, curves.selectNext());
+    TEST_ASSERT_EQUAL(1, curves.selectNext());
+}
+
+// Through the command mapping: zero stick is 0%, full travel 100%
+static void test_command_end_points()
+{
+    static DirectionSpeedMapping mapping;
+    const int velocity[JOYSTICK_AXES] = {};
+    for (int p = 0; p < SPEED_CURVE_COUNT; p++)
+    {
+        mapping.getSpeedCurves().select(p);
+        SimpleMotorCommand command;
+
+        int rest[JOYSTICK_AXES] = {0, 0};
+        mapping.map(rest, velocity, command);
+        TEST_ASSERT_EQUAL(0, command.speedPercent);
+        TEST_ASSERT_EQUAL(0, command.speedPWM);
+
+        int full[JOYSTICK_AXES] = {0, MAX_OUTPUT};
+        mapping.map(full, velocity, command);
+        TEST_ASSERT_EQUAL(100, command.speedPercent);
+        TEST_ASSERT_EQUAL(MAX_SPEED, command.speedPWM);
+    }
+    mapping.getSpeedCurves().select(SPEED_CURVE_DEFAULT);
+}
+
+// Every value seen while another thread flips profiles must belong to
+// one complete profile
+static void test_switch_while_evaluating()
+{
+    static ResponseCurveSet curves;
+    curves.begin(SPEED_CURVE_PROFILES, SPEED_CURVE_COUNT, SPEED_DEAD_ZONE, MAX_OUTPUT, MIN_MOTOR_PERCENT, 100);
+
+    static bool allowed[MAX_OUTPUT + 1][101];
+    for (int p = 0; p < curves.getCount(); p++)
+    {
+        curves.select(p);
+        for (int y = SPEED_DEAD_ZONE; y <= MAX_OUTPUT; y++)
+        {
+            allowed[y][curves.evaluate(y)] = true;
+        }
+    }
+
+    std::atomic<bool> running(true);
+    std::atomic<long> switches(0);
+    std::thread switcher([&]() {
+        while (running.load())
+        {
+            curves.selectNext();
+            switches++;
+            std::this_thread::yield();
+        }
+    });
+
+    long bad = 0;
+    for (long i = 0; i < 2000000; i++)
+    {
+        int y = SPEED_DEAD_ZONE + (int)(i % (SPAN + 1));
+        if (!allowed[y][curves.evaluate(y)])
+            bad++;
+        if (i % 1000 == 0)
+            std::this_thread::yield();
+    }
+    running = false;
+    switcher.join();
+
+    TEST_ASSERT_EQUAL(0, bad);
+    TEST_ASSERT_GREATER_THAN(0, switches.load());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_profiles_monotonic_and_in_range);
+    RUN_TEST(test_profile_end_points);
+    RUN_TEST(test_table_matches_exact_curve);
+    RUN_TEST(test_malformed_specs_rejected);
+    RUN_TEST(test_profile_switch);
+    RUN_TEST(test_command_end_points);
+    RUN_TEST(test_switch_while_evaluating);
+    return UNITY_END();
+}
@@ -0,0 +1,198 @@
+// FixedRateScheduler on a simulated clock: period accuracy, skipped
+// periods, overrun accounting and micros() wraparound
+#include "fixed_rate_scheduler.h"
+#include <unity.h>
+
+static const uint32_t PERIOD = 2000; // 500 Hz
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// Polls every step us until the scheduler ticks; returns the tick time
+static uint32_t runToTick(FixedRateScheduler &scheduler, SimulatedClock &clock, uint32_t step)
+{
+    while (!scheduler.poll())
+    {
+        clock.advance(step);
+    }
+    return clock.nowMicros();
+}
+
+static void test_first_tick_is_immediate()
+{
+    SimulatedClock clock(12345);
+    FixedRateScheduler scheduler(&clock, PERIOD);
+
+    TEST_ASSERT_FALSE(scheduler.poll()); // Not started
+    scheduler.start(false);
+    TEST_ASSERT_FALSE(scheduler.isHardwareTimed());
+    TEST_ASSERT_TRUE(scheduler.poll());
+    TEST_ASSERT_FALSE(scheduler.poll());
+    TEST_ASSERT_EQUAL_UINT32(PERIOD, scheduler.microsUntilNextTick());
+}
+
+// Ticks land on whole periods from the start, however coarse the polling
+static void test_period_accuracy()
+{
+    SimulatedClock clock(1000);
+    FixedRateScheduler scheduler(&clock, PERIOD);
+    scheduler.start(false);
+    scheduler.poll();
+
+    for (uint32_t k = 1; k <= 1000; k++)
+    {
+        uint32_t tick = runToTick(scheduler, clock, 7);
+        uint32_t deadline = 1000 + k * PERIOD;
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(deadline, tick);
+        TEST_ASSERT_LESS_THAN_UINT32(deadline + 7, tick);
+    }
+    TEST_ASSERT_EQUAL(1001, scheduler.getTickCount());
+    TEST_ASSERT_EQUAL(0, scheduler.getMissedDeadlines());
+}
+
+// Work that varies in length but fits the period never shifts the grid
+static void test_work_jitter_does_not_drift()
+{
+    SimulatedClock clock;
+    FixedRateScheduler scheduler(&clock, PERIOD);
+    scheduler.start(false);
+
+    for (uint32_t k = 0; k < 5000; k++)
+    {
+        uint32_t tick = runToTick(scheduler, clock, 1);
+        TEST_ASSERT_EQUAL_UINT32(k * PERIOD, tick);
+
+        scheduler.beginTick();
+        clock.advance(100 + (k * 7919) % (PERIOD - 100));
+        scheduler.endTick();
+    }
+    TEST_ASSERT_EQUAL(0, scheduler.getOverruns());
+    TEST_ASSERT_EQUAL(0, scheduler.getMissedDeadlines());
+}
+
+// A stall skips the periods it covered instead of bursting to catch up
+static void test_missed_deadlines_skip_ahead()
+{
+    SimulatedClock clock;
+    FixedRateScheduler scheduler(&clock, PERIOD);
+    scheduler.start(false);
+    TEST_ASSERT_TRUE(scheduler.poll());
+
+    clock.set(3 * PERIOD + PERIOD / 2);
+    TEST_ASSERT_TRUE(scheduler.poll());
+    TEST_ASSERT_EQUAL(2, scheduler.getMissedDeadlines());
+    TEST_ASSERT_FALSE(scheduler.poll());
+    TEST_ASSERT_EQUAL_UINT32(PERIOD / 2, scheduler.microsUntilNextTick());
+
+    clock.set(4 * PERIOD);
+    TEST_ASSERT_TRUE(scheduler.poll());
+    TEST_ASSERT_EQUAL(2, scheduler.getMissedDeadlines());
+    TEST_ASSERT_EQUAL(3, scheduler.getTickCount());
+
+    // Exactly one period late is one missed deadline
+    clock.set(6 * PERIOD);
+    TEST_ASSERT_TRUE(scheduler.poll());
+    TEST_ASSERT_EQUAL(3, scheduler.getMissedDeadlines());
+}
+
+static void test_overrun_accounting()
+{
+    SimulatedClock clock;
+    FixedRateScheduler scheduler(&clock, PERIOD);
+    scheduler.start(false);
+
+    scheduler.beginTick();
+    clock.advance(PERIOD);
+    scheduler.endTick();
+    TEST_ASSERT_EQUAL(0, scheduler.getOverruns()); // A full period still fits
+
+    scheduler.beginTick();
+    clock.advance(PERIOD + 1);
+    scheduler.endTick();
+    TEST_ASSERT_EQUAL(1, scheduler.getOverruns());
+    TEST_ASSERT_EQUAL_UINT32(PERIOD + 1, scheduler.getLastDuration());
+
+    scheduler.beginTick();
+    clock.advance(300);
+    scheduler.endTick();
+    TEST_ASSERT_EQUAL(1, scheduler.getOverruns());
+    TEST_ASSERT_EQUAL_UINT32(300, scheduler.getLastDuration());
+    TEST_ASSERT_EQUAL_UINT32(PERIOD + 1, scheduler.getMaxDuration());
+
+    scheduler.resetStats();
+    TEST_ASSERT_EQUAL(0, scheduler.getOverruns());
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getMaxDuration());
+}
+
+// The overrun also costs the next deadline
+static void test_overrun_then_missed_deadline()
+{
+    SimulatedClock clock;
+    FixedRateScheduler scheduler(&clock, PERIOD);
+    scheduler.start(false);
+
+    TEST_ASSERT_TRUE(scheduler.poll());
+    scheduler.beginTick();
+    clock.advance(2 * PERIOD + 10);
+    scheduler.endTick();
+
+    TEST_ASSERT_TRUE(scheduler.poll());
+    TEST_ASSERT_EQUAL(1, scheduler.getOverruns());
+    TEST_ASSERT_EQUAL(1, scheduler.getMissedDeadlines());
+    TEST_ASSERT_EQUAL_UINT32(PERIOD - 10, scheduler.microsUntilNextTick());
+}
+
+// micros() wraps every ~71 minutes; the grid must run straight through
+static void test_clock_wraparound()
+{
+    SimulatedClock clock(0xFFFFFFFFu - 5 * PERIOD + 1);
+    FixedRateScheduler scheduler(&clock, PERIOD);
+    scheduler.start(false);
+    uint32_t start = clock.nowMicros();
+
+    for (uint32_t k = 0; k < 20; k++)
+    {
+        uint32_t tick = runToTick(scheduler, clock, 3);
+        TEST_ASSERT_LESS_THAN_UINT32(3, tick - (start + k * PERIOD));
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(PERIOD, scheduler.microsUntilNextTick());
+
+        scheduler.beginTick();
+        clock.advance(500);
+        scheduler.endTick();
+        TEST_ASSERT_EQUAL_UINT32(500, scheduler.getLastDuration());
+    }
+    TEST_ASSERT_EQUAL(0, scheduler.getMissedDeadlines());
+    TEST_ASSERT_EQUAL(0, scheduler.getOverruns());
+}
+
+static void test_stop_halts_ticks()
+{
+    SimulatedClock clock;
+    FixedRateScheduler scheduler(&clock, PERIOD);
+    scheduler.start(false);
+    scheduler.poll();
+    scheduler.stop();
+
+    clock.advance(10 * PERIOD);
+    TEST_ASSERT_FALSE(scheduler.poll());
+    TEST_ASSERT_EQUAL(1, scheduler.getTickCount());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_tick_is_immediate);
+    RUN_TEST(test_period_accuracy);
+    RUN_TEST(test_work_jitter_does_not_drift);
+    RUN_TEST(test_missed_deadlines_skip_ahead);
+    RUN_TEST(test_overrun_accounting);
+    RUN_TEST(test_overrun_then_missed_deadline);
+    RUN_TEST(test_clock_wraparound);
+    RUN_TEST(test_stop_halts_ticks);
+    return UNITY_END();
+}
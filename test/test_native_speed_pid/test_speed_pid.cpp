@@ -0,0 +1,190 @@
+// Closed-loop speed control against the simulated DC motor at
+// SPEED_PID_RATE_HZ: settling time and overshoot after a speed step,
+// steady-state error under a 30% load step, no overshoot once a long
+// saturation ends (anti-windup), and the duty staying in [0, maxOutput]
+#include "simulated_motor.h"
+#include "speed_pid.h"
+#include <unity.h>
+#include <stdlib.h>
+
+static const uint32_t PERIOD_US = 1000000UL / SPEED_PID_RATE_HZ;
+static const int TARGET_DUTY = 128;        // Feed-forward, as mapped; leaves headroom for the load
+static const uint32_t SETTLE_MS = 250;      // Five motor time constants, to within SETTLE_BAND
+static const uint32_t LOAD_SETTLE_MS = 400; // Recovery after the load step
+static const float SETTLE_BAND = 0.02f;
+static const float MAX_OVERSHOOT = 0.05f;
+static const float MAX_STEADY_ERROR = 0.01f;
+static const float LOAD_STEP = 0.3f;
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static int32_t speedForDuty(int duty)
+{
+    return (int32_t)duty * MOTOR_MAX_COUNTS_PER_SEC / MAX_SPEED;
+}
+
+// Motor, encoder differencing and controller, one step per PID period
+class SpeedLoop
+{
+private:
+    uint32_t nowUs;
+    int32_t lastCount;
+    int duty;
+
+public:
+    SimulatedDcMotor motor;
+    SpeedPid pid;
+
+    // Statistics of the last run()
+    float peak;
+    long settledMs; // Last entry into the band, -1 while outside
+    float speed;
+
+    SpeedLoop() : nowUs(0), lastCount(0), duty(0), peak(0.0f), settledMs(-1), speed(0.0f)
+    {
+        motor.advance(0, 0);
+    }
+
+    int getDuty() const { return duty; }
+
+    // Runs for ms, returns the speed at the end; records the peak and when
+    // the speed last entered the settling band
+    float run(uint32_t ms, int32_t setpoint, int feedForward)
+    {
+        peak = 0.0f;
+        settledMs = -1;
+        const float band = setpoint * SETTLE_BAND;
+        for (uint32_t t = PERIOD_US; t <= ms * 1000; t += PERIOD_US)
+        {
+            nowUs += PERIOD_US;
+            motor.advance(nowUs, duty);
+            int32_t count = motor.readCount();
+            int32_t measured = (int32_t)((int64_t)(count - lastCount) * 1000000 / PERIOD_US);
+            lastCount = count;
+
+            duty = pid.update(setpoint, measured, feedForward);
+            TEST_ASSERT_TRUE(duty >= 0 && duty <= MAX_SPEED);
+
+            speed = motor.getSpeed();
+            if (speed > peak)
+                peak = speed;
+            if (speed < setpoint - band || speed > setpoint + band)
+                settledMs = -1;
+            else if (settledMs < 0)
+                settledMs = (long)(t / 1000);
+        }
+        return speed;
+    }
+};
+
+static void test_step_settles_without_overshoot()
+{
+    SpeedLoop loop;
+    const int32_t setpoint = speedForDuty(TARGET_DUTY);
+    float speed = loop.run(1000, setpoint, TARGET_DUTY);
+
+    TEST_ASSERT_TRUE(loop.settledMs >= 0);
+    TEST_ASSERT_LESS_OR_EQUAL(SETTLE_MS, loop.settledMs);
+    TEST_ASSERT_LESS_OR_EQUAL(setpoint * (1.0f + MAX_OVERSHOOT), loop.peak);
+    TEST_ASSERT_FLOAT_WITHIN(setpoint * MAX_STEADY_ERROR, (float)setpoint, speed);
+}
+
+// Open loop sags by about the load; the controller trims it back
+static void test_load_step_steady_state_error()
+{
+    SpeedLoop open;
+    SpeedLoop closed;
+    const int32_t setpoint = speedForDuty(TARGET_DUTY);
+    open.run(1000, setpoint, TARGET_DUTY);
+    closed.run(1000, setpoint, TARGET_DUTY);
+
+    open.motor.setLoad(LOAD_STEP);
+    closed.motor.setLoad(LOAD_STEP);
+    SpeedPid none(0.0f, 0.0f, 0.0f); // Feed-forward only
+    open.pid = none;
+    float openSpeed = open.run(1500, setpoint, TARGET_DUTY);
+    float closedSpeed = closed.run(1500, setpoint, TARGET_DUTY);
+
+    TEST_ASSERT_LESS_THAN(setpoint * (1.0f - LOAD_STEP / 2), openSpeed);
+    TEST_ASSERT_FLOAT_WITHIN(setpoint * MAX_STEADY_ERROR, (float)setpoint, closedSpeed);
+    TEST_ASSERT_TRUE(closed.settledMs >= 0);
+    TEST_ASSERT_LESS_OR_EQUAL(LOAD_SETTLE_MS, closed.settledMs);
+}
+
+// Stalled by a heavy load for three seconds with full error, then freed:
+// the integrator held back during saturation, so the speed comes back to
+// the target overshooting no more than after a plain step
+static void test_no_overshoot_after_saturation()
+{
+    const int32_t setpoint = speedForDuty(TARGET_DUTY);
+    SpeedLoop fresh;
+    fresh.run(1000, setpoint, TARGET_DUTY);
+
+    SpeedLoop loop;
+    loop.motor.setLoad(0.95f);
+    loop.run(3000, setpoint, TARGET_DUTY);
+    TEST_ASSERT_EQUAL(MAX_SPEED, loop.getDuty());
+    TEST_ASSERT_LESS_OR_EQUAL(MAX_SPEED, loop.pid.getIntegral());
+
+    loop.motor.setLoad(0.0f);
+    float speed = loop.run(1500, setpoint, TARGET_DUTY);
+    TEST_ASSERT_LESS_OR_EQUAL(setpoint * (1.0f + MAX_OVERSHOOT), loop.peak);
+    TEST_ASSERT_LESS_OR_EQUAL(fresh.peak + setpoint * 0.01f, loop.peak);
+    TEST_ASSERT_LESS_OR_EQUAL(SETTLE_MS, loop.settledMs);
+    TEST_ASSERT_FLOAT_WITHIN(setpoint * MAX_STEADY_ERROR, (float)setpoint, speed);
+}
+
+// Same for a target above what the motor can reach, then a reachable one
+static void test_no_overshoot_after_unreachable_target()
+{
+    SpeedLoop loop;
+    loop.run(3000, MOTOR_MAX_COUNTS_PER_SEC * 2, MAX_SPEED);
+    TEST_ASSERT_EQUAL(MAX_SPEED, loop.getDuty());
+
+    const int32_t setpoint = speedForDuty(TARGET_DUTY);
+    loop.run(1500, setpoint, TARGET_DUTY);
+    TEST_ASSERT_TRUE(loop.settledMs >= 0);
+    TEST_ASSERT_LESS_OR_EQUAL(SETTLE_MS * 3, loop.settledMs);
+    TEST_ASSERT_FLOAT_WITHIN(setpoint * MAX_STEADY_ERROR, (float)setpoint, loop.speed);
+}
+
+static void test_output_clamped()
+{
+    SpeedPid pid;
+    TEST_ASSERT_EQUAL(MAX_SPEED, pid.update(MOTOR_MAX_COUNTS_PER_SEC, 0, MAX_SPEED * 2));
+    TEST_ASSERT_EQUAL(0, pid.update(0, MOTOR_MAX_COUNTS_PER_SEC, -MAX_SPEED));
+
+    SpeedPid small(SPEED_PID_KP, SPEED_PID_KI, SPEED_PID_KD, SPEED_PID_RATE_HZ, 100);
+    srand(7);
+    for (int i = 0; i < 100000; i++)
+    {
+        int32_t setpoint = rand() % (MOTOR_MAX_COUNTS_PER_SEC * 2) - MOTOR_MAX_COUNTS_PER_SEC / 2;
+        int32_t measured = rand() % (MOTOR_MAX_COUNTS_PER_SEC * 2) - MOTOR_MAX_COUNTS_PER_SEC / 2;
+        int feedForward = rand() % 400 - 100;
+        int duty = small.update(setpoint, measured, feedForward);
+        TEST_ASSERT_TRUE(duty >= 0 && duty <= 100);
+        TEST_ASSERT_TRUE(small.getIntegral() >= -100 && small.getIntegral() <= 100);
+    }
+
+    // At the target with no feed-forward and an empty integrator: zero
+    small.reset();
+    TEST_ASSERT_EQUAL(0, small.update(1000, 1000, 0));
+    TEST_ASSERT_EQUAL(0, small.getIntegral());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_step_settles_without_overshoot);
+    RUN_TEST(test_load_step_steady_state_error);
+    RUN_TEST(test_no_overshoot_after_saturation);
+    RUN_TEST(test_no_overshoot_after_unreachable_target);
+    RUN_TEST(test_output_clamped);
+    return UNITY_END();
+}
@@ -0,0 +1,300 @@
+// Binary telemetry framing: COBS round trips (zero runs, blocks of 254
+// and more bytes), CRC-16/CCITT-FALSE known answers, frame encode/decode
+// and rejection, and the stream decoder resyncing after a damaged frame
+// or text between frames
+#include "telemetry.h"
+#include "cobs.h"
+#include "crc.h"
+#include <unity.h>
+#include <string.h>
+
+static const size_t MAX_LENGTH = 1024;
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// Encodes, checks the output has no zero and fits the bound, decodes
+static void assertRoundTrip(const uint8_t *data, size_t length)
+{
+    static uint8_t encoded[MAX_LENGTH + MAX_LENGTH / 254 + 1];
+    static uint8_t decoded[MAX_LENGTH + 1];
+
+    size_t encodedLength = cobsEncode(data, length, encoded);
+    TEST_ASSERT_LESS_OR_EQUAL(cobsMaxEncodedSize(length), encodedLength);
+    TEST_ASSERT_GREATER_THAN(length, encodedLength);
+    for (size_t i = 0; i < encodedLength; i++)
+    {
+        TEST_ASSERT_NOT_EQUAL(0, encoded[i]);
+    }
+
+    TEST_ASSERT_EQUAL(length, cobsDecode(encoded, encodedLength, decoded));
+    TEST_ASSERT_EQUAL_MEMORY(data, decoded, length);
+
+    TEST_ASSERT_EQUAL(length, cobsDecodeInPlace(encoded, encodedLength));
+    TEST_ASSERT_EQUAL_MEMORY(data, encoded, length);
+}
+
+static void test_cobs_known_encodings()
+{
+    const uint8_t zero[] = {0x00};
+    const uint8_t twoZeros[] = {0x00, 0x00};
+    const uint8_t mixed[] = {0x11, 0x22, 0x00, 0x33};
+    const uint8_t trailing[] = {0x11, 0x00};
+    uint8_t out[8];
+
+    TEST_ASSERT_EQUAL(2, cobsEncode(zero, 1, out));
+    TEST_ASSERT_EQUAL_HEX8(0x01, out[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, out[1]);
+
+    TEST_ASSERT_EQUAL(3, cobsEncode(twoZeros, 2, out));
+    TEST_ASSERT_EQUAL_HEX8(0x01, out[2]);
+
+    const uint8_t mixedWire[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+    TEST_ASSERT_EQUAL(5, cobsEncode(mixed, 4, out));
+    TEST_ASSERT_EQUAL_MEMORY(mixedWire, out, 5);
+
+    const uint8_t trailingWire[] = {0x02, 0x11, 0x01};
+    TEST_ASSERT_EQUAL(3, cobsEncode(trailing, 2, out));
+    TEST_ASSERT_EQUAL_MEMORY(trailingWire, out, 3);
+
+    TEST_ASSERT_EQUAL(1, cobsEncode(zero, 0, out));
+    TEST_ASSERT_EQUAL_HEX8(0x01, out[0]);
+}
+
+static void test_cobs_zero_runs()
+{
+    uint8_t data[MAX_LENGTH];
+    memset(data, 0, sizeof(data));
+    for (size_t length = 1; length <= 600; length += 7)
+    {
+        assertRoundTrip(data, length);
+    }
+
+    // Zeros at the ends and in runs between data
+    for (size_t i = 0; i < 300; i++)
+    {
+        data[i] = (i / 5) % 3 == 0 ? 0 : (uint8_t)(i | 1);
+    }
+    assertRoundTrip(data, 300);
+}
+
+// Around the 254-byte block limit: a full block carries no implied zero
+static void test_cobs_long_blocks()
+{
+    uint8_t data[MAX_LENGTH];
+    for (size_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(i % 255 + 1); // Never zero
+    }
+
+    const size_t lengths[] = {253, 254, 255, 508, 509, 1000, MAX_LENGTH};
+    for (size_t length : lengths)
+    {
+        assertRoundTrip(data, length);
+    }
+
+    // 254 bytes fill one block: 0xFF, the data, then an empty final block
+    uint8_t encoded[MAX_LENGTH + MAX_LENGTH / 254 + 1];
+    TEST_ASSERT_EQUAL(256, cobsEncode(data, 254, encoded));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, encoded[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, encoded[255]);
+
+    // A zero right after a full block, and at the end of one
+    data[254] = 0;
+    assertRoundTrip(data, 255);
+    assertRoundTrip(data, 300);
+    data[253] = 0;
+    assertRoundTrip(data, 254);
+    assertRoundTrip(data, 255);
+}
+
+// A block running past the end, or a zero inside one
+static void test_cobs_rejects_malformed()
+{
+    uint8_t out[16];
+    const uint8_t embeddedZero[] = {0x03, 0x11, 0x00};
+    const uint8_t shortBlock[] = {0x05, 0x11, 0x22};
+    TEST_ASSERT_EQUAL(0, cobsDecode(embeddedZero, 3, out));
+    TEST_ASSERT_EQUAL(0, cobsDecode(shortBlock, 3, out));
+}
+
+static void test_crc16_known_answers()
+{
+    const uint8_t check[] = "123456789";
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc16(check, 9));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, crc16(check, 0));
+    TEST_ASSERT_EQUAL_HEX16(0xB915, crc16((const uint8_t *)"A", 1));
+
+    const uint8_t zeros[4] = {0, 0, 0, 0};
+    const uint8_t ones[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+    TEST_ASSERT_EQUAL_HEX16(0x84C0, crc16(zeros, 4));
+    TEST_ASSERT_EQUAL_HEX16(0x1D0F, crc16(ones, 4));
+
+    // Continuing a checksum over pieces gives the same result
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc16(check + 4, 5, crc16(check, 4)));
+
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32(check, 9));
+}
+
+static TelemetryFrame makeFrame(uint16_t sequence)
+{
+    TelemetryFrame frame;
+    frame.flags = TELEMETRY_FLAG_COMMAND_CHANGED;
+    frame.sequence = sequence;
+    frame.timestamp = 0x00010000u * sequence; // Zero bytes in the payload
+    frame.rawX = 2048;
+    frame.rawY = 0;
+    frame.x = -500;
+    frame.y = 499;
+    frame.direction = 2;
+    frame.speedPercent = 100;
+    frame.speedPWM = 255;
+    frame.dropped = 0;
+    frame.loopLastUs = 123;
+    frame.loopMaxUs = 0xFFFF;
+    frame.overruns = 0;
+    return frame;
+}
+
+static void assertSameFrame(const TelemetryFrame &expected, const TelemetryFrame &actual)
+{
+    TEST_ASSERT_EQUAL_UINT8(expected.flags, actual.flags);
+    TEST_ASSERT_EQUAL_UINT16(expected.sequence, actual.sequence);
+    TEST_ASSERT_EQUAL_UINT32(expected.timestamp, actual.timestamp);
+    TEST_ASSERT_EQUAL_UINT16(expected.rawX, actual.rawX);
+    TEST_ASSERT_EQUAL_UINT16(expected.rawY, actual.rawY);
+    TEST_ASSERT_EQUAL_INT16(expected.x, actual.x);
+    TEST_ASSERT_EQUAL_INT16(expected.y, actual.y);
+    TEST_ASSERT_EQUAL_UINT8(expected.direction, actual.direction);
+    TEST_ASSERT_EQUAL_UINT8(expected.speedPercent, actual.speedPercent);
+    TEST_ASSERT_EQUAL_UINT8(expected.speedPWM, actual.speedPWM);
+    TEST_ASSERT_EQUAL_UINT8(expected.dropped, actual.dropped);
+    TEST_ASSERT_EQUAL_UINT16(expected.loopLastUs, actual.loopLastUs);
+    TEST_ASSERT_EQUAL_UINT16(expected.loopMaxUs, actual.loopMaxUs);
+    TEST_ASSERT_EQUAL_UINT16(expected.overruns, actual.overruns);
+}
+
+static void test_frame_round_trip()
+{
+    uint8_t wire[TELEMETRY_WIRE_SIZE];
+    TelemetryFrame sent = makeFrame(7);
+    size_t length = encodeTelemetryFrame(sent, wire);
+    TEST_ASSERT_EQUAL(TELEMETRY_WIRE_SIZE, length);
+    TEST_ASSERT_EQUAL_HEX8(0, wire[0]);
+    TEST_ASSERT_EQUAL_HEX8(0, wire[length - 1]);
+
+    TelemetryFrame received;
+    TEST_ASSERT_EQUAL(TELEMETRY_OK, decodeTelemetryFrame(wire + 1, length - 2, received));
+    assertSameFrame(sent, received);
+}
+
+// Any flipped bit is caught, as a CRC or framing error
+static void test_frame_rejects_corruption()
+{
+    uint8_t wire[TELEMETRY_WIRE_SIZE];
+    uint8_t damaged[TELEMETRY_WIRE_SIZE];
+    size_t length = encodeTelemetryFrame(makeFrame(1), wire);
+    TelemetryFrame received;
+
+    for (size_t byte = 1; byte < length - 1; byte++)
+    {
+        for (int bit = 0; bit < 8; bit++)
+        {
+            memcpy(damaged, wire, length);
+            damaged[byte] ^= (uint8_t)(1 << bit);
+            TEST_ASSERT_NOT_EQUAL(TELEMETRY_OK, decodeTelemetryFrame(damaged + 1, length - 2, received));
+        }
+    }
+
+    TEST_ASSERT_EQUAL(TELEMETRY_BAD_LENGTH, decodeTelemetryFrame(wire + 1, 0, received));
+    TEST_ASSERT_EQUAL(TELEMETRY_BAD_LENGTH, decodeTelemetryFrame(wire, TELEMETRY_WIRE_SIZE + 1, received));
+    TEST_ASSERT_EQUAL(TELEMETRY_BAD_FRAMING, decodeTelemetryFrame(wire + 1, length - 4, received));
+    TEST_ASSERT_EQUAL_STRING("CRC mismatch", telemetryStatusName(TELEMETRY_BAD_CRC));
+}
+
+// Feeds bytes, collecting the sequence numbers of decoded frames
+static int feed(TelemetryStreamDecoder &decoder, const uint8_t *bytes, size_t length, uint16_t *sequences)
+{
+    int count = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        TelemetryFrame frame;
+        if (decoder.push(bytes[i], frame))
+            sequences[count++] = frame.sequence;
+    }
+    return count;
+}
+
+static void test_stream_resyncs_after_corrupted_frame()
+{
+    uint8_t stream[TELEMETRY_WIRE_SIZE * 5];
+    size_t length = 0;
+    for (uint16_t sequence = 0; sequence < 5; sequence++)
+    {
+        length += encodeTelemetryFrame(makeFrame(sequence), stream + length);
+    }
+
+    // Damage frame 1 and cut frame 3 short (bytes lost on the line)
+    stream[TELEMETRY_WIRE_SIZE + 10] ^= 0x40;
+    size_t cut = 3 * TELEMETRY_WIRE_SIZE + 12;
+    memmove(stream + cut, stream + cut + 5, length - cut - 5);
+    length -= 5;
+
+    TelemetryStreamDecoder decoder;
+    uint16_t sequences[8];
+    TEST_ASSERT_EQUAL(3, feed(decoder, stream, length, sequences));
+    TEST_ASSERT_EQUAL_UINT16(0, sequences[0]);
+    TEST_ASSERT_EQUAL_UINT16(2, sequences[1]);
+    TEST_ASSERT_EQUAL_UINT16(4, sequences[2]);
+    TEST_ASSERT_EQUAL_UINT32(3, decoder.getFrames());
+    TEST_ASSERT_EQUAL_UINT32(2, decoder.getRejected());
+}
+
+// Joining mid-frame, text between frames, and a run of garbage longer
+// than any frame: each is dropped up to the next delimiter
+static void test_stream_skips_text_and_garbage()
+{
+    uint8_t stream[512];
+    size_t length = 0;
+    uint8_t wire[TELEMETRY_WIRE_SIZE];
+
+    size_t frameLength = encodeTelemetryFrame(makeFrame(10), wire);
+    memcpy(stream, wire + 9, frameLength - 9); // Tail of a frame
+    length += frameLength - 9;
+
+    const char text[] = "Calibration complete\r\n";
+    memcpy(stream + length, text, sizeof(text) - 1);
+    length += sizeof(text) - 1;
+    length += encodeTelemetryFrame(makeFrame(11), stream + length);
+
+    memset(stream + length, 'x', 100);
+    length += 100;
+    length += encodeTelemetryFrame(makeFrame(12), stream + length);
+
+    TelemetryStreamDecoder decoder;
+    uint16_t sequences[8];
+    TEST_ASSERT_EQUAL(2, feed(decoder, stream, length, sequences));
+    TEST_ASSERT_EQUAL_UINT16(11, sequences[0]);
+    TEST_ASSERT_EQUAL_UINT16(12, sequences[1]);
+    TEST_ASSERT_EQUAL_UINT32(3, decoder.getRejected()); // Tail, text, garbage
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_cobs_known_encodings);
+    RUN_TEST(test_cobs_zero_runs);
+    RUN_TEST(test_cobs_long_blocks);
+    RUN_TEST(test_cobs_rejects_malformed);
+    RUN_TEST(test_crc16_known_answers);
+    RUN_TEST(test_frame_round_trip);
+    RUN_TEST(test_frame_rejects_corruption);
+    RUN_TEST(test_stream_resyncs_after_corrupted_frame);
+    RUN_TEST(test_stream_skips_text_and_garbage);
+    return UNITY_END();
+}
@@ -0,0 +1,50 @@
+// Host benchmark of the speed response curves: the cost of one table
+// evaluation against map() and the expo curve in float. The correctness
+// checks (monotonic, end points, table error, profile switching) live in
+// test/test_native_response_curve. Build from the project root:
+//
+//   g++ -std=gnu++11 -O2 -Ilib/config -Ilib/mapping -o curve_bench tools/curve_bench.cpp
+//       lib/mapping/response_curve.cpp lib/mapping/mapping_kernel.cpp
+//   ./curve_bench
+
+#include "response_curve.h"
+#include "mapping_kernel.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+static const int SPAN = MAX_OUTPUT - SPEED_DEAD_ZONE;
+
+template <class Fn>
+static double timeEval(Fn fn, long &checksum)
+{
+    const long samples = 50000000;
+    checksum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < samples; i++)
+    {
+        checksum += fn(SPEED_DEAD_ZONE + (int)(i % (SPAN + 1)));
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / samples;
+}
+
+int main()
+{
+    static ResponseCurveSet curves;
+    curves.begin(SPEED_CURVE_PROFILES, SPEED_CURVE_COUNT, SPEED_DEAD_ZONE, MAX_OUTPUT, MIN_MOTOR_PERCENT, 100);
+    curves.select(2); // Spline: the table costs the same for every profile
+    const float expo = SPEED_CURVE_EXPO_PERCENT / 100.0f;
+
+    long sum;
+    printf("Per-sample cost on this host:\n");
+    double ns = timeEval([](int y) { return (int)arduinoMap(y, SPEED_DEAD_ZONE, MAX_OUTPUT, MIN_MOTOR_PERCENT, 100); }, sum);
+    printf("  linear map() reference   %5.2f ns (checksum %ld)\n", ns, sum);
+    ns = timeEval([&](int y) {
+        float t = (float)(y - SPEED_DEAD_ZONE) / SPAN;
+        return (int)lroundf(MIN_MOTOR_PERCENT + (100 - MIN_MOTOR_PERCENT) * ((1.0f - expo) * t + expo * t * t * t));
+    }, sum);
+    printf("  expo in float            %5.2f ns (checksum %ld)\n", ns, sum);
+    ns = timeEval([&](int y) { return curves.evaluate(y); }, sum);
+    printf("  curve table              %5.2f ns (checksum %ld)\n", ns, sum);
+    return 0;
+}
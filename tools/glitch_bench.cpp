@@ -0,0 +1,119 @@
+// Host benchmark of the glitch filter. Runs a rest-and-sweep ADC trace
+// with injected single and double spikes through GlitchFilter at 3, 5 and
+// 7 taps and through a median that re-sorts its window every sample, and
+// reports ns per sample plus what each filter rejected and clipped. Build
+// from the project root:
+//
+//   g++ -std=gnu++11 -O2 -Ilib/config -Ilib/filters -o glitch_bench tools/glitch_bench.cpp
+//   ./glitch_bench [samples, default 20000000]
+//
+// Exits non-zero if a filter's output differs from the sorted reference.
+
+#include "glitch_filter.h"
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const int TRACE_LENGTH = 1 << 16; // Input pattern length, repeated
+static int trace[TRACE_LENGTH];
+
+// Rest noise for a quarter of the trace, then triangle sweeps; a spike to
+// a rail every 997 samples, a double spike every 4999
+static void buildTrace()
+{
+    for (int i = 0; i < TRACE_LENGTH; i++)
+    {
+        int noise = (int)((i * 2654435761u) >> 27) - 16;
+        int value = 2048 + noise;
+        if (i >= TRACE_LENGTH / 4)
+        {
+            int phase = i % 4096;
+            value = 200 + (phase < 2048 ? phase : 4095 - phase) * 3700 / 2048 + noise;
+        }
+        if (i % 997 == 0 || i % 4999 == 0 || i % 4999 == 1)
+            value = (i & 1) ? 4095 : 0;
+        trace[i] = value;
+    }
+}
+
+// Same median and step limit, but sorts a copy of the window each sample
+template <int Taps>
+class SortingGlitchFilter
+{
+private:
+    int window[Taps];
+    int index;
+    int last;
+    bool primed;
+
+public:
+    SortingGlitchFilter() : index(0), last(0), primed(false) {}
+
+    int update(int sample)
+    {
+        if (!primed)
+        {
+            std::fill(window, window + Taps, sample);
+            last = sample;
+            primed = true;
+            return sample;
+        }
+
+        window[index] = sample;
+        index = (index + 1 == Taps) ? 0 : index + 1;
+        int sorted[Taps];
+        std::copy(window, window + Taps, sorted);
+        std::sort(sorted, sorted + Taps);
+
+        int output = sorted[Taps / 2];
+        if (output - last > GLITCH_MAX_STEP)
+            output = last + GLITCH_MAX_STEP;
+        else if (last - output > GLITCH_MAX_STEP)
+            output = last - GLITCH_MAX_STEP;
+        last = output;
+        return output;
+    }
+};
+
+template <class Filter>
+static double timeFilter(Filter &filter, long samples, long &checksum)
+{
+    checksum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < samples; i++)
+    {
+        checksum += filter.update(trace[i & (TRACE_LENGTH - 1)]);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / samples;
+}
+
+template <int Taps>
+static bool run(long samples)
+{
+    GlitchFilter<Taps> filter;
+    SortingGlitchFilter<Taps> reference;
+    long sum;
+    long referenceSum;
+    double ns = timeFilter(filter, samples, sum);
+    double referenceNs = timeFilter(reference, samples, referenceSum);
+
+    printf("%4d %10.2f %10.2f %12lu %12lu\n", Taps, ns, referenceNs, filter.getRejected(), filter.getClipped());
+    if (sum != referenceSum)
+    {
+        printf("FAIL %d taps: output differs from the sorted reference\n", Taps);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    long samples = argc > 1 ? atol(argv[1]) : 20000000;
+    buildTrace();
+
+    printf("%ld samples, max step %d, outlier threshold %d\n", samples, GLITCH_MAX_STEP, GLITCH_OUTLIER_THRESHOLD);
+    printf("taps   ns/sample  sorting ns     rejected      clipped\n");
+    bool ok = run<3>(samples) && run<5>(samples) && run<7>(samples);
+    return ok ? 0 : 1;
+}
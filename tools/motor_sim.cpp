@@ -0,0 +1,111 @@
+// Host run of the closed-loop speed controller against the simulated DC
+// motor. Steps the target speed, adds a load halfway through, and reports
+// overshoot, settling time (to within 2%), the steady-state error against
+// open-loop drive, and the CPU cost of one PID step. Build from the
+// project root:
+//
+//   g++ -std=gnu++11 -O2 -Ilib/config -Ilib/motor -o motor_sim tools/motor_sim.cpp
+//       lib/motor/speed_pid.cpp lib/motor/simulated_motor.cpp
+//   ./motor_sim [load fraction, default 0.15] > trace.csv
+//
+// The trace (time, target, speed, duty) goes to stdout, the summary to
+// stderr.
+
+#include "simulated_motor.h"
+#include "speed_pid.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const uint32_t PERIOD_US = 1000000UL / SPEED_PID_RATE_HZ;
+static const uint32_t PHASE_US = 1500000; // Unloaded, then loaded
+static const int TARGET_DUTY = 180;        // Feed-forward, as mapped
+
+struct PhaseResult
+{
+    float overshoot; // Percent of target
+    long settleMs;   // -1 if never within the band
+    float finalError; // Percent of target
+};
+
+static PhaseResult runPhase(SimulatedDcMotor &motor, SpeedPid *pid, uint32_t &nowUs, int32_t &lastCount,
+                            bool trace)
+{
+    const int32_t setpoint = (int32_t)TARGET_DUTY * MOTOR_MAX_COUNTS_PER_SEC / MAX_SPEED;
+    const float band = setpoint * 0.02f;
+    PhaseResult result = {0.0f, -1, 0.0f};
+    uint32_t start = nowUs;
+    int duty = TARGET_DUTY;
+    float speed = 0.0f;
+
+    for (uint32_t t = 0; t < PHASE_US; t += PERIOD_US)
+    {
+        motor.advance(nowUs + PERIOD_US, duty);
+        nowUs += PERIOD_US;
+
+        int32_t count = motor.readCount();
+        int32_t measured = (int32_t)((int64_t)(count - lastCount) * 1000000 / PERIOD_US);
+        lastCount = count;
+        speed = motor.getSpeed();
+
+        duty = pid != nullptr ? pid->update(setpoint, measured, TARGET_DUTY) : TARGET_DUTY;
+
+        float over = (speed - setpoint) * 100.0f / setpoint;
+        if (over > result.overshoot)
+            result.overshoot = over;
+        if (speed < setpoint - band || speed > setpoint + band)
+            result.settleMs = -1;
+        else if (result.settleMs < 0)
+            result.settleMs = (long)((nowUs - start) / 1000);
+
+        if (trace)
+            printf("%lu,%ld,%.0f,%d\n", (unsigned long)(nowUs / 1000), (long)setpoint, speed, duty);
+    }
+
+    result.finalError = (speed - setpoint) * 100.0f / setpoint;
+    return result;
+}
+
+static void report(const char *name, const PhaseResult &result)
+{
+    fprintf(stderr, "  %-16s overshoot %5.1f%%  settled %5ld ms  final error %6.2f%%\n", name, result.overshoot,
+            result.settleMs, result.finalError);
+}
+
+int main(int argc, char **argv)
+{
+    float load = argc > 1 ? (float)atof(argv[1]) : 0.15f;
+    printf("time_ms,target,speed,duty\n");
+
+    for (int closed = 0; closed < 2; closed++)
+    {
+        SimulatedDcMotor motor;
+        SpeedPid pid;
+        uint32_t nowUs = 0;
+        int32_t lastCount = 0;
+        motor.advance(0, 0);
+
+        SpeedPid *controller = closed ? &pid : nullptr;
+        fprintf(stderr, "%s, target %d duty (%ld counts/s), load %.2f after %lu ms:\n",
+                closed ? "Closed loop" : "Open loop", TARGET_DUTY,
+                (long)TARGET_DUTY * MOTOR_MAX_COUNTS_PER_SEC / MAX_SPEED, load, (unsigned long)(PHASE_US / 1000));
+
+        report("step", runPhase(motor, controller, nowUs, lastCount, closed));
+        motor.setLoad(load);
+        report("load", runPhase(motor, controller, nowUs, lastCount, closed));
+    }
+
+    // Cost of one controller step, the loop kept from being folded away
+    SpeedPid pid;
+    const int steps = 10000000;
+    volatile int32_t measured = 5000;
+    int sink = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; i++)
+    {
+        sink += pid.update(5120, measured + (i & 63), 180);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "PID step: %.1f ns on this host (checksum %d)\n", ns / steps, sink & 0xFF);
+    return 0;
+}
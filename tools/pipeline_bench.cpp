@@ -0,0 +1,65 @@
+// Host check of the composed input pipeline against the original fixed
+// code path (both in pipeline_reference.h). Both run the requested number
+// of ticks (rest noise, sweeps, spikes) from raw ADC codes to motor
+// command. The tool fails on the first tick where the axis values or the
+// command differ, then times the same ticks on each. test_native_pipeline
+// runs the same comparison under pio test. Build from the project root:
+//
+//   g++ -std=gnu++11 -O2 -Ilib/config -Ilib/joystick -Ilib/mapping -Ilib/filters -Ilib/control_mapper
+//       -o pipeline_bench tools/pipeline_bench.cpp lib/mapping/mapping_kernel.cpp lib/mapping/response_curve.cpp
+//   ./pipeline_bench [ticks, default 1000000]
+//
+// Repeat with -DFILTER_TYPE=... or -DMAPPING_KERNEL=... to cover the other
+// default compositions. The firmware is built with -Os; at -O2 GCC keeps
+// the short per-axis loops rolled, which shows up as a few ns per tick.
+
+#include "pipeline_reference.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+template <class Path>
+static double timePath(const int input[][2], long ticks, long &checksum)
+{
+    static Path path; // LUT kernel tables kept off the stack
+    TickResult result;
+    checksum = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ticks; i++)
+    {
+        const int *raw = input[i % INPUT_TICKS];
+        path.tick(raw[0], raw[1], result);
+        checksum += result.axis[0] + result.command.speedPWM;
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ticks;
+}
+
+int main(int argc, char **argv)
+{
+    long ticks = argc > 1 ? atol(argv[1]) : 1000000;
+    static int input[INPUT_TICKS][2];
+    buildInput(input);
+
+    // Equivalence over the same ticks that are timed, so the filters see
+    // the pattern warm as well as cold
+    static OriginalPath original;
+    static ComposedPath composed;
+    TickResult expected, actual;
+    long mismatch = firstMismatch(input, ticks, original, composed, expected, actual);
+    if (mismatch >= 0)
+    {
+        printf("MISMATCH at tick %ld: original %d,%d -> %d/%d%%, composed %d,%d -> %d/%d%%\n", mismatch,
+               expected.axis[0], expected.axis[1], (int)expected.command.direction, expected.command.speedPercent,
+               actual.axis[0], actual.axis[1], (int)actual.command.direction, actual.command.speedPercent);
+        return 1;
+    }
+    printf("Equivalent over %ld ticks\n", ticks);
+
+    long originalSum, composedSum;
+    double originalNs = timePath<OriginalPath>(input, ticks, originalSum);
+    double composedNs = timePath<ComposedPath>(input, ticks, composedSum);
+    printf("original  %6.1f ns/tick (checksum %ld)\n", originalNs, originalSum);
+    printf("composed  %6.1f ns/tick (checksum %ld)\n", composedNs, composedSum);
+    return originalSum == composedSum ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+#ifndef PIPELINE_REFERENCE_H
+#define PIPELINE_REFERENCE_H
+
+// The pre-policy input path and the default composition side by side, with
+// a shared input pattern, for tools/pipeline_bench.cpp and the
+// test_native_pipeline suite. Header-only so both build it as they are.
+
+#include "axis_pipeline.h"
+#include "command_mapping.h"
+#include <stdlib.h>
+
+static const int INPUT_TICKS = 8192; // Input pattern length, repeated
+static const int CAL_MIN[2] = {310, 250};
+static const int CAL_MAX[2] = {3890, 3810};
+static const int CAL_CENTER[2] = {2010, 2100};
+
+struct TickResult
+{
+    int axis[2];
+    SimpleMotorCommand command;
+};
+
+// The joystick read() and SimpleControlMapper::processInput() stages as
+// they were before the policies, kept verbatim for comparison (the speed
+// curve aside, which both paths take from the response curve engine)
+class OriginalPath
+{
+private:
+    AxisMapper xAxisMap, yAxisMap;
+    GlitchFilter<GLITCH_MEDIAN_TAPS> xGlitch, yGlitch;
+    AxisFilter xFilter, yFilter;
+    AlphaBetaTracker xTracker, yTracker;
+    NoiseEstimator<NOISE_WINDOW_SAMPLES> xNoise, yNoise;
+    float xNoiseScale, yNoiseScale;
+    ResponseCurveSet speedCurves;
+    SpeedMapper speedMapper;
+
+public:
+    OriginalPath()
+    {
+        speedCurves.begin(SPEED_CURVE_PROFILES, SPEED_CURVE_COUNT, SPEED_DEAD_ZONE, MAX_OUTPUT, MIN_MOTOR_PERCENT, 100);
+        speedCurves.select(SPEED_CURVE_DEFAULT);
+        xAxisMap.build(CAL_MIN[0], CAL_MAX[0], CAL_CENTER[0]);
+        yAxisMap.build(CAL_MIN[1], CAL_MAX[1], CAL_CENTER[1]);
+        xNoiseScale = (float)(MAX_OUTPUT - MIN_OUTPUT) / (CAL_MAX[0] - CAL_MIN[0]);
+        yNoiseScale = (float)(MAX_OUTPUT - MIN_OUTPUT) / (CAL_MAX[1] - CAL_MIN[1]);
+    }
+
+    void tick(int xRaw, int yRaw, TickResult &result)
+    {
+        xRaw = xGlitch.update(xRaw);
+        yRaw = yGlitch.update(yRaw);
+
+        int xMapped = xAxisMap.map(xRaw);
+        int yMapped = yAxisMap.map(yRaw);
+
+        if (abs(xMapped) < DEAD_ZONE_PERCENT)
+        {
+            xNoise.update((float)xRaw);
+            if (xNoise.isValid())
+                xFilter.setNoise(xNoise.getStdDev() * xNoiseScale);
+        }
+        if (abs(yMapped) < DEAD_ZONE_PERCENT)
+        {
+            yNoise.update((float)yRaw);
+            if (yNoise.isValid())
+                yFilter.setNoise(yNoise.getStdDev() * yNoiseScale);
+        }
+
+        int xSmooth, ySmooth, vy = 0;
+        if (TRACKER_ENABLED)
+        {
+            xSmooth = xTracker.update(xMapped);
+            ySmooth = yTracker.update(yMapped);
+            xSmooth = xSmooth < MIN_OUTPUT ? MIN_OUTPUT : (xSmooth > MAX_OUTPUT ? MAX_OUTPUT : xSmooth);
+            ySmooth = ySmooth < MIN_OUTPUT ? MIN_OUTPUT : (ySmooth > MAX_OUTPUT ? MAX_OUTPUT : ySmooth);
+            vy = (int)yTracker.getVelocity();
+        }
+        else
+        {
+            xSmooth = xFilter.update(xMapped);
+            ySmooth = yFilter.update(yMapped);
+        }
+
+        int x = (abs(xSmooth) < DEAD_ZONE_PERCENT) ? 0 : xSmooth;
+        int y = (abs(ySmooth) < DEAD_ZONE_PERCENT) ? 0 : ySmooth;
+        result.axis[0] = x;
+        result.axis[1] = y;
+
+        SimpleMotorCommand &command = result.command;
+        if (abs(x) < DIRECTION_DEAD_ZONE)
+            command.direction = MOTOR_STOP;
+        else if (x > 0)
+            command.direction = MOTOR_FORWARD;
+        else
+            command.direction = MOTOR_BACKWARD;
+        command.speedPercent = y < SPEED_DEAD_ZONE ? 0 : speedCurves.evaluate(y);
+        command.speedPWM = speedMapper.percentToPWM(command.speedPercent);
+        command.speedRate = vy;
+    }
+};
+
+// The default composition, driven the way JoystickController::read() and
+// SimpleControlMapper::processInput() drive it
+class ComposedPath
+{
+private:
+    AxisPipeline<2> pipeline;
+    DefaultCommandMapping mapping;
+
+public:
+    ComposedPath() { pipeline.rebuild(CAL_MIN, CAL_MAX, CAL_CENTER); }
+
+    void tick(int xRaw, int yRaw, TickResult &result)
+    {
+        int raw[2] = {xRaw, yRaw};
+        int mapped[2], velocity[2];
+
+        pipeline.rejectGlitches(raw);
+        pipeline.map(raw, mapped);
+        pipeline.trackNoise(raw, mapped);
+        pipeline.smooth(mapped, result.axis, velocity);
+        pipeline.applyDeadZone(result.axis);
+        pipeline.applyCurve(result.axis);
+        mapping.map(result.axis, velocity, result.command);
+    }
+};
+
+// Rest noise around the center, then sweeps with a spike now and then
+static void buildInput(int input[][2])
+{
+    for (int t = 0; t < INPUT_TICKS; t++)
+    {
+        for (int axis = 0; axis < 2; axis++)
+        {
+            int noise = (int)((t * 2654435761u + axis * 40503u) >> 27) - 16;
+            int phase = (t * 5 + axis * 1500) % 4096;
+            int sweep = phase < 2048 ? phase * 2 : (4095 - phase) * 2;
+
+            if (t % 4096 < 1024)
+                input[t][axis] = CAL_CENTER[axis] + noise;
+            else if ((t * 13 + axis) % 701 == 0)
+                input[t][axis] = (t & 1) ? ADC_MAX_VALUE : 0;
+            else
+                input[t][axis] = sweep + noise < 0 ? 0 : (sweep + noise > ADC_MAX_VALUE ? ADC_MAX_VALUE : sweep + noise);
+        }
+    }
+}
+
+static bool sameResult(const TickResult &a, const TickResult &b)
+{
+    return a.axis[0] == b.axis[0] && a.axis[1] == b.axis[1] && a.command.direction == b.command.direction &&
+           a.command.speedPercent == b.command.speedPercent && a.command.speedPWM == b.command.speedPWM &&
+           a.command.speedRate == b.command.speedRate;
+}
+
+// Runs both paths over ticks of the repeated pattern. Returns the first
+// tick where they differ, or -1; expected/actual hold the last results.
+static long firstMismatch(const int input[][2], long ticks, OriginalPath &original, ComposedPath &composed,
+                          TickResult &expected, TickResult &actual)
+{
+    for (long i = 0; i < ticks; i++)
+    {
+        const int *raw = input[i % INPUT_TICKS];
+        original.tick(raw[0], raw[1], expected);
+        composed.tick(raw[0], raw[1], actual);
+        if (!sameResult(expected, actual))
+            return i;
+    }
+    return -1;
+}
+
+#endif
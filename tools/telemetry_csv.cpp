@@ -0,0 +1,52 @@
+// Host decoder for binary telemetry captures (firmware built with
+// -DTELEMETRY_MODE=TELEMETRY_BINARY). Reads a raw serial capture and
+// writes CSV to stdout; text lines mixed into the capture (boot messages)
+// fail the CRC and are skipped. Build from the project root:
+//
+//   g++ -std=gnu++11 -Ilib/telemetry -Ilib/checksum -o telemetry_csv tools/telemetry_csv.cpp
+//       lib/telemetry/telemetry.cpp lib/telemetry/cobs.cpp lib/checksum/crc.cpp
+//   ./telemetry_csv capture.bin > capture.csv
+
+#include "telemetry.h"
+#include <stdio.h>
+
+int main(int argc, char **argv)
+{
+    FILE *in = argc > 1 ? fopen(argv[1], "rb") : stdin;
+    if (in == nullptr)
+    {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    printf("sequence,timestamp_ms,flags,raw_x,raw_y,x,y,direction,speed_percent,speed_pwm,"
+           "loop_last_us,loop_max_us,overruns,dropped\n");
+
+    TelemetryStreamDecoder decoder;
+    unsigned long gaps = 0;
+    long lastSequence = -1;
+
+    int c;
+    while ((c = fgetc(in)) != EOF)
+    {
+        TelemetryFrame frame;
+        if (!decoder.push((uint8_t)c, frame))
+            continue;
+
+        if (lastSequence >= 0 && frame.sequence != (uint16_t)(lastSequence + 1))
+            gaps++;
+        lastSequence = frame.sequence;
+
+        printf("%u,%lu,%u,%u,%u,%d,%d,%u,%u,%u,%u,%u,%u,%u\n",
+               frame.sequence, (unsigned long)frame.timestamp, frame.flags,
+               frame.rawX, frame.rawY, frame.x, frame.y,
+               frame.direction, frame.speedPercent, frame.speedPWM,
+               frame.loopLastUs, frame.loopMaxUs, frame.overruns, frame.dropped);
+    }
+
+    fprintf(stderr, "%lu frames, %lu rejected chunks, %lu sequence gaps\n", decoder.getFrames(),
+            decoder.getRejected(), gaps);
+    if (in != stdin)
+        fclose(in);
+    return 0;
+}